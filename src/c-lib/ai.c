@@ -26,11 +26,13 @@
 #include <string.h>
 
 #include "syntax/gs1syntaxdictionary.h"
+#include "syntax/gs1syntaxdictionary-utils.h"
 #include "gs1encoders.h"
 #include "enc-private.h"
 #include "debug.h"
 #include "ai.h"
 #include "dl.h"
+#include "syn.h"
 
 
 /*
@@ -83,19 +85,19 @@
  *  with the same two digits shall have the same AI length.
  *
  */
-static bool populateAIlengthByPrefix(gs1_encoder* const ctx) {
+bool gs1_populateAIlengthByPrefix(gs1_syntax_dictionary* const sd) {
 	const struct aiEntry *e;
 
-	memset(ctx->aiLengthByPrefix, 0, sizeof(ctx->aiLengthByPrefix));
+	memset(sd->aiLengthByPrefix, 0, sizeof(sd->aiLengthByPrefix));
 
-	for (e = ctx->aiTable; *e->ai; e++) {
+	for (e = sd->aiTable; *e->ai; e++) {
 		uint8_t prefix = (uint8_t)((e->ai[0] - '0') * 10 + (e->ai[1] - '0'));
 		uint8_t length = (uint8_t)strlen(e->ai);
-		if (ctx->aiLengthByPrefix[prefix] != 0 && ctx->aiLengthByPrefix[prefix] != length) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI table is broken: AIs beginning '%c%c' have different lengths", e->ai[0], e->ai[1]);
+		if (sd->aiLengthByPrefix[prefix] != 0 && sd->aiLengthByPrefix[prefix] != length) {
+			snprintf(sd->errMsg, sizeof(sd->errMsg), "AI table is broken: AIs beginning '%c%c' have different lengths", e->ai[0], e->ai[1]);
 			return false;
 		}
-		ctx->aiLengthByPrefix[prefix] = length;
+		sd->aiLengthByPrefix[prefix] = length;
 	}
 
 	return true;
@@ -103,35 +105,361 @@ static bool populateAIlengthByPrefix(gs1_encoder* const ctx) {
 
 static inline __ATTR_PURE uint8_t aiLengthByPrefix(const gs1_encoder* const ctx, const char *ai) {
 	assert(ai[0] >= '0' && ai[0] <= '9' && ai[1] >= '0' && ai[1] <= '9');
-	return ctx->aiLengthByPrefix[(ai[0] - '0') * 10 + (ai[1] - '0')];
+	return ctx->sd->aiLengthByPrefix[(ai[0] - '0') * 10 + (ai[1] - '0')];
 }
 
 
-void gs1_setAItable(gs1_encoder* const ctx, struct aiEntry *aiTable) {
+/*
+ *  Direct index from each AI to its position in the AI table.
+ *
+ *  The key is the AI right-padded with zeros to four digits, which is unique
+ *  since all AIs sharing a two-digit prefix have the same length. Slots hold
+ *  the table position plus one so that zero denotes an unallocated AI.
+ *
+ */
+static inline __ATTR_PURE size_t aiIndexKey(const char* const ai, const size_t ailen) {
+	size_t key = 0, i;
+	for (i = 0; i < MAX_AI_LEN; i++)
+		key = key * 10 + (i < ailen ? (size_t)(ai[i] - '0') : 0);
+	return key;
+}
+
+bool gs1_populateAIindex(gs1_syntax_dictionary* const sd) {
+
+	uint16_t *index;
+	size_t i;
+
+	assert(sd);
+	assert(!sd->aiIndex);
+
+#ifndef EXCLUDE_EMBEDDED_AI_TABLE
+	if (sd->aiTable == embedded_ai_table) {		// Generated alongside the table
+		sd->aiIndex = embedded_ai_index;
+		return true;
+	}
+#endif
+
+	if (sd->aiTableEntries >= UINT16_MAX) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "AI table is broken: too many entries to index");
+		return false;
+	}
+
+	index = calloc(AI_INDEX_SIZE, sizeof(uint16_t));
+	if (!index) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Failed to allocate the AI index");
+		return false;
+	}
+
+	for (i = 0; i < sd->aiTableEntries; i++) {
+		const char* const ai = sd->aiTable[i].ai;
+		const size_t key = aiIndexKey(ai, strlen(ai));
+		if (index[key] != 0) {
+			snprintf(sd->errMsg, sizeof(sd->errMsg), "AI table is broken: AI (%s) is defined more than once", ai);
+			free(index);
+			return false;
+		}
+		index[key] = (uint16_t)(i + 1);
+	}
+
+	sd->aiIndex = index;
+
+	return true;
+
+}
+
+void gs1_freeAIindex(gs1_syntax_dictionary* const sd) {
+
+	assert(sd);
+
+#ifndef EXCLUDE_EMBEDDED_AI_TABLE
+	if (sd->aiIndex != embedded_ai_index)
+#endif
+		free((uint16_t*)sd->aiIndex);
+
+	sd->aiIndex = NULL;
+
+}
+
+
+/*
+ *  Compile the "ex" or "req" attributes of an AI table entry into rules that
+ *  are appended to the rule pool.
+ *
+ *  Each comma-separated token becomes a rule matching the range of AI index
+ *  keys that begin with its leading digits, so that "310n" matches (3100)
+ *  through (3109) and "01" matches (01) alone.
+ *
+ */
+static const size_t aiKeySpan[MAX_AI_LEN + 1] = { 10000, 1000, 100, 10, 1 };
+
+static bool addAIrule(gs1_syntax_dictionary* const sd, size_t* const cap, const char* const token, const size_t len, const size_t textOff, const size_t textLen) {
+
+	struct aiRule *rule;
+	size_t digits = 0, key;
+
+	if (sd->numAIrules >= UINT16_MAX) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "AI table is broken: too many AI association rules");
+		return false;
+	}
+
+	if (sd->numAIrules == *cap) {
+		struct aiRule* const rules = realloc(sd->aiRules, (*cap + 256) * sizeof(struct aiRule));
+		if (!rules) {
+			snprintf(sd->errMsg, sizeof(sd->errMsg), "Failed to allocate the AI association rules");
+			return false;
+		}
+		sd->aiRules = rules;
+		*cap += 256;
+	}
+
+	while (digits < len && digits < MAX_AI_LEN && token[digits] >= '0' && token[digits] <= '9')
+		digits++;
+	key = aiIndexKey(token, digits);
+
+	rule = &sd->aiRules[sd->numAIrules++];
+	rule->lo = (uint16_t)key;
+	rule->hi = (uint16_t)(key + aiKeySpan[digits] - 1);
+	rule->selfLen = (uint8_t)(len < MAX_AI_LEN ? len : MAX_AI_LEN);
+	rule->end = 0;
+	rule->textOff = (uint8_t)(textOff < UINT8_MAX ? textOff : UINT8_MAX);
+	rule->textLen = (uint8_t)(textLen < MAX_AI_ATTR_LEN ? textLen : MAX_AI_ATTR_LEN);
+
+	return true;
+
+}
+
+static bool compileAIattr(gs1_syntax_dictionary* const sd, size_t* const cap, const char* const attrs, const char* const name, uint16_t* const start, uint16_t* const count) {
+
+	const size_t namelen = strlen(name);
+	const char *p = attrs;
+
+	*start = (uint16_t)sd->numAIrules;
+
+	while (*p) {
+
+		const size_t attrlen = strcspn(p, " ");
+
+		if (attrlen > namelen && strncmp(p, name, namelen) == 0) {
+
+			const char *v = p + namelen;
+			const size_t clause = sd->numAIrules;
+
+			// Alternative groups are separated by "," and group members by "+"
+			for (;;) {
+
+				const size_t group = sd->numAIrules;
+
+				for (;;) {
+					const size_t toklen = strcspn(v, "+, ");
+					if (toklen != 0 && !addAIrule(sd, cap, v, toklen, (size_t)(p - attrs) + namelen, attrlen - namelen))
+						return false;
+					v += toklen;
+					if (*v != '+')
+						break;
+					v++;
+				}
+
+				if (sd->numAIrules != group)
+					sd->aiRules[sd->numAIrules - 1].end |= AI_RULE_END_GROUP;
+
+				if (*v != ',')
+					break;
+				v++;
+
+			}
+
+			if (sd->numAIrules != clause)
+				sd->aiRules[sd->numAIrules - 1].end |= AI_RULE_END_CLAUSE;
+
+		}
+
+		p += attrlen;
+		p += strspn(p, " ");
+
+	}
+
+	*count = (uint16_t)(sd->numAIrules - *start);
+
+	return true;
+
+}
+
+bool gs1_compileAIrules(gs1_syntax_dictionary* const sd) {
+
+	size_t i, cap = 0;
+
+	assert(sd);
+	assert(!sd->aiRuleSets);
+
+	sd->aiRuleSets = calloc(sd->aiTableEntries + 1, sizeof(struct aiRuleSet));
+	if (!sd->aiRuleSets) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Failed to allocate the AI association rules");
+		return false;
+	}
+
+	for (i = 0; i < sd->aiTableEntries; i++) {
+		const char* const attrs = sd->aiTable[i].attrs ? sd->aiTable[i].attrs : "";
+		struct aiRuleSet* const rs = &sd->aiRuleSets[i];
+		if (!compileAIattr(sd, &cap, attrs, "ex=", &rs->ex, &rs->numEx) ||
+		    !compileAIattr(sd, &cap, attrs, "req=", &rs->req, &rs->numReq)) {
+			gs1_freeAIrules(sd);
+			return false;
+		}
+	}
+
+	return true;
+
+}
+
+void gs1_freeAIrules(gs1_syntax_dictionary* const sd) {
+
+	assert(sd);
+
+	free(sd->aiRuleSets);
+	sd->aiRuleSets = NULL;
+	free(sd->aiRules);
+	sd->aiRules = NULL;
+	sd->numAIrules = 0;
+
+}
+
+
+/*
+ *  Compile the components of an AI table entry into a validation program.
+ *
+ *  The character set check for CSET 82, CSET 39 and numeric components is
+ *  performed directly by the COMPONENT instruction, whereas CSET 64 requires
+ *  its linter to also validate the padding.
+ *
+ */
+#define AI_LINTER_FN(n) gs1_lintn_##n,
+static const gs1_lintn_t linterById[AI_NUM_LINTERS] = {
+	NULL,
+	AI_LINTERS(AI_LINTER_FN)
+};
+#undef AI_LINTER_FN
+
+static size_t compileAIprogram(const struct aiEntry* const entry, uint8_t* const prog) {
+
+	const struct aiComponent *part;
+	const gs1_lintn_t *l;
+	uint8_t *pc = prog, *comp;
+	uint8_t id;
+
+	for (part = entry->parts; part->cset; part++) {
+
+		comp = pc;
+		*pc++ = AI_OP_COMPONENT;
+		*pc++ = part->min;
+		*pc++ = part->max;
+		*pc++ = part->opt;
+		switch (part->cset) {
+			case cset_N: *pc++ = GS1_CSET_NUMERIC; break;
+			case cset_X: *pc++ = GS1_CSET_82; break;
+			case cset_Y: *pc++ = GS1_CSET_39; break;
+			default:     *pc++ = 0; break;
+		}
+		pc++;		// Skip length, filled in below
+
+		if (part->cset == cset_Z) {
+			*pc++ = AI_OP_LINT;
+			*pc++ = AI_LINTER_cset64;
+		}
+
+		for (l = part->linters; *l; l++) {
+			for (id = 1; id < AI_NUM_LINTERS && linterById[id] != *l; id++);
+			if (id == AI_NUM_LINTERS)
+				return 0;
+			*pc++ = AI_OP_LINT;
+			*pc++ = id;
+		}
+
+		comp[5] = (uint8_t)(pc - comp);
+
+	}
+
+	*pc++ = AI_OP_END;
+
+	assert(pc - prog <= AI_PROGRAM_MAX_LEN);
+
+	return (size_t)(pc - prog);
+
+}
+
+bool gs1_compileAIprograms(gs1_syntax_dictionary* const sd) {
+
+	size_t i, len, used = 0;
+	uint8_t *progs;
+
+	assert(sd);
+	assert(!sd->aiPrograms);
+
+	sd->aiProgramOff = malloc((sd->aiTableEntries + 1) * sizeof(uint32_t));
+	sd->aiPrograms = malloc(sd->aiTableEntries * AI_PROGRAM_MAX_LEN + 1);
+	if (!sd->aiProgramOff || !sd->aiPrograms) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Failed to allocate the AI validation programs");
+		goto fail;
+	}
+
+	for (i = 0; i < sd->aiTableEntries; i++) {
+		if ((len = compileAIprogram(&sd->aiTable[i], &sd->aiPrograms[used])) == 0) {
+			snprintf(sd->errMsg, sizeof(sd->errMsg), "AI table is broken: AI (%s) has an unknown linter", sd->aiTable[i].ai);
+			goto fail;
+		}
+		sd->aiProgramOff[i] = (uint32_t)used;
+		used += len;
+	}
+
+	if ((progs = realloc(sd->aiPrograms, used + 1)) != NULL)
+		sd->aiPrograms = progs;
+
+	return true;
+
+fail:
+
+	gs1_freeAIprograms(sd);
+	return false;
+
+}
+
+void gs1_freeAIprograms(gs1_syntax_dictionary* const sd) {
+
+	assert(sd);
+
+	free(sd->aiPrograms);
+	sd->aiPrograms = NULL;
+	free(sd->aiProgramOff);
+	sd->aiProgramOff = NULL;
+
+}
+
+
+/*
+ *  Populate a newly created Syntax Dictionary from the given AI table, taking
+ *  ownership of the table. A NULL table selects the embedded AI table.
+ *
+ */
+void gs1_setAItable(gs1_syntax_dictionary* const sd, struct aiEntry *aiTable) {
 
 	struct aiEntry *e;
 
+	assert(sd);
+	assert(!sd->aiTable);
+
 #ifndef EXCLUDE_EMBEDDED_AI_TABLE
 redo:
 #endif
 
-	/*
-	 *  Clear the current AI table
-	 *
-	 */
-	if (ctx->aiTable && ctx->aiTableIsDynamic)
-		free(ctx->aiTable);
-
 	/*
 	 *  Set the given AI table and populate the various additional
 	 *  structures with information extracted from the AI table.
 	 *
 	 */
-	ctx->aiTableIsDynamic = true;
+	sd->aiTableIsDynamic = true;
 	if (!aiTable) {
 #ifndef EXCLUDE_EMBEDDED_AI_TABLE
 		aiTable = embedded_ai_table;
-		ctx->aiTableIsDynamic = false;
+		sd->aiTableIsDynamic = false;
 #else
 		printf("*** Embedded AI table is not available.\n");
 		printf("***  Unable to continue. STOPPING.\n");
@@ -139,16 +467,25 @@ redo:
 #endif
 	}
 
-	ctx->aiTable = aiTable;
+	sd->aiTable = aiTable;
+
+	sd->aiTableEntries = 0;
+	for (e = sd->aiTable; *e->ai; e++)
+		sd->aiTableEntries++;
 
-	ctx->aiTableEntries = 0;
-	for (e = ctx->aiTable; *e->ai; e++)
-		ctx->aiTableEntries++;
+	if (!gs1_populateAIlengthByPrefix(sd))
+		goto fail;
+
+	if (!gs1_populateAIindex(sd))
+		goto fail;
 
-	if (!populateAIlengthByPrefix(ctx))
+	if (!gs1_compileAIrules(sd))
 		goto fail;
 
-	if (!gs1_populateDLkeyQualifiers(ctx))
+	if (!gs1_compileAIprograms(sd))
+		goto fail;
+
+	if (!gs1_populateDLkeyQualifiers(sd))
 		goto fail;
 
 	return;
@@ -156,11 +493,17 @@ redo:
 fail:
 
 	printf("*** Failed to process the AI table.\n");
-	printf("*** %s\n", ctx->errMsg);
+	printf("*** %s\n", sd->errMsg);
 
 #ifndef EXCLUDE_EMBEDDED_AI_TABLE
 	if (aiTable != embedded_ai_table) {
 		printf("*** Loading embedded AI table as a fallback!\n");
+		gs1_freeAIindex(sd);
+		gs1_freeAIrules(sd);
+		gs1_freeAIprograms(sd);
+		gs1_freeSyntaxDictionaryEntries(aiTable);
+		free(aiTable);
+		sd->aiTable = NULL;
 		aiTable = embedded_ai_table;
 		goto redo;
 	}
@@ -232,6 +575,30 @@ static const struct aiEntry unknownAI4fixed6 =
 	AI_ENTRY( "XXXX", NO_FNC1, XX_DATA_ATTR, X,6,6,MAN,_,_,_,   __, __, __, __, "", "UNKNOWN" );
 
 
+/*
+ * Position of the given AI within the AI table, or -1 if it is not present
+ *
+ */
+int gs1_aiTablePosition(const gs1_syntax_dictionary* const sd, const char* const ai, const size_t ailen) {
+
+	uint16_t pos;
+
+	assert(sd);
+	assert(sd->aiIndex);
+
+	if (ailen < MIN_AI_LEN || ailen > MAX_AI_LEN || !gs1_allDigits((const uint8_t *)ai, ailen))
+		return -1;
+
+	// AIs of a given length have distinct keys
+	pos = sd->aiIndex[aiIndexKey(ai, ailen)];
+	if (pos == 0 || strlen(sd->aiTable[pos - 1].ai) != ailen)
+		return -1;
+
+	return pos - 1;
+
+}
+
+
 /*
  * Lookup an AI table entry matching a given AI or matching prefix of given
  * data
@@ -243,9 +610,9 @@ static const struct aiEntry unknownAI4fixed6 =
 const struct aiEntry* gs1_lookupAIentry(const gs1_encoder* const ctx, const char *ai, size_t ailen) {
 
 	size_t aiLenByPrefix;
-	size_t s = 0, e = ctx->aiTableEntries;
+	uint16_t pos;
 
-	assert(ailen == 0 || ailen <= strlen(ai));
+	assert(ailen == 0 || memchr(ai, '\0', ailen) == NULL);	// May not be NUL-terminated
 
 	if (ailen != 0 && (ailen < MIN_AI_LEN || ailen > MAX_AI_LEN))	// Even for unknown AIs
 		return NULL;
@@ -255,46 +622,33 @@ const struct aiEntry* gs1_lookupAIentry(const gs1_encoder* const ctx, const char
 		return NULL;
 
 	/*
-	 * Binary search through the AI table to find an entry that matches a
-	 * prefix, optionally ensuring that the AI also has a specified length
+	 * The prefix determines the length of any AI that is allocated within
+	 * it, which in turn determines which digits key the direct index.
+	 *
+	 * A given length that differs from that of the prefix either
+	 * truncates or extends a known AI, neither of which is vivified.
 	 *
 	 */
-	while (s < e) {
-		const size_t m = s + (e - s) / 2;
-		const struct aiEntry* const entry = &ctx->aiTable[m];
-		const size_t entrylen = strlen(entry->ai);
-		const int cmp = strncmp(entry->ai, ai, entrylen);
-		if (cmp == 0) {
-			if (ailen != 0 && entrylen != ailen)
-				return NULL;	// Prefix match, but incorrect length
-			return entry;		// Found
-		}
-		if (ailen != 0 && strncmp(ai, entry->ai, ailen) == 0)
-			return NULL;	// Don't vivify an AI that is a prefix of a known AI
-		if (cmp < 0)
-			s = m + 1;
-		else
-			e = m;
-	}
+	aiLenByPrefix = aiLengthByPrefix(ctx, ai);
+	if (ailen != 0 && aiLenByPrefix != 0 && aiLenByPrefix != ailen)
+		return NULL;
+
+	// Don't lookup or vivify a non-digit AI
+	if (aiLenByPrefix != 0 && !gs1_allDigits((uint8_t *)ai, aiLenByPrefix))
+		return NULL;
+
+	if (aiLenByPrefix != 0 && (pos = ctx->sd->aiIndex[aiIndexKey(ai, aiLenByPrefix)]) != 0)
+		return &ctx->sd->aiTable[pos - 1];
 
 	if (!ctx->permitUnknownAIs)
 		return NULL;
 
 	/*
 	 * If permitUnknownAIs is enabled then we vivify the AI by returning a
-	 * pseudo "unknownAI" entry, but only if the length matches that
-	 * indicated by the prefix where such a length is defined.
-	 *
-	 * Otherwise we return NULL ("not found") to indicate an error.
+	 * pseudo "unknownAI" entry, having already ensured that the length
+	 * matches that indicated by the prefix where such a length is defined.
 	 *
 	 */
-	aiLenByPrefix = aiLengthByPrefix(ctx, ai);
-	if (ailen != 0 && aiLenByPrefix != 0 && aiLenByPrefix != ailen)
-		return NULL;
-
-	// Don't vivify a non-digit AI
-	if (aiLenByPrefix != 0 && !gs1_allDigits((uint8_t *)ai, aiLenByPrefix))
-		return NULL;
 
 	// Return unknownAI indicator for corresponding AI length
 	if (aiLenByPrefix == 2) {
@@ -320,89 +674,218 @@ const struct aiEntry* gs1_lookupAIentry(const gs1_encoder* const ctx, const char
 
 
 /*
- *  Validate string between start and end pointers according to rules for an AI
+ *  Run a linter identified by its aiLinterId, calling it directly.
  *
  */
-static size_t validate_ai_val(gs1_encoder* const ctx, const char* const ai, const struct aiEntry* const entry, const char* const start, const char* const end) {
+static inline gs1_lint_err_t runLinter(const uint8_t id, const char* const data, const size_t len, size_t* const errpos, size_t* const errlen) {
 
-	const struct aiComponent *part;
+#define AI_LINTER_CALL(n) case AI_LINTER_##n: return gs1_lintn_##n(data, len, errpos, errlen);
+	switch (id) {
+		AI_LINTERS(AI_LINTER_CALL)
+		default: break;
+	}
+#undef AI_LINTER_CALL
+
+	assert(false);
+	return GS1_LINTER_OK;
+
+}
+
+
+/*
+ *  The validation program for an AI table entry, which for the pseudo entries
+ *  of vivified AIs is compiled on demand.
+ *
+ */
+static const uint8_t* aiProgram(const gs1_encoder* const ctx, const struct aiEntry* const entry, uint8_t* const scratch) {
+
+	const gs1_syntax_dictionary* const sd = ctx->sd;
+	const uintptr_t e = (uintptr_t)entry, t = (uintptr_t)sd->aiTable;
+
+	if (sd->aiPrograms && e >= t && e < (uintptr_t)(sd->aiTable + sd->aiTableEntries))
+		return &sd->aiPrograms[sd->aiProgramOff[(e - t) / sizeof(struct aiEntry)]];
+
+	if (compileAIprogram(entry, scratch) == 0)
+		return NULL;
+
+	return scratch;
+
+}
+
+
+/*
+ *  Record the AI whose value is at fault, and optionally the offending data
+ *  within that value, so that the batch functions can locate the error
+ *  within the caller's message.
+ *
+ */
+static inline void setErrAI(gs1_encoder* const ctx, const char* const ai, const size_t ailen, const char* const pos) {
+	ctx->errAI = ai;
+	ctx->errAIlen = ailen;
+	ctx->errPos = pos;
+}
+
+
+/*
+ *  Report a component that fails validation, returning 0 as the amount of
+ *  data consumed.
+ *
+ */
+static size_t aiValLengthFail(gs1_encoder* const ctx, const char* const ai, const struct aiEntry* const entry) {
+	gs1_setErrForAI(ctx, gs1_encoder_eAI_INCORRECT_LENGTH, ai, strlen(entry->ai));
+	setErrAI(ctx, ai, strlen(entry->ai), NULL);
+	return 0;
+}
+
+static size_t aiValLintFail(gs1_encoder* const ctx, const char* const ai, const struct aiEntry* const entry, const char* const start, const char* const p, const size_t complen, const gs1_lint_err_t err, const size_t errpos, const size_t errlen) {
+	const size_t vallen = (size_t)(p-start) + complen;
+	STATS_LINT_FAILURE(ctx, err);
+	gs1_setErrForAI(ctx, gs1_encoder_eAI_LINT_FAILURE, ai, strlen(entry->ai));
+	ctx->linterErr = err;
+	setErrAI(ctx, ai, strlen(entry->ai), p + errpos);
+	// Keep the value up to the end of the component for the markup
+	assert(vallen < sizeof(ctx->err.arg[1]));
+	gs1_setErrArg(ctx, 1, start, vallen);
+	ctx->err.offset = (size_t)(p-start) + errpos;
+	ctx->err.length = errlen;
+	return 0;
+}
+
+
+/*
+ *  Specialised validation functions for the AIs of the embedded AI table, as
+ *  generated by build-embedded-ai-validators.pl
+ *
+ */
+#if !defined(EXCLUDE_EMBEDDED_AI_TABLE) && (defined(GENERATED_AI_VALIDATORS) || defined(UNIT_TESTS))
+#include "aivalidators.inc"
+#endif
+
+
+/*
+ *  Validate the components of an AI by running its validation program.
+ *
+ */
+static size_t validate_ai_val_interpreted(gs1_encoder* const ctx, const char* const ai, const struct aiEntry* const entry, const char* const start, const char* const end) {
+
+	uint8_t scratch[AI_PROGRAM_MAX_LEN];
+	const uint8_t *pc;
 	const char *p = start, *r = end;
+	size_t complen = 0;
+	gs1_lint_err_t err;
+	size_t errpos, errlen;
 
-	assert(ctx);
-	assert(entry);
-	assert(start);
-	assert(end);
-	assert(end >= start);
+	pc = aiProgram(ctx, entry, scratch);
+	assert(pc);
 
-	DEBUG_PRINT("  Considering AI (%.*s): %.*s\n", (int)strlen(entry->ai), ai, (int)(r-p), start);
+	for (;;) {
 
-	if (p == r) {
-		snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) data is empty", (int)strlen(entry->ai), ai);
-		return 0;
-	}
+		switch (*pc) {
 
-	for (part = entry->parts; part->cset; part++) {
+		case AI_OP_COMPONENT:
 
-		char compval[MAX_AI_VALUE_LEN+1];
-		gs1_linter_t linter;
-		const gs1_linter_t *l;
+			p += complen;	// Past the previous component
 
-		size_t complen = (size_t)(r-p);	// Until given FNC1 or end...
-		if (part->max < r-p)
-			complen = part->max;	// ... reduced to max length of component
-		strncpy(compval, p, complen);
-		compval[complen] = '\0';
+			complen = (size_t)(r-p);	// Until given FNC1 or end...
+			if (pc[2] < r-p)
+				complen = pc[2];	// ... reduced to max length of component
 
-		DEBUG_PRINT("    Validating component: %s\n", compval);
+			DEBUG_PRINT("    Validating component: %.*s\n", (int)complen, p);
 
-		if (part->opt == OPT && complen == 0)	// Nothing to be done for an empty optional component
-			continue;
+			if (pc[3] && complen == 0) {	// Nothing to be done for an empty optional component
+				pc += pc[5];
+				break;
+			}
 
-		if (complen < part->min) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) data has incorrect length", (int)strlen(entry->ai), ai);
-			return 0;
-		}
+			if (complen < pc[1])
+				return aiValLengthFail(ctx, ai, entry);
+
+			/*
+			 *  The character set check is fused with the length
+			 *  check, in place of running the cset linter
+			 *
+			 */
+			STATS_CSET_CHECK(ctx, pc[4]);
+			if (pc[4] && (errpos = gs1_cset_span(p, complen, pc[4])) != complen) {
+				switch (pc[4]) {
+					case GS1_CSET_NUMERIC: err = GS1_LINTER_NON_DIGIT_CHARACTER; break;
+					case GS1_CSET_39: err = GS1_LINTER_INVALID_CSET39_CHARACTER; break;
+					default: err = GS1_LINTER_INVALID_CSET82_CHARACTER; break;
+				}
+				aiValLintFail(ctx, ai, entry, start, p, complen, err, errpos, 1);
+				if (!gs1_collectErr(ctx))
+					return 0;
+				// The linters of the component need not see bad characters
+				for (pc += 6; *pc == AI_OP_LINT; pc += 2);
+				break;
+			}
 
-		/*
-		 *  Run the cset linter followed by each additional linter for
-		 *  the component
-		 *
-		 */
-		switch (part->cset) {
-			case cset_N: linter = gs1_lint_csetnumeric; break;
-			case cset_X: linter = gs1_lint_cset82; break;
-			case cset_Y: linter = gs1_lint_cset39; break;
-			case cset_Z: linter = gs1_lint_cset64; break;
-			default: linter = NULL; break;
-		}
-		assert(linter);
-		l = &linter;
-		do {
-
-			gs1_lint_err_t err;
-			size_t errpos, errlen;
-
-			err = (*l)(compval, &errpos, &errlen);
-			if (err) {
-				snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s): %s", (int)strlen(entry->ai), ai, gs1_lint_err_str[err]);
-				ctx->linterErr = err;
-				errpos += (size_t)(p-start);
-				snprintf(ctx->linterErrMarkup, sizeof(ctx->linterErrMarkup), "(%.*s)%.*s|%.*s|%.*s",
-					(int)strlen(entry->ai), ai,
-					(int)errpos, start,
-					(int)errlen, start + errpos,
-					(int)(strlen(compval) - errpos - errlen), start + errpos + errlen);
-				return 0;
+			pc += 6;
+			break;
+
+		case AI_OP_LINT:
+
+			STATS_LINTER_CALL(ctx, pc[1]);
+			if ((err = runLinter(pc[1], p, complen, &errpos, &errlen)) != GS1_LINTER_OK) {
+				aiValLintFail(ctx, ai, entry, start, p, complen, err, errpos, errlen);
+				if (!gs1_collectErr(ctx))
+					return 0;
 			}
-			l = (l == &linter) ? &(part->linters[0]) : l+1;
 
-		} while (*l);
+			pc += 2;
+			break;
+
+		default:
+
+			assert(*pc == AI_OP_END);
+			p += complen;
+			return (size_t)(p-start);	// Amount of data that validation consumed
+
+		}
+
+	}
+
+}
+
+
+/*
+ *  Validate string between start and end pointers according to rules for an AI
+ *
+ */
+static size_t validate_ai_val(gs1_encoder* const ctx, const char* const ai, const struct aiEntry* const entry, const char* const start, const char* const end) {
+
+	size_t consumed;
+
+	assert(ctx);
+	assert(entry);
+	assert(start);
+	assert(end);
+	assert(end >= start);
 
-		p += complen;
+	DEBUG_PRINT("  Considering AI (%.*s): %.*s\n", (int)strlen(entry->ai), ai, (int)(end-start), start);
 
+	if (start == end) {
+		gs1_setErrForAI(ctx, gs1_encoder_eAI_VALUE_EMPTY, ai, strlen(entry->ai));
+		setErrAI(ctx, ai, strlen(entry->ai), NULL);
+		return 0;
 	}
 
-	return (size_t)(p-start);	// Amount of data that validation consumed
+	/*
+	 *  The generated validators stop at the first error, so are not used
+	 *  when collecting errors, and they do not maintain the linter
+	 *  statistics
+	 *
+	 */
+#if defined(GENERATED_AI_VALIDATORS) && !defined(EXCLUDE_EMBEDDED_AI_TABLE) && !defined(PERF_STATS)
+	if (!ctx->sd->aiTableIsDynamic && !ctx->collectErrs && validate_ai_val_generated(ctx, ai, entry, start, end, &consumed))
+		return consumed;
+#endif
+
+	STATS_ENTER(ctx, gs1_encoder_pLINT, ai, strlen(entry->ai));
+	consumed = validate_ai_val_interpreted(ctx, ai, entry, start, end);
+	STATS_LEAVE(ctx);
+
+	return consumed;
 
 }
 
@@ -438,18 +921,21 @@ bool gs1_aiValLengthContentCheck(gs1_encoder* const ctx, const char* const ai, c
 	assert(aiVal);
 
 	if (vallen < aiEntryMinLength(entry)) {
-		snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) value is too short", (int)strlen(entry->ai), ai);
+		gs1_setErrForAI(ctx, gs1_encoder_eAI_VALUE_TOO_SHORT, ai, strlen(entry->ai));
+		setErrAI(ctx, ai, strlen(entry->ai), NULL);
 		return false;
 	}
 
 	if (vallen > aiEntryMaxLength(entry)) {
-		snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) value is too long", (int)strlen(entry->ai), ai);
+		gs1_setErrForAI(ctx, gs1_encoder_eAI_VALUE_TOO_LONG, ai, strlen(entry->ai));
+		setErrAI(ctx, ai, strlen(entry->ai), NULL);
 		return false;
 	}
 
 	// Also forbid data "^" characters at this stage so we don't conflate with FNC1
 	if (memchr(aiVal, '^', vallen) != NULL) {
-		snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) contains illegal ^ character", (int)strlen(entry->ai), ai);
+		gs1_setErrForAI(ctx, gs1_encoder_eAI_VALUE_ILLEGAL_CARET, ai, strlen(entry->ai));
+		setErrAI(ctx, ai, strlen(entry->ai), NULL);
 		return false;
 	}
 
@@ -461,54 +947,57 @@ bool gs1_aiValLengthContentCheck(gs1_encoder* const ctx, const char* const ai, c
 /*
  * Convert bracketed AI syntax data to regular AI data string with ^ = FNC1
  *
+ * The input is delimited by its length, need not be NUL-terminated and is
+ * never written to.
+ *
  */
-bool gs1_parseAIdata(gs1_encoder* const ctx, const char* const aiData, char* const dataStr) {
+bool gs1_parseAIdataN(gs1_encoder* const ctx, const char* const aiData, const size_t len, char* const dataStr) {
 
 	const char *p = aiData;
+	const char* const end = aiData + len;
 	bool fnc1req = true;
+	struct gs1_writer out;
 
 	assert(ctx);
-	assert(aiData);
+	assert(aiData || len == 0);
 
-	*dataStr = '\0';
-	*ctx->errMsg = '\0';
-	ctx->linterErr = GS1_LINTER_OK;
-	*ctx->linterErrMarkup = '\0';
+	gs1_writerInit(&out, dataStr, MAX_DATA);
+	gs1_clearErr(ctx);
 
-	DEBUG_PRINT("\nParsing AI data: %s\n", p);
+	DEBUG_PRINT("\nParsing AI data: %.*s\n", (int)len, p);
 
-	while (*p) {
+	while (p < end) {
 
 		const struct aiEntry *entry;
 		const char *outai, *outval, *r, *ai;
 		size_t ailen;
 
 		if (*p++ != '(') goto fail; 			// Expect start of AI
-		if (!(r = strchr(p, ')'))) goto fail;		// Find end of A
+		if (!(r = memchr(p, ')', (size_t)(end - p)))) goto fail;	// Find end of AI
 		ailen = (size_t)(r-p);
 		entry = gs1_lookupAIentry(ctx, p, ailen);
 		if (entry == NULL) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Unrecognised AI: %.*s", (int)ailen, p);
+			gs1_setErrForAI(ctx, gs1_encoder_eAI_UNRECOGNISED, p, ailen);
 			goto fail;
 		}
 		ai = p;
 
 		if (fnc1req)
 			writeDataStr("^");			// Write FNC1, if required
-		outai = dataStr + strlen(dataStr);		// Record the current start of the output AI
+		outai = out.cur;				// Record the current start of the output AI
 		nwriteDataStr(p, ailen);			// Write AI
 		fnc1req = entry->fnc1;				// Record whether FNC1 required before next AI
 
-		if (!*++r) goto fail;				// Advance to start of AI value and fail if at end
+		if (++r == end) goto fail;			// Advance to start of AI value and fail if at end
 
-		outval = dataStr + strlen(dataStr);		// Record the current start of the output value
+		outval = out.cur;				// Record the current start of the output value
 
 again:
 
-		if ((p = strchr(r, '(')) == NULL)
-			p = r + strlen(r);			// Move the pointer to the end if no more AIs
+		if ((p = memchr(r, '(', (size_t)(end - r))) == NULL)
+			p = end;				// Move the pointer to the end if no more AIs
 
-		if (*p != '\0' && *(p-1) == '\\') {		// This bracket is an escaped data character
+		if (p != end && *(p-1) == '\\') {		// This bracket is an escaped data character
 			nwriteDataStr(r, (size_t)(p-r-1));	// Write up to the escape character
 			writeDataStr("(");			// Write the data bracket
 			r = p+1;				// And keep going
@@ -519,12 +1008,12 @@ again:
 
 		// Perform certain checks at parse time, before processing the
 		// components with the linters
-		if (!gs1_aiValLengthContentCheck(ctx, ai, entry, outval, strlen(outval)))
+		if (!gs1_aiValLengthContentCheck(ctx, ai, entry, outval, (size_t)(out.cur - outval)))
 			goto fail;
 
 		// Update the AI data
 		if (ctx->numAIs >= MAX_AIS) {
-			strcpy(ctx->errMsg, "Too many AIs");
+			gs1_setErr(ctx, gs1_encoder_eTOO_MANY_AIS);
 			goto fail;
 		}
 
@@ -547,10 +1036,10 @@ again:
 
 fail:
 
-	if (*ctx->errMsg == '\0')
-		strcpy(ctx->errMsg, "Failed to parse AI data");
+	if (ctx->err.code == gs1_encoder_eNO_ERROR)
+		gs1_setErr(ctx, gs1_encoder_eAI_PARSE_FAILED);
 
-	DEBUG_PRINT("Parsing AI data failed: %s\n", ctx->errMsg);
+	DEBUG_PRINT("Parsing AI data failed: %s\n", gs1_encoder_getErrMsg(ctx));
 
 	*dataStr = '\0';
 	return false;
@@ -558,40 +1047,52 @@ fail:
 }
 
 
+bool gs1_parseAIdata(gs1_encoder* const ctx, const char* const aiData, char* const dataStr) {
+	assert(aiData);
+	return gs1_parseAIdataN(ctx, aiData, strlen(aiData), dataStr);
+}
+
+
+static inline __ATTR_CONST bool isFNC1(const char c, const bool gsIsFNC1) {
+	return c == '^' || (gsIsFNC1 && c == '\x1D');
+}
+
+
 /*
- *  Validate regular AI data ("^...") and optionally extract AIs
+ *  Validate regular AI data ("^...") between start and end and optionally
+ *  extract AIs, which then refer to the given data. When gsIsFNC1 is set then
+ *  ASCII GS is accepted as FNC1, as found in scan data.
  *
  */
-bool gs1_processAIdata(gs1_encoder* const ctx, const char* const dataStr, const bool extractAIs) {
-
-	const char *p;
+static bool processAIdata(gs1_encoder* const ctx, const char* const start, const char* const end, const bool extractAIs, const bool gsIsFNC1) {
 
-	assert(ctx);
-	assert(dataStr);
+	const char *p = start;
 
-	*ctx->errMsg = '\0';
-	ctx->linterErr = GS1_LINTER_OK;
-	*ctx->linterErrMarkup = '\0';
-
-	p = dataStr;
+	gs1_clearErr(ctx);
 
 	// Ensure FNC1 in first
-	if (!*p || *p++ != '^') {
-		strcpy(ctx->errMsg, "Missing FNC1 in first position");
+	if (p == end || !isFNC1(*p++, gsIsFNC1)) {
+		gs1_setErr(ctx, gs1_encoder_eMISSING_FNC1_IN_FIRST);
 		return false;
 	}
 
 	// Must have some AI data
-	if (!*p) {
-		strcpy(ctx->errMsg, "The AI data is empty");
+	if (p == end) {
+		gs1_setErr(ctx, gs1_encoder_eAI_DATA_EMPTY);
 		return false;
 	}
 
-	while (*p) {
+	while (p < end) {
 
+		char aibuf[MAX_AI_LEN+1];
 		const char *r, *ai;
 		const struct aiEntry *entry;
-		size_t vallen;
+		size_t vallen, n;
+
+		// The AI lookup examines a NUL-terminated prefix of the remaining data
+		n = (size_t)(end - p) < MAX_AI_LEN ? (size_t)(end - p) : MAX_AI_LEN;
+		memcpy(aibuf, p, n);
+		aibuf[n] = '\0';
 
 		/* Find AI that matches a prefix of our data
 		 *
@@ -601,9 +1102,11 @@ bool gs1_processAIdata(gs1_encoder* const ctx, const char* const dataStr, const
 		 * priori the AI's length.
 		 *
 		 */
-		if ((entry = gs1_lookupAIentry(ctx, p, 0)) == NULL ||
+		if ((entry = gs1_lookupAIentry(ctx, aibuf, 0)) == NULL ||
 		    (extractAIs && entry == &unknownAI)) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "No known AI is a prefix of: %.4s...", p);
+			gs1_setErr(ctx, gs1_encoder_eAI_NO_KNOWN_PREFIX);
+			gs1_setErrArg(ctx, 0, p, n);
+			ctx->err.aiIndex = ctx->numAIs;
 			return false;
 		}
 
@@ -611,9 +1114,9 @@ bool gs1_processAIdata(gs1_encoder* const ctx, const char* const dataStr, const
 		ai = p;
 		p += strlen(entry->ai);
 
-		// r points to the next FNC1 or end of string...
-		if ((r = strchr(p, '^')) == NULL)
-			r = p + strlen(p);
+		// r points to the next FNC1 or end of data...
+		for (r = p; r < end && !isFNC1(*r, gsIsFNC1); r++)
+			;
 
 		// Validate and return how much was consumed
 		if ((vallen = validate_ai_val(ctx, ai, entry, p, r)) == 0)
@@ -622,7 +1125,7 @@ bool gs1_processAIdata(gs1_encoder* const ctx, const char* const dataStr, const
 		// Add to the aiData
 		if (extractAIs) {
 			if (ctx->numAIs >= MAX_AIS) {
-				strcpy(ctx->errMsg, "Too many AIs");
+				gs1_setErr(ctx, gs1_encoder_eTOO_MANY_AIS);
 				return false;
 			}
 			ctx->aiData[ctx->numAIs++] = (struct aiValue) {
@@ -638,13 +1141,15 @@ bool gs1_processAIdata(gs1_encoder* const ctx, const char* const dataStr, const
 
 		// After AIs requiring FNC1, we expect to find an FNC1 or be at the end
 		p += vallen;
-		if (entry->fnc1 && *p != '^' && *p != '\0') {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) data is too long", (int)strlen(entry->ai), ai);
+		if (entry->fnc1 && p != end && !isFNC1(*p, gsIsFNC1)) {
+			gs1_setErrForAI(ctx, gs1_encoder_eAI_DATA_TOO_LONG, ai, strlen(entry->ai));
+			setErrAI(ctx, ai, strlen(entry->ai), p);
+			ctx->err.offset = (size_t)(p - ai) - strlen(entry->ai);
 			return false;
 		}
 
 		// Skip FNC1, even at end of fixed-length AIs
-		if (*p == '^')
+		if (p != end && isFNC1(*p, gsIsFNC1))
 			p++;
 
 	}
@@ -654,42 +1159,129 @@ bool gs1_processAIdata(gs1_encoder* const ctx, const char* const dataStr, const
 }
 
 
+bool gs1_processAIdata(gs1_encoder* const ctx, const char* const dataStr, const bool extractAIs) {
+	assert(ctx);
+	assert(dataStr);
+	return processAIdata(ctx, dataStr, dataStr + strlen(dataStr), extractAIs, false);
+}
+
+
 /*
- *  Search the AIs for any match with the given AI pattern, optionally
- *  returning the matched AI.
+ *  As gs1_processAIdata() for length-delimited data that need not be
+ *  NUL-terminated, optionally accepting ASCII GS as well as "^" for FNC1.
  *
- *  Ignore AI can be set to the current AI to avoid matching triggering on
- *  itself when matching by a self-referencing pattern.
+ */
+bool gs1_processAIdataN(gs1_encoder* const ctx, const char* const data, const size_t len, const bool extractAIs, const bool gsIsFNC1) {
+	assert(ctx);
+	assert(data || len == 0);
+	return processAIdata(ctx, data, data + len, extractAIs, gsIsFNC1);
+}
+
+
+/*
+ *  Record the index key of each extracted AI in a bitmap, along with the
+ *  position of its first instance, so that the association checks are bit
+ *  operations rather than walks over the AIs.
  *
- *  Note: Given the typically small number of AIs and template matching
- *  requirement, there is little to be gained by maintaining a more advanced
- *  data structure versus the current approach of simply walking the AIs.
+ */
+static void markPresentAIs(gs1_encoder* const ctx) {
+
+	int i;
+
+	assert(ctx);
+	assert(ctx->numAIs <= MAX_AIS);
+
+	memset(ctx->aiPresent, 0, sizeof(ctx->aiPresent));
+
+	for (i = 0; i < ctx->numAIs; i++) {
+
+		const struct aiValue* const ai = &ctx->aiData[i];
+		size_t key;
+
+		if (ai->kind != aiValue_aival)
+			continue;
+
+		key = aiIndexKey(ai->ai, ai->ailen);
+		if (ctx->aiPresent[key / 64] & (UINT64_C(1) << (key % 64)))
+			continue;
+
+		ctx->aiPresent[key / 64] |= UINT64_C(1) << (key % 64);
+		ctx->aiFirstInstance[key] = (uint8_t)i;
+
+	}
+
+}
+
+static inline __ATTR_PURE bool anyAIpresent(const gs1_encoder* const ctx, const size_t lo, const size_t hi) {
+
+	size_t w = lo / 64;
+	uint64_t mask = ~UINT64_C(0) << (lo % 64);
+
+	for (; w < hi / 64; w++) {
+		if (ctx->aiPresent[w] & mask)
+			return true;
+		mask = ~UINT64_C(0);
+	}
+
+	mask &= ~UINT64_C(0) >> (63 - hi % 64);
+
+	return (ctx->aiPresent[w] & mask) != 0;
+
+}
+
+/*
+ *  Determine whether any AI matched by the rule is present, other than an AI
+ *  sharing the rule's leading digits with the subject AI. This avoids a
+ *  self-referencing pattern such as "310n" for (3101) triggering on itself.
  *
  */
-static bool aiExists(const gs1_encoder* const ctx, const char* const ai, const char* const ignoreAI, struct aiValue const **matchedAI) {
+static inline __ATTR_PURE bool rulePresent(const gs1_encoder* const ctx, const struct aiRule* const rule, const size_t selfKey) {
+
+	const size_t span = aiKeySpan[rule->selfLen];
+	const size_t slo = selfKey - selfKey % span;
+	const size_t shi = slo + span - 1;
+
+	if (shi < rule->lo || slo > rule->hi)
+		return anyAIpresent(ctx, rule->lo, rule->hi);
+
+	return (rule->lo < slo && anyAIpresent(ctx, rule->lo, slo - 1)) ||
+	       (rule->hi > shi && anyAIpresent(ctx, shi + 1, rule->hi));
 
+}
+
+// Locate the first AI matching a rule, for reporting
+static const struct aiValue* ruleMatch(const gs1_encoder* const ctx, const struct aiRule* const rule, const size_t selfKey) {
+
+	const size_t span = aiKeySpan[rule->selfLen];
 	int i;
-	const size_t prefixlen = strspn(ai, "0123456789");
 
 	for (i = 0; i < ctx->numAIs; i++) {
 
-		const struct aiValue* const ai2 = &ctx->aiData[i];
+		const struct aiValue* const ai = &ctx->aiData[i];
+		size_t key;
 
-		if (ai2->kind != aiValue_aival ||
-		    strncmp(ai2->ai, ai, prefixlen) != 0 ||
-		    (ignoreAI && strncmp(ai2->ai, ignoreAI, strlen(ai)) == 0)
-		   )
+		if (ai->kind != aiValue_aival)
 			continue;
 
-		if (matchedAI)
-			*matchedAI = ai2;
-		return true;
+		key = aiIndexKey(ai->ai, ai->ailen);
+		if (key >= rule->lo && key <= rule->hi && key / span != selfKey / span)
+			return ai;
 
 	}
 
-	if (matchedAI)
-		*matchedAI = NULL;
-	return false;
+	return NULL;
+
+}
+
+// Rules for AI table entries; NULL for vivified unknown AIs
+static inline __ATTR_PURE const struct aiRuleSet* ruleSetFor(const gs1_encoder* const ctx, const struct aiValue* const ai, const size_t key) {
+
+	const uint16_t pos = ctx->sd->aiIndex[key];
+
+	if (pos == 0 || &ctx->sd->aiTable[pos - 1] != ai->aiEntry)
+		return NULL;
+
+	return &ctx->sd->aiRuleSets[pos - 1];
 
 }
 
@@ -709,38 +1301,35 @@ static bool validateAImutex(gs1_encoder* const ctx) {
 	for (i = 0; i < ctx->numAIs; i++) {
 
 		const struct aiValue* const ai = &ctx->aiData[i];
-		char attrs[MAX_AI_ATTR_LEN + 1] = { 0 };
-		const char *token;
-		char *saveptr = NULL;
+		const struct aiRuleSet *rs;
+		size_t key;
+		uint16_t r;
 
 		if (ai->kind != aiValue_aival)
 			continue;
 
 		assert(ai->aiEntry);
 
-		*attrs = '\0';
-		strncat(attrs, ai->aiEntry->attrs, MAX_AI_ATTR_LEN);
+		key = aiIndexKey(ai->ai, ai->ailen);
+		if ((rs = ruleSetFor(ctx, ai, key)) == NULL)
+			continue;
 
-		for (token = strtok_r(attrs, " ", &saveptr); token; token = strtok_r(NULL, " ", &saveptr)) {
+		for (r = rs->ex; r < rs->ex + rs->numEx; r++) {
 
-			char *saveptr2 = NULL;
+			const struct aiRule* const rule = &ctx->sd->aiRules[r];
+			const struct aiValue *matchedAI;
 
-			if (strncmp(token, "ex=", 3) != 0)
+			if (!rulePresent(ctx, rule, key))
 				continue;
 
-			for (token = strtok_r((char*)(token+3), ",", &saveptr2); token; token = strtok_r(NULL, ",", &saveptr2)) {
-
-				const struct aiValue *matchedAI;
+			matchedAI = ruleMatch(ctx, rule, key);
+			assert(matchedAI);
 
-				if (!aiExists(ctx, token, ai->ai, &matchedAI))
-					continue;
-
-				snprintf(ctx->errMsg, sizeof(ctx->errMsg), "It is invalid to pair AI (%.*s) with AI (%.*s)",
-					 ai->ailen, ai->ai, matchedAI->ailen, matchedAI->ai);
+			gs1_setErrForAI(ctx, gs1_encoder_eAI_INVALID_PAIRING, ai->ai, ai->ailen);
+			gs1_setErrArg(ctx, 1, matchedAI->ai, matchedAI->ailen);
+			if (!gs1_collectErr(ctx))
 				return false;
 
-			}
-
 		}
 
 	}
@@ -765,47 +1354,45 @@ static bool validateAIrequisites(gs1_encoder* const ctx) {
 	for (i = 0; i < ctx->numAIs; i++) {
 
 		const struct aiValue* const ai = &ctx->aiData[i];
-		char attrs[MAX_AI_ATTR_LEN + 1] = { 0 };
-		const char *token;
-		char *saveptr = NULL;
+		const struct aiRuleSet *rs;
+		const struct aiRule *rule, *end;
+		size_t key;
 
 		if (ai->kind != aiValue_aival)
 			continue;
 
 		assert(ai->aiEntry);
 
-		*attrs = '\0';
-		strncat(attrs, ai->aiEntry->attrs, MAX_AI_ATTR_LEN);
-
-		for (token = strtok_r(attrs, " ", &saveptr); token; token = strtok_r(NULL, " ", &saveptr)) {
-
-			bool satisfied = true;
-			char *saveptr2 = NULL;
-			char reqErr[MAX_AI_ATTR_LEN - 4 + 1] = { 0 };
-
-			if (strncmp(token, "req=", 4) != 0)
-				continue;
-
-			strncat(reqErr, token+4, MAX_AI_ATTR_LEN - 4);
+		key = aiIndexKey(ai->ai, ai->ailen);
+		if ((rs = ruleSetFor(ctx, ai, key)) == NULL)
+			continue;
 
-			for (token = strtok_r((char*)(token+4), ",", &saveptr2); token; token = strtok_r(NULL, ",", &saveptr2)) {
+		rule = &ctx->sd->aiRules[rs->req];
+		end = rule + rs->numReq;
 
-				char *saveptr3 = NULL;
-				satisfied = true;
+		while (rule < end) {
 
-				// All members of a group (e.g. "01+21") must be present
-				for (token = strtok_r((char*)token, "+", &saveptr3); token; token = strtok_r(NULL, ",", &saveptr3))
-					if (!aiExists(ctx, token, ai->ai, NULL))
-						satisfied = false;
+			const struct aiRule* const clause = rule;
+			bool satisfied = false;		// Any wholly satisfied group is sufficient for req
+			bool group = true;		// All members of a group (e.g. "01+21") must be present
 
-				if (satisfied)		// Any wholly satisfied group is sufficient for req
+			for (;; rule++) {
+				if (!rulePresent(ctx, rule, key))
+					group = false;
+				if (rule->end & AI_RULE_END_GROUP) {
+					satisfied |= group;
+					group = true;
+				}
+				if (rule->end & AI_RULE_END_CLAUSE)
 					break;
-
 			}
+			rule++;
 
-			if (!satisfied) {	/* Loop finished without satisfying one of the AI groups in "req" */
-				snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Required AIs for AI (%.*s) are not satisfied: %s", ai->ailen, ai->ai, reqErr);
-				return false;
+			if (!satisfied) {
+				gs1_setErrForAI(ctx, gs1_encoder_eAI_REQUISITES_UNSATISFIED, ai->ai, ai->ailen);
+				gs1_setErrArg(ctx, 1, &ai->aiEntry->attrs[clause->textOff], (size_t)clause->textLen);
+				if (!gs1_collectErr(ctx))
+					return false;
 			}
 
 		}
@@ -822,10 +1409,13 @@ static bool validateAIrequisites(gs1_encoder* const ctx) {
  * same value. (Repeated AIs may occur when the AI data from reads of multiple
  * symbol carriers on the same label is concatenated.)
  *
+ * Each instance is compared with the first instance of the AI, reporting the
+ * AI whose first instance is earliest.
+ *
  */
 static bool validateAIrepeats(gs1_encoder* const ctx) {
 
-	int i;
+	int i, first = ctx->numAIs;
 
 	assert(ctx);
 	assert(ctx->numAIs <= MAX_AIS);
@@ -833,26 +1423,41 @@ static bool validateAIrepeats(gs1_encoder* const ctx) {
 	for (i = 0; i < ctx->numAIs; i++) {
 
 		const struct aiValue* const ai = &ctx->aiData[i];
-		int j;
+		const struct aiValue *ai2;
+		int f;
 
 		if (ai->kind != aiValue_aival)
 			continue;
 
-		for (j = i + 1; j < ctx->numAIs; j++) {
-
-			const struct aiValue* const ai2 = &ctx->aiData[j];
+		f = ctx->aiFirstInstance[aiIndexKey(ai->ai, ai->ailen)];
+		if (f == i)
+			continue;
 
-			if (ai2->kind != aiValue_aival)
+		/*
+		 *  Unknown AIs of differing lengths within an unallocated prefix
+		 *  share an index key, so find the AI's own first instance.
+		 *
+		 */
+		if (ctx->aiData[f].ailen != ai->ailen) {
+			for (f = 0; f < i; f++) {
+				ai2 = &ctx->aiData[f];
+				if (ai2->kind == aiValue_aival && ai2->ailen == ai->ailen && strncmp(ai2->ai, ai->ai, ai->ailen) == 0)
+					break;
+			}
+			if (f == i)
 				continue;
+		}
 
-			if (ai->ailen == ai2->ailen && strncmp(ai->ai, ai2->ai, ai->ailen) == 0 &&
-			   (ai->vallen != ai2->vallen || strncmp(ai->value, ai2->value, ai->vallen) != 0)) {
-				snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Multiple instances of AI (%.*s) have different values", ai->ailen, ai->ai);
-				return false;
-			}
+		ai2 = &ctx->aiData[f];
+		if (f < first && (ai->vallen != ai2->vallen || strncmp(ai->value, ai2->value, ai->vallen) != 0))
+			first = f;
 
-		}
+	}
 
+	if (first != ctx->numAIs) {
+		const struct aiValue* const ai = &ctx->aiData[first];
+		gs1_setErrForAI(ctx, gs1_encoder_eAI_INSTANCES_DIFFER, ai->ai, ai->ailen);
+		return gs1_collectErr(ctx);
 	}
 
 	return true;
@@ -872,7 +1477,7 @@ static bool validateDigSigRequiresSerialisedKey(gs1_encoder* const ctx) {
 	assert(ctx);
 	assert(ctx->numAIs <= MAX_AIS);
 
-	if (!aiExists(ctx, "8030", NULL, NULL))
+	if (!anyAIpresent(ctx, aiIndexKey("8030", 4), aiIndexKey("8030", 4)))
 		return true;
 
 	for (i = 0; i < ctx->numAIs; i++) {
@@ -887,8 +1492,9 @@ static bool validateDigSigRequiresSerialisedKey(gs1_encoder* const ctx) {
 			continue;
 
 		if (ai->vallen == aiEntryMinLength(ai->aiEntry)) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Serial component must be present for AI (%.*s) when used with AI (8030)", ai->ailen, ai->ai);
-			return false;
+			gs1_setErrForAI(ctx, gs1_encoder_eAI_SERIAL_REQUIRED, ai->ai, ai->ailen);
+			if (!gs1_collectErr(ctx))
+				return false;
 		}
 
 	}
@@ -902,20 +1508,45 @@ static bool validateDigSigRequiresSerialisedKey(gs1_encoder* const ctx) {
  *  Execute each enabled validation function in turn
  *
  */
-bool gs1_validateAIs(gs1_encoder* const ctx) {
+static bool validateAIs(gs1_encoder* const ctx) {
 
 	int i;
 
+	markPresentAIs(ctx);
+
 	for (i = 0; i < gs1_encoder_vNUMVALIDATIONS; i++) {
 
 		const struct validationEntry v = ctx->validationTable[i];
+		const int numErrs = ctx->numErrs;
 
-		if (v.enabled && v.fn && !v.fn(ctx))
+		if (!v.enabled || !v.fn)
+			continue;
+
+		if (!v.fn(ctx)) {
+			STATS_VALIDATION_FAILURE(ctx, i);
 			return false;
+		}
+
+		if (ctx->numErrs != numErrs)		// Collected errors
+			STATS_VALIDATION_FAILURE(ctx, i);
 
 	}
 
-	return true;
+	// Fail if any recoverable errors were collected, here or during parsing
+	return gs1_checkCollectedErrs(ctx);
+
+}
+
+
+bool gs1_validateAIs(gs1_encoder* const ctx) {
+
+	bool ok;
+
+	STATS_ENTER(ctx, gs1_encoder_pVALIDATE, NULL, 0);
+	ok = validateAIs(ctx);
+	STATS_LEAVE(ctx);
+
+	return ok;
 
 }
 
@@ -991,6 +1622,41 @@ void test_ai_lookupAIentry(void) {
 }
 
 
+void test_ai_embeddedAIindex(void) {
+
+#ifndef EXCLUDE_EMBEDDED_AI_TABLE
+
+	gs1_syntax_dictionary sd = {0};
+	const struct aiEntry *e;
+	size_t i;
+
+	/*
+	 *  The index emitted by the generator alongside the embedded AI table
+	 *  must match the index that would be built for it at runtime.
+	 *
+	 */
+	for (e = embedded_ai_table; *e->ai; e++)
+		sd.aiTableEntries++;
+
+	TEST_ASSERT((sd.aiTable = malloc((sd.aiTableEntries + 1) * sizeof(struct aiEntry))) != NULL);
+	memcpy(sd.aiTable, embedded_ai_table, (sd.aiTableEntries + 1) * sizeof(struct aiEntry));
+
+	TEST_ASSERT(gs1_populateAIindex(&sd));
+	TEST_ASSERT(sd.aiIndex != embedded_ai_index);
+
+	for (i = 0; i < AI_INDEX_SIZE; i++) {
+		TEST_CHECK(sd.aiIndex[i] == embedded_ai_index[i]);
+		TEST_MSG("Index mismatch at key %04d", (int)i);
+	}
+
+	gs1_freeAIindex(&sd);
+	free(sd.aiTable);
+
+#endif
+
+}
+
+
 void test_ai_checkAIlengthByPrefix(void) {
 
 	gs1_encoder* ctx;
@@ -1055,7 +1721,7 @@ void test_ai_AItableVsPrefixLength(void) {
 	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
 	assert(ctx);
 
-	for (entry = ctx->aiTable; *entry->ai; entry++) {
+	for (entry = ctx->sd->aiTable; *entry->ai; entry++) {
 		TEST_CASE(entry->ai);
 		TEST_CHECK(strlen(entry->ai) == aiLengthByPrefix(ctx, entry->ai));
 		TEST_MSG("Expected %d; Got %d", aiLengthByPrefix(ctx, entry->ai), strlen(entry->ai));
@@ -1072,7 +1738,7 @@ void test_ai_AItableVsIsFNC1required(void) {
 	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
 	assert(ctx);
 
-	for (entry = ctx->aiTable; *entry->ai; entry++) {
+	for (entry = ctx->sd->aiTable; *entry->ai; entry++) {
 		TEST_CASE(entry->ai);
 		TEST_CHECK(entry->fnc1 == (valLengthByPrefix(entry->ai) == 0));
 		TEST_MSG("Prefix list: %d; AI table: %d", (valLengthByPrefix(entry->ai) == 0), entry->fnc1);
@@ -1095,7 +1761,7 @@ static void do_test_parseAIdata(gs1_encoder* const ctx, const char* const file,
 	TEST_CHECK(gs1_parseAIdata(ctx, aiData, out) ^ (!should_succeed));
 	if (should_succeed)
 		TEST_CHECK(strcmp(out, expect) == 0);
-	TEST_MSG("Given: %s; Got: %s; Expected: %s; Err: %s", aiData, out, expect, ctx->errMsg);
+	TEST_MSG("Given: %s; Got: %s; Expected: %s; Err: %s", aiData, out, expect, gs1_encoder_getErrMsg(ctx));
 
 }
 
@@ -1155,7 +1821,7 @@ static void test_linters(gs1_encoder* const ctx, const char* const aiData, gs1_l
 
 	ctx->numAIs = 0;
 	TEST_CHECK(gs1_parseAIdata(ctx, aiData, out) || ctx->linterErr != GS1_LINTER_OK);
-	TEST_MSG("Parse failed for non-linter reasons. Err: %s", ctx->errMsg);
+	TEST_MSG("Parse failed for non-linter reasons. Err: %s", gs1_encoder_getErrMsg(ctx));
 
 	TEST_CHECK(ctx->linterErr == expect);
 	TEST_MSG("Got: %d; Expected: %d", ctx->linterErr, expect);
@@ -1322,7 +1988,7 @@ static void do_test_processAIdata(gs1_encoder* const ctx, const char* const file
 
 	// Process and extract AIs
 	TEST_CHECK(gs1_processAIdata(ctx, dataStr, true) ^ (!should_succeed));
-	TEST_MSG(ctx->errMsg);
+	TEST_MSG(gs1_encoder_getErrMsg(ctx));
 
 }
 
@@ -1433,6 +2099,183 @@ void test_ai_processAIdata(void) {
 
 }
 
+void test_ai_compileAIrules(void) {
+
+	gs1_syntax_dictionary sd = {0};
+	struct aiEntry table[4] = {
+		{ .ai = "21",   .attrs = (char*)"req=01,8006 ex=235" },
+		{ .ai = "3101", .attrs = (char*)"req=01,02 ex=310n" },
+		{ .ai = "8030", .attrs = (char*)"req=00,01+21,8010+8011" },
+		{ .ai = "",     .attrs = NULL },
+	};
+	const struct aiRuleSet *rs;
+	const struct aiRule *r;
+
+	sd.aiTable = table;
+	sd.aiTableEntries = 3;
+	TEST_ASSERT(gs1_compileAIrules(&sd));
+
+	rs = &sd.aiRuleSets[0];
+	TEST_ASSERT(rs->numEx == 1 && rs->numReq == 2);
+	r = &sd.aiRules[rs->ex];
+	TEST_CHECK(r->lo == 2350 && r->hi == 2359 && r->selfLen == 3);
+	r = &sd.aiRules[rs->req];
+	TEST_CHECK(r[0].lo == 100 && r[0].hi == 199 && r[0].end == AI_RULE_END_GROUP);
+	TEST_CHECK(r[1].lo == 8006 && r[1].hi == 8006 && r[1].end == (AI_RULE_END_GROUP | AI_RULE_END_CLAUSE));
+	TEST_CHECK(r[0].textOff == 4 && r[0].textLen == 7);				// "01,8006"
+
+	rs = &sd.aiRuleSets[1];
+	TEST_ASSERT(rs->numEx == 1 && rs->numReq == 2);
+	r = &sd.aiRules[rs->ex];
+	TEST_CHECK(r->lo == 3100 && r->hi == 3109 && r->selfLen == 4);		// Wildcard expanded
+
+	rs = &sd.aiRuleSets[2];
+	TEST_ASSERT(rs->numEx == 0 && rs->numReq == 5);
+	r = &sd.aiRules[rs->req];
+	TEST_CHECK(r[0].end == AI_RULE_END_GROUP);					// 00
+	TEST_CHECK(r[1].end == 0);							// 01+
+	TEST_CHECK(r[2].end == AI_RULE_END_GROUP);					// 21
+	TEST_CHECK(r[3].end == 0);							// 8010+
+	TEST_CHECK(r[4].end == (AI_RULE_END_GROUP | AI_RULE_END_CLAUSE));		// 8011
+
+	gs1_freeAIrules(&sd);
+
+}
+
+void test_ai_compileAIprograms(void) {
+
+	gs1_syntax_dictionary sd = {0};
+	struct aiEntry table[4] = {
+		AI_ENTRY( "01"  , NO_FNC1, DL_DATA_ATTR, N,14,14,MAN,csum,key,_, __, __, __, __, "", "" ),
+		AI_ENTRY( "7007", DO_FNC1, DL_DATA_ATTR, N,6,6,MAN,yymmdd,_,_, N,6,6,OPT,yymmdd,_,_, __, __, __, "", "" ),
+		AI_ENTRY( "8030", DO_FNC1, DL_DATA_ATTR, Z,1,90,MAN,_,_,_, __, __, __, __, "", "" ),
+		AI_ENTRY_TERMINATOR
+	};
+	static const uint8_t expect01[] = {
+		AI_OP_COMPONENT, 14, 14, 0, GS1_CSET_NUMERIC, 10,
+			AI_OP_LINT, AI_LINTER_csum, AI_OP_LINT, AI_LINTER_key,
+		AI_OP_END
+	};
+	static const uint8_t expect7007[] = {
+		AI_OP_COMPONENT, 6, 6, 0, GS1_CSET_NUMERIC, 8,
+			AI_OP_LINT, AI_LINTER_yymmdd,
+		AI_OP_COMPONENT, 6, 6, 1, GS1_CSET_NUMERIC, 8,
+			AI_OP_LINT, AI_LINTER_yymmdd,
+		AI_OP_END
+	};
+	static const uint8_t expect8030[] = {
+		AI_OP_COMPONENT, 1, 90, 0, 0, 8,
+			AI_OP_LINT, AI_LINTER_cset64,				// Validates padding too
+		AI_OP_END
+	};
+
+	sd.aiTable = table;
+	sd.aiTableEntries = 3;
+	TEST_ASSERT(gs1_compileAIprograms(&sd));
+
+	TEST_CHECK(memcmp(&sd.aiPrograms[sd.aiProgramOff[0]], expect01, sizeof(expect01)) == 0);
+	TEST_CHECK(memcmp(&sd.aiPrograms[sd.aiProgramOff[1]], expect7007, sizeof(expect7007)) == 0);
+	TEST_CHECK(memcmp(&sd.aiPrograms[sd.aiProgramOff[2]], expect8030, sizeof(expect8030)) == 0);
+	TEST_CHECK(sd.aiProgramOff[2] == sizeof(expect01) + sizeof(expect7007));
+
+	gs1_freeAIprograms(&sd);
+
+}
+
+
+#ifndef EXCLUDE_EMBEDDED_AI_TABLE
+
+static void do_test_generatedValidator(gs1_encoder* const ctx, const struct aiEntry* const entry, const char* const val, const size_t len) {
+
+	size_t retI, retG;
+	gs1_lint_err_t errI;
+	char errMsgI[sizeof(ctx->errMsg)];
+	char markupI[sizeof(ctx->linterErrMarkup)];
+
+	gs1_clearErr(ctx);
+	retI = validate_ai_val_interpreted(ctx, entry->ai, entry, val, val + len);
+	errI = ctx->linterErr;
+	strcpy(errMsgI, gs1_encoder_getErrMsg(ctx));
+	strcpy(markupI, gs1_encoder_getErrMarkup(ctx));
+
+	gs1_clearErr(ctx);
+	TEST_ASSERT(validate_ai_val_generated(ctx, entry->ai, entry, val, val + len, &retG));
+
+	TEST_CHECK(retG == retI);
+	TEST_MSG("AI (%s) \"%.*s\": interpreted consumed %d, generated consumed %d", entry->ai, (int)len, val, (int)retI, (int)retG);
+	TEST_CHECK(ctx->linterErr == errI);
+	TEST_MSG("AI (%s) \"%.*s\": linter errors differ", entry->ai, (int)len, val);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), errMsgI) == 0);
+	TEST_MSG("AI (%s) \"%.*s\": \"%s\" vs \"%s\"", entry->ai, (int)len, val, errMsgI, gs1_encoder_getErrMsg(ctx));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMarkup(ctx), markupI) == 0);
+	TEST_MSG("AI (%s) \"%.*s\": \"%s\" vs \"%s\"", entry->ai, (int)len, val, markupI, gs1_encoder_getErrMarkup(ctx));
+
+}
+
+#endif
+
+void test_ai_generatedValidators(void) {
+
+#ifndef EXCLUDE_EMBEDDED_AI_TABLE
+
+	static const char* const patterns[] = {
+		"0952123454321395212345432130952123454321395212345432130952123454321395212345432130952123454321",
+		"2512310000000000000000000000000000000000000000000000000000000000000000000000000000000000000000",
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-ABCDEFGHIJKLMNOPQRST",
+		"abc!\"%&'()*+,-./:;<=>?_xyzabc!\"%&'()*+,-./:;<=>?_xyzabc!\"%&'()*+,-./:;<=>?_xyzabc!\"%&'()*+,-.",
+		"978QWERTY12-34_56aBcDeF+/0123456789978QWERTY12-34_56aBcDeF+/0123456789978QWERTY12-34_56aBcDeF",
+		"1234 5678#9012345678901234567890123456789012345678901234567890123456789012345678901234567890123",
+	};
+	static const char invalid[] = { ' ', '#', 'a', 'Z', '!', '=' };
+
+	gs1_encoder* ctx;
+	const struct aiEntry *entry;
+	char val[MAX_AI_VALUE_LEN + 3];
+	size_t i, j, k, len, maxlen;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	/*
+	 *  The generated validators must agree with the interpreter on every
+	 *  AI in the embedded table, for both valid and invalid data.
+	 *
+	 */
+	for (entry = embedded_ai_table; *entry->ai; entry++) {
+
+		for (maxlen = 0, i = 0; i < MAX_PARTS && entry->parts[i].cset; i++)
+			maxlen += entry->parts[i].max;
+		maxlen += 2;
+
+		for (i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+			for (len = 1; len <= maxlen && len <= strlen(patterns[i]) && len <= sizeof(val); len++) {
+				memcpy(val, patterns[i], len);
+				do_test_generatedValidator(ctx, entry, val, len);
+				for (j = 0; j < len; j += 7) {
+					for (k = 0; k < sizeof(invalid); k++) {
+						memcpy(val, patterns[i], len);
+						val[j] = invalid[k];
+						do_test_generatedValidator(ctx, entry, val, len);
+					}
+				}
+			}
+		}
+
+	}
+
+	do_test_generatedValidator(ctx, gs1_lookupAIentry(ctx, "01", 2), "09521234543213", 14);
+	do_test_generatedValidator(ctx, gs1_lookupAIentry(ctx, "17", 2), "251231", 6);
+	do_test_generatedValidator(ctx, gs1_lookupAIentry(ctx, "7007", 4), "251231251215", 12);
+	do_test_generatedValidator(ctx, gs1_lookupAIentry(ctx, "8030", 4), "ABCD-_12", 8);
+	do_test_generatedValidator(ctx, gs1_lookupAIentry(ctx, "8030", 4), "ABCD-_1=", 8);
+
+	gs1_encoder_free(ctx);
+
+#endif
+
+}
+
+
 static void do_test_validateAIs(gs1_encoder* const ctx, const char* const file, const int line, const bool should_succeed, gs1_encoder_validation_func_t fn, const char* const aiData) {
 
 	bool ret;
@@ -1444,17 +2287,19 @@ static void do_test_validateAIs(gs1_encoder* const ctx, const char* const file,
 
 	ctx->numAIs = 0;
 	TEST_CHECK((ret = gs1_parseAIdata(ctx, aiData, out)) == true);
-	TEST_MSG("Parse failed for non-pair validation reasons. Err: %s", ctx->errMsg);
+	TEST_MSG("Parse failed for non-pair validation reasons. Err: %s", gs1_encoder_getErrMsg(ctx));
 	if (!ret)
 		return;
 
+	markPresentAIs(ctx);
+
 	if (!should_succeed) {
 		TEST_CHECK(!fn(ctx));
 		return;
 	}
 
 	TEST_CHECK(fn(ctx));
-	TEST_MSG("Expected success. Got: %s", ctx->errMsg);
+	TEST_MSG("Expected success. Got: %s", gs1_encoder_getErrMsg(ctx));
 
 }
 
@@ -60,7 +60,7 @@ struct aiComponent {
 	uint8_t min;				// Minimum length. Currently 0 for optional, 1 for mandatory
 	uint8_t max;				// Maximum length
 	bool opt;				// Optional final component
-	gs1_linter_t linters[MAX_LINTERS];	// Linter functions applied to component
+	gs1_lintn_t linters[MAX_LINTERS];	// Linter functions applied to component
 };
 
 
@@ -74,6 +74,72 @@ struct aiEntry {
 };
 
 
+/*
+ * "ex" and "req" attributes are compiled into rules, each matching a range of
+ * AI index keys. A "req" attribute is a sequence of groups, the last rule of
+ * each being flagged, one of which must be wholly present.
+ *
+ */
+#define AI_INDEX_SIZE		10000		// AIs right-padded with zeros to four digits
+
+#define AI_RULE_END_GROUP	1		// Last member of a "+" group
+#define AI_RULE_END_CLAUSE	2		// Last group of a "req" attribute
+
+struct aiRule {
+	uint16_t lo;				// First AI index key matched
+	uint16_t hi;				// Last AI index key matched
+	uint8_t selfLen;			// Leading digits within which a match of the subject AI itself is ignored
+	uint8_t end;				// AI_RULE_END_* flags
+	uint8_t textOff;			// Position of the "req" attribute value within attrs, for reporting
+	uint8_t textLen;			// Length of the "req" attribute value
+};
+
+struct aiRuleSet {
+	uint16_t ex;				// Position of the "ex" rules within the rule pool
+	uint16_t numEx;
+	uint16_t req;				// Position of the "req" rules within the rule pool
+	uint16_t numReq;
+};
+
+
+/*
+ * Each AI table entry is compiled into a validation program, a byte-coded
+ * sequence of the following instructions:
+ *
+ *   AI_OP_COMPONENT min max opt cset next
+ *        Take the next component, checking its length and, unless cset is
+ *        zero, its character set class. An empty optional component skips
+ *        ahead by next bytes to the following component.
+ *   AI_OP_LINT id
+ *        Run the linter with the given aiLinterId over the component.
+ *   AI_OP_END
+ *
+ */
+#define AI_OP_END		0
+#define AI_OP_COMPONENT		1
+#define AI_OP_LINT		2
+
+#define AI_PROGRAM_MAX_LEN	((6 + 2 * MAX_LINTERS) * (MAX_PARTS - 1) + 1)
+
+#define AI_LINTERS(X)	\
+	X(couponcode) X(couponposoffer) X(cset39) X(cset64) X(cset82)	\
+	X(csetnumeric) X(csum) X(csumalpha) X(hasnondigit) X(hh)	\
+	X(hhmm) X(hyphen) X(iban) X(importeridx) X(iso3166)	\
+	X(iso3166999) X(iso3166alpha2) X(iso3166list) X(iso4217)	\
+	X(iso5218) X(key) X(latitude) X(longitude) X(mediatype) X(mm)	\
+	X(mmoptss) X(nonzero) X(nozeroprefix) X(pcenc) X(pieceoftotal)	\
+	X(posinseqslash) X(ss) X(winding) X(yesno) X(yymmd0) X(yymmdd)	\
+	X(yymmddhh) X(yyyymmd0) X(yyyymmdd) X(zero)
+
+#define AI_LINTER_ID(n) AI_LINTER_##n,
+enum aiLinterId {
+	AI_LINTER_NONE = 0,
+	AI_LINTERS(AI_LINTER_ID)
+	AI_NUM_LINTERS
+};
+#undef AI_LINTER_ID
+
+
 typedef enum {
 	aiValue_undef = 0,
 	aiValue_aival,				// Extracted AI value pair
@@ -122,11 +188,11 @@ struct validationEntry {
 		.fnc1 = f,																		\
 		.dlDataAttr = d,																	\
 		.parts = {																		\
-			{ .cset = cset_##c1, .min = mn1, .max = mx1, .opt = o1, .linters = { gs1_lint_##l00, gs1_lint_##l01, gs1_lint_##l02, NULL } },			\
-			{ .cset = cset_##c2, .min = mn2, .max = mx2, .opt = o2, .linters = { gs1_lint_##l10, gs1_lint_##l11, gs1_lint_##l12, NULL } },			\
-			{ .cset = cset_##c3, .min = mn3, .max = mx3, .opt = o3, .linters = { gs1_lint_##l20, gs1_lint_##l21, gs1_lint_##l22, NULL } },			\
-			{ .cset = cset_##c4, .min = mn4, .max = mx4, .opt = o4, .linters = { gs1_lint_##l30, gs1_lint_##l31, gs1_lint_##l32, NULL } },			\
-			{ .cset = cset_##c5, .min = mn5, .max = mx5, .opt = o5, .linters = { gs1_lint_##l40, gs1_lint_##l41, gs1_lint_##l42, NULL } },			\
+			{ .cset = cset_##c1, .min = mn1, .max = mx1, .opt = o1, .linters = { gs1_lintn_##l00, gs1_lintn_##l01, gs1_lintn_##l02, NULL } },			\
+			{ .cset = cset_##c2, .min = mn2, .max = mx2, .opt = o2, .linters = { gs1_lintn_##l10, gs1_lintn_##l11, gs1_lintn_##l12, NULL } },			\
+			{ .cset = cset_##c3, .min = mn3, .max = mx3, .opt = o3, .linters = { gs1_lintn_##l20, gs1_lintn_##l21, gs1_lintn_##l22, NULL } },			\
+			{ .cset = cset_##c4, .min = mn4, .max = mx4, .opt = o4, .linters = { gs1_lintn_##l30, gs1_lintn_##l31, gs1_lintn_##l32, NULL } },			\
+			{ .cset = cset_##c5, .min = mn5, .max = mx5, .opt = o5, .linters = { gs1_lintn_##l40, gs1_lintn_##l41, gs1_lintn_##l42, NULL } },			\
 			{ .cset = 0,         .min = 0,   .max = 0,   .opt = 0,   .linters = { NULL,       NULL,       NULL } },						\
 		},																			\
 		.attrs = k,																		\
@@ -135,32 +201,40 @@ struct validationEntry {
 #define PASS_ON(...) __VA_ARGS__
 #define AI_ENTRY(...) PASS_ON(AI_VA(__VA_ARGS__))
 #define cset_0 0
-#define gs1_lint__ NULL
+#define gs1_lintn__ NULL
 #define __ 0,0,0,0,_,_,_		/* NULL placeholder instead of e.g. X,1,30,MAN,csum,key */
 #define AI_ENTRY_TERMINATOR AI_ENTRY( "", 0, 0, __, __, __, __, __, "", "" )
 
 
-// Write to unbracketed AI dataStr checking for overflow
+// Write to unbracketed AI data through the writer "out" checking for overflow
 #define writeDataStr(v) do {						\
-	if (strlen(dataStr) + strlen(v) > MAX_DATA)			\
+	if (!gs1_writeStr(&out, v))					\
 		goto fail;						\
-	strcat(dataStr, v);						\
 } while (0)
 
 #define nwriteDataStr(v,l) do {						\
-	if (strlen(dataStr) + l > MAX_DATA)				\
+	if (!gs1_writeN(&out, v, l))					\
 		goto fail;						\
-	strncat(dataStr, v, l);						\
 } while (0)
 
 
 #include "gs1encoders.h"
 
-void gs1_setAItable(gs1_encoder *ctx, struct aiEntry *table);
+void gs1_setAItable(gs1_syntax_dictionary *sd, struct aiEntry *table);
+bool gs1_populateAIlengthByPrefix(gs1_syntax_dictionary *sd);
+bool gs1_populateAIindex(gs1_syntax_dictionary *sd);
+void gs1_freeAIindex(gs1_syntax_dictionary *sd);
+bool gs1_compileAIrules(gs1_syntax_dictionary *sd);
+void gs1_freeAIrules(gs1_syntax_dictionary *sd);
+bool gs1_compileAIprograms(gs1_syntax_dictionary *sd);
+void gs1_freeAIprograms(gs1_syntax_dictionary *sd);
 const struct aiEntry* gs1_lookupAIentry(const gs1_encoder *ctx, const char *ai, size_t ailen);
+int gs1_aiTablePosition(const gs1_syntax_dictionary *sd, const char *ai, size_t ailen);
 bool gs1_aiValLengthContentCheck(gs1_encoder *ctx, const char *ai, const struct aiEntry *entry, const char *aiVal, size_t vallen);
 bool gs1_parseAIdata(gs1_encoder *ctx, const char *aiData, char *dataStr);
+bool gs1_parseAIdataN(gs1_encoder *ctx, const char *aiData, size_t len, char *dataStr);
 bool gs1_processAIdata(gs1_encoder *ctx, const char *dataStr, bool extractAIs);
+bool gs1_processAIdataN(gs1_encoder *ctx, const char *data, size_t len, bool extractAIs, bool gsIsFNC1);
 bool gs1_validateAIs(gs1_encoder* ctx);
 void gs1_loadValidationTable(gs1_encoder* ctx);
 
@@ -168,6 +242,7 @@ void gs1_loadValidationTable(gs1_encoder* ctx);
 #ifdef UNIT_TESTS
 
 void test_ai_lookupAIentry(void);
+void test_ai_embeddedAIindex(void);
 void test_ai_checkAIlengthByPrefix(void);
 void test_ai_AItableVsPrefixLength(void);
 void test_ai_AItableVsIsFNC1required(void);
@@ -175,6 +250,9 @@ void test_ai_parseAIdata(void);
 void test_ai_linters(void);
 void test_ai_processAIdata(void);
 void test_ai_validateAIs(void);
+void test_ai_compileAIrules(void);
+void test_ai_compileAIprograms(void);
+void test_ai_generatedValidators(void);
 void test_ai_lint_csumalpha(void);
 
 #endif
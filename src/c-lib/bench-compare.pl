@@ -0,0 +1,93 @@
+#!/usr/bin/perl -w
+
+#
+#  This script compares two sets of results from the benchmark suite,
+#  reporting any benchmark that has become slower by more than the threshold
+#  percentage, either in its mean time per operation or its 99th percentile
+#  latency, or that makes more heap allocations per operation.
+#
+#      ./bench-compare.pl [--threshold=5] base.json new.json
+#
+#  The exit status is non-zero if any regression is found.
+#
+
+use strict;
+
+use JSON::PP;
+
+
+my $threshold = 5;
+
+if (@ARGV && $ARGV[0] =~ /^--threshold=(\d+(?:\.\d+)?)$/) {
+    $threshold = $1;
+    shift @ARGV;
+}
+
+die "Usage: $0 [--threshold=PERCENT] base.json new.json\n" unless @ARGV == 2;
+
+
+sub load {
+    my ($file) = @_;
+    open(my $fh, '<', $file) or die "Cannot open $file: $!\n";
+    local $/;
+    my $results = decode_json(<$fh>);
+    close $fh;
+    my %benchmarks = map { $_->{name} => $_ } @{$results->{benchmarks}};
+    return ($results, \%benchmarks);
+}
+
+sub change {
+    my ($old, $new) = @_;
+    return 0 unless $old;
+    return 100 * ($new - $old) / $old;
+}
+
+
+my ($base, $baseBenchmarks) = load($ARGV[0]);
+my ($new, $newBenchmarks) = load($ARGV[1]);
+
+my $regressions = 0;
+
+printf "%-36s %12s %12s %8s %10s %10s %8s %8s\n",
+    'benchmark', 'base ns/op', 'new ns/op', 'change', 'base p99', 'new p99', 'change', 'allocs';
+
+foreach my $b (@{$new->{benchmarks}}) {
+
+    my $name = $b->{name};
+    my $a = $baseBenchmarks->{$name};
+
+    unless ($a) {
+        printf "%-36s %12s %12.1f\n", $name, '-', $b->{ns_per_op};
+        next;
+    }
+
+    my $mean = change($a->{ns_per_op}, $b->{ns_per_op});
+    my $p99 = change($a->{p99_ns}, $b->{p99_ns});
+
+    my @why;
+    push @why, 'ns/op' if $mean > $threshold;
+    push @why, 'p99' if $p99 > $threshold;
+    push @why, 'allocs' if defined $a->{allocs_per_op} && defined $b->{allocs_per_op} &&
+                           $b->{allocs_per_op} > $a->{allocs_per_op};
+
+    printf "%-36s %12.1f %12.1f %+7.1f%% %10d %10d %+7.1f%% %8s%s\n",
+        $name, $a->{ns_per_op}, $b->{ns_per_op}, $mean, $a->{p99_ns}, $b->{p99_ns}, $p99,
+        defined $b->{allocs_per_op} ? sprintf('%.2f', $b->{allocs_per_op}) : '-',
+        @why ? '  REGRESSION (' . join(', ', @why) . ')' : '';
+
+    $regressions++ if @why;
+
+}
+
+foreach my $name (sort keys %$baseBenchmarks) {
+    printf "%-36s missing from %s\n", $name, $ARGV[1] unless $newBenchmarks->{$name};
+}
+
+printf "\nPeak RSS: %d kB -> %d kB\n", $base->{peak_rss_kb}, $new->{peak_rss_kb};
+
+if ($regressions) {
+    printf "%d benchmark(s) regressed by more than %s%%\n", $regressions, $threshold;
+    exit 1;
+}
+
+print "No regressions\n";
@@ -99,6 +99,8 @@ my $entry_rx = qr/
     $
 /x;
 
+my @index;
+
 print "static struct aiEntry embedded_ai_table[] = {\n";
 
 while (<>) {
@@ -166,6 +168,7 @@ while (<>) {
     $title = sprintf("%-27s", "\"$title\"");
 
     for ($aimin..$aimax) {
+        push @index, $_;
         $_ = sprintf('%-6s', "\"$_\"");
         print "\tAI_ENTRY( $_, $fnc1, $dlDataAttr,$specstr$keyvals$title ),\n";
     }
@@ -174,3 +177,16 @@ while (<>) {
 
 print "\tAI_ENTRY_TERMINATOR\n";
 print "};\n";
+
+#
+#  Direct index from the AI, right-padded with zeros to four digits, to its
+#  position in the table plus one, so that unset slots denote "no such AI".
+#
+print "\n";
+print "static const uint16_t embedded_ai_index[10000] = {\n";
+my $pos = 0;
+foreach (@index) {
+    $pos++;
+    printf "\t[%4d] = %3d,\t/* (%s) */\n", substr("${_}000", 0, 4), $pos, $_;
+}
+print "};\n";
@@ -0,0 +1,149 @@
+#!/usr/bin/perl -Tw
+
+#
+#  This script can be used to build a specialised validation function for each
+#  AI in the embedded AI table, used instead of interpreting the compiled
+#  validation programs when building with GENERATED_VALIDATORS=yes.
+#
+#  The functions are derived from the embedded AI table itself so that the two
+#  cannot disagree, therefore this must be rerun whenever aitable.inc changes.
+#
+#      cat aitable.inc | ./build-embedded-ai-validators.pl > aivalidators.inc
+#
+
+use strict;
+
+
+my %cset = (
+    N => [ 'GS1_CSET_NUMERIC', 'GS1_LINTER_NON_DIGIT_CHARACTER' ],
+    X => [ 'GS1_CSET_82',      'GS1_LINTER_INVALID_CSET82_CHARACTER' ],
+    Y => [ 'GS1_CSET_39',      'GS1_LINTER_INVALID_CSET39_CHARACTER' ],
+    Z => [ undef,              undef ],
+);
+
+my %fn;
+my %dispatch;
+
+
+#
+#  Body of the validation function for a sequence of components, each being
+#  [ cset, min, max, opt, linters... ]
+#
+sub validator {
+
+    my $body = '';
+    my $linted = 0;
+
+    foreach (@_) {
+
+        (my $cs, my $min, my $max, my $opt, my @linters) = @$_;
+
+        my $ind = $opt ? "\t\t" : "\t";
+        my $fixed = $min == $max && !$opt;
+        my $len = $fixed ? $max : 'complen';
+
+        $body .= sprintf("\n\t/* %s%s%s%s%s */\n", $opt ? '[' : '', $cs,
+                         $min == $max ? $max : ($min == 1 ? '' : $min) . "..$max",
+                         $opt ? ']' : '', join('', map { ",$_" } @linters));
+
+        if ($fixed) {
+            $body .= "\tif (end - p < $max)\n";
+            $body .= "\t\treturn aiValLengthFail(ctx, ai, entry);\n";
+            $body .= "\tcomplen = $max;\n";
+        } else {
+            $body .= "\tcomplen = end - p < $max ? (size_t)(end - p) : $max;\n";
+            $body .= "\tif (complen != 0) {\t\t// Otherwise an empty optional component\n" if $opt;
+            $body .= "${ind}if (complen < $min)\n";
+            $body .= "${ind}\treturn aiValLengthFail(ctx, ai, entry);\n";
+        }
+
+        if (defined $cset{$cs}[0]) {
+            $body .= "${ind}if ((errpos = gs1_cset_span(p, $len, $cset{$cs}[0])) != $len)\n";
+            $body .= "${ind}\treturn aiValLintFail(ctx, ai, entry, start, p, complen, $cset{$cs}[1], errpos, 1);\n";
+        } else {
+            unshift @linters, 'cset64';        # Also validates the padding
+        }
+
+        foreach (@linters) {
+            $linted = 1;
+            $body .= "${ind}if ((err = gs1_lintn_$_(p, $len, &errpos, &errlen)) != GS1_LINTER_OK)\n";
+            $body .= "${ind}\treturn aiValLintFail(ctx, ai, entry, start, p, complen, err, errpos, errlen);\n";
+        }
+
+        $body .= "${ind}p += complen;\n";
+        $body .= "\t}\n" if $opt;
+
+    }
+
+    my $decls = "\tconst char *p = start;\n";
+    $decls .= "\tsize_t complen, errpos;\n";
+    $decls .= "\tgs1_lint_err_t err;\n\tsize_t errlen;\n" if $linted;
+
+    return $decls . $body;
+
+}
+
+
+while (<>) {
+
+    next unless /^\s*AI_ENTRY\(\s*"(\d+)"\s*,\s*\w+,\s*\w+,(.*)$/;
+
+    my $ai = $1;
+    my @tokens = map { s/^\s+|\s+$//gr } split(',', $2);
+
+    my @comps;
+    while (@tokens) {
+        my $t = shift @tokens;
+        last if $t =~ /^"/;                    # Attributes
+        next if $t eq '__';                    # Unused component
+        (my $min, my $max, my $opt, my @linters) = splice(@tokens, 0, 6);
+        die "Bad entry for AI ($ai)" unless exists $cset{$t} && $max =~ /^\d+$/;
+        push @comps, [ $t, $min, $max, $opt eq 'OPT', grep { $_ ne '_' } @linters ];
+    }
+
+    #
+    #  AIs with the same components share a function, named after the first
+    #
+    my $spec = join(' ', map { join(',', @$_) } @comps);
+    unless (exists $fn{$spec}) {
+        $fn{$spec} = "validate_ai_$ai";
+        print "static size_t $fn{$spec}(gs1_encoder* const ctx, const char* const ai, const struct aiEntry* const entry, const char* const start, const char* const end) {\n\n";
+        print validator(@comps);
+        print "\n\treturn (size_t)(p - start);\n\n}\n\n";
+    }
+
+    my $rest = length($ai) > 2 ? substr($ai, 2) + 0 : -1;
+    $dispatch{substr($ai, 0, 2) + 0}{$rest} = [ $fn{$spec}, length($ai) ];
+
+}
+
+
+#
+#  Dispatch on the two-digit prefix, then on any remaining digits since the AI
+#  length is fixed by its prefix
+#
+print "static bool validate_ai_val_generated(gs1_encoder* const ctx, const char* const ai, const struct aiEntry* const entry, const char* const start, const char* const end, size_t* const consumed) {\n\n";
+print "\tconst char* const e = entry->ai;\n\n";
+print "\tif (e[0] < '0' || e[0] > '9' || e[1] < '0' || e[1] > '9')\n";
+print "\t\treturn false;\t\t// Pseudo entry for an unknown AI\n\n";
+print "#define AI_VAL(f) do { *consumed = f(ctx, ai, entry, start, end); return true; } while (0)\n\n";
+print "\tswitch ((e[0] - '0') * 10 + (e[1] - '0')) {\n";
+foreach my $prefix (sort { $a <=> $b } keys %dispatch) {
+    my $d = $dispatch{$prefix};
+    if (exists $d->{-1}) {
+        printf "\tcase %2d: AI_VAL(%s);\n", $prefix, $d->{-1}[0];
+        next;
+    }
+    my $sel = (values %$d)[0][1] == 3 ? "e[2] - '0'" : "(e[2] - '0') * 10 + (e[3] - '0')";
+    printf "\tcase %2d:\n", $prefix;
+    print "\t\tswitch ($sel) {\n";
+    foreach my $rest (sort { $a <=> $b } keys %$d) {
+        printf "\t\tcase %2d: AI_VAL(%s);\n", $rest, $d->{$rest}[0];
+    }
+    print "\t\t}\n";
+    print "\t\tbreak;\n";
+}
+print "\t}\n\n";
+print "#undef AI_VAL\n\n";
+print "\treturn false;\n\n";
+print "}\n";
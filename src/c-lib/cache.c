@@ -0,0 +1,465 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gs1encoders.h"
+#include "enc-private.h"
+#include "cache.h"
+
+
+/*
+ *  The outcome of each setter call is remembered in a direct-mapped table,
+ *  keyed by the input together with the settings that influence its
+ *  processing, so that an input that is seen repeatedly (such as the same
+ *  label being scanned over and over) is only parsed and validated once.
+ *
+ *  An entry records the state that the setter leaves behind: the data
+ *  buffers, the extracted AIs with their pointers held as offsets into copies
+ *  of those buffers, and the outcome with any error. The AI table entries are
+ *  referenced directly since the Syntax Dictionary of a context is fixed for
+ *  its lifetime.
+ *
+ */
+
+#define CACHE_NO_DATA	UINT16_MAX	// Offset of a NULL pointer
+
+struct cacheAI {
+	const struct aiEntry *aiEntry;
+	uint16_t aiOff;				// Position of the AI within the entry's buffer
+	uint16_t valueOff;			// Position of the value within the entry's buffer
+	uint8_t ailen;
+	uint8_t vallen;
+	uint8_t kind;
+	uint8_t dlPathOrder;
+};
+
+struct gs1_cacheEntry {
+	uint64_t hash;				// Hash of the key, or zero for an unused entry
+	uint32_t config;			// Settings under which the input was processed
+	uint8_t setter;				// Setter that processed the input
+	bool ok;				// Outcome of the setter
+	uint16_t inputLen;
+	char input[CACHE_MAX_DATA];
+	uint16_t dataStrLen;
+	uint16_t dlAIbufferLen;
+	char buf[2 * (CACHE_MAX_DATA + 1)];	// Copies of dataStr followed by dlAIbuffer
+	gs1_encoder_symbologies_t sym;
+	int numAIs;
+	struct cacheAI aiData[MAX_AIS];
+	struct gs1_errRecord err;
+	gs1_lint_err_t linterErr;
+};
+
+
+bool gs1_cacheResize(gs1_encoder* const ctx, const int entries) {
+
+	struct gs1_cacheEntry *cache = NULL;
+
+	assert(ctx);
+	assert(entries >= 0);
+
+	if (entries) {
+#ifndef NOMALLOC
+		cache = calloc((size_t)entries, sizeof(struct gs1_cacheEntry));
+#endif
+		if (!cache)
+			return false;
+	}
+
+#ifndef NOMALLOC
+	free(ctx->cache);
+#endif
+	ctx->cache = cache;
+	ctx->cacheSize = entries;
+	ctx->cacheHits = ctx->cacheMisses = 0;
+
+	return true;
+
+}
+
+
+/*
+ *  Settings that influence how an input is processed. The Syntax Dictionary
+ *  needs no part in this since it is fixed for the lifetime of the context.
+ *
+ */
+static uint32_t cacheConfig(const gs1_encoder* const ctx) {
+
+	uint32_t config;
+	int i;
+
+	config = (uint32_t)ctx->permitUnknownAIs |
+		 (uint32_t)ctx->permitZeroSuppressedGTINinDLuris << 1 |
+		 (uint32_t)ctx->addCheckDigit << 2;
+
+	for (i = 0; i < gs1_encoder_vNUMVALIDATIONS; i++)
+		if (ctx->validationTable[i].enabled)
+			config |= UINT32_C(1) << (8 + i);
+
+	return config;
+
+}
+
+
+/*
+ *  FNV-1a over the input, followed by the setter and settings
+ *
+ */
+static uint64_t cacheHash(const cacheSetter_t setter, const uint32_t config, const char* const input, const size_t len) {
+
+	uint64_t h = UINT64_C(14695981039346656037);
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		h = (h ^ (uint8_t)input[i]) * UINT64_C(1099511628211);
+	h = (h ^ (uint64_t)setter) * UINT64_C(1099511628211);
+	h = (h ^ config) * UINT64_C(1099511628211);
+
+	return h ? h : 1;
+
+}
+
+
+/*
+ *  Inputs are only eligible when caching is enabled, errors are not being
+ *  collected and the input is short and not held by the context itself,
+ *  where it may be overwritten by processing.
+ *
+ */
+static bool cacheEligible(const gs1_encoder* const ctx, const char* const input, const size_t len) {
+	return ctx->cache && !ctx->collectErrs && len <= CACHE_MAX_DATA &&
+	       ((uintptr_t)input < (uintptr_t)ctx || (uintptr_t)input >= (uintptr_t)(ctx + 1));
+}
+
+
+static inline struct gs1_cacheEntry* cacheSlot(const gs1_encoder* const ctx, const uint64_t hash) {
+	return &ctx->cache[hash % (uint64_t)ctx->cacheSize];
+}
+
+
+/*
+ *  Pointer for a position recorded by cacheOffset(), within the restored
+ *  dataStr or dlAIbuffer.
+ *
+ */
+static inline const char* cachePointer(const gs1_encoder* const ctx, const uint16_t off, const size_t dataStrLen) {
+
+	if (off == CACHE_NO_DATA)
+		return NULL;
+
+	return off <= dataStrLen ? ctx->dataStr + off : ctx->dlAIbuffer + (off - dataStrLen - 1);
+
+}
+
+
+/*
+ *  Restore the state left by the setter when it last processed the input,
+ *  returning false if the input is not in the cache.
+ *
+ */
+bool gs1_cacheLookup(gs1_encoder* const ctx, const cacheSetter_t setter, const char* const input, const size_t len, bool* const ok) {
+
+	const struct gs1_cacheEntry *e;
+	uint32_t config;
+	uint64_t hash;
+	int i;
+
+	assert(ctx);
+	assert(input || len == 0);
+	assert(ok);
+
+	if (!cacheEligible(ctx, input, len))
+		return false;
+
+	config = cacheConfig(ctx);
+	hash = cacheHash(setter, config, input, len);
+	e = cacheSlot(ctx, hash);
+
+	if (e->hash != hash || e->config != config || e->setter != setter ||
+	    e->inputLen != len || memcmp(e->input, input, len) != 0) {
+		ctx->cacheMisses++;
+		return false;
+	}
+
+	ctx->cacheHits++;
+
+	memcpy(ctx->dataStr, e->buf, e->dataStrLen);
+	ctx->dataStr[e->dataStrLen] = '\0';
+	memcpy(ctx->dlAIbuffer, e->buf + e->dataStrLen + 1, e->dlAIbufferLen);
+	ctx->dlAIbuffer[e->dlAIbufferLen] = '\0';
+	ctx->extDataStr = NULL;
+
+	ctx->numAIs = e->numAIs;
+	for (i = 0; i < e->numAIs; i++) {
+		const struct cacheAI* const a = &e->aiData[i];
+		ctx->aiData[i] = (struct aiValue) {
+			.aiEntry = a->aiEntry,
+			.ai = cachePointer(ctx, a->aiOff, e->dataStrLen),
+			.ailen = a->ailen,
+			.value = cachePointer(ctx, a->valueOff, e->dataStrLen),
+			.vallen = a->vallen,
+			.kind = (aiValueKind_t)a->kind,
+			.dlPathOrder = a->dlPathOrder,
+		};
+	}
+
+	if (setter == cache_SCAN_DATA)
+		ctx->sym = e->sym;
+
+	if (!e->ok) {
+		ctx->err = e->err;
+		ctx->err.formatted = false;
+		ctx->linterErr = e->linterErr;
+	}
+
+	*ok = e->ok;
+	return true;
+
+}
+
+
+/*
+ *  Position of a pointer within the copies of dataStr and dlAIbuffer, or
+ *  false if it lies outside of them.
+ *
+ */
+static bool cacheOffset(const gs1_encoder* const ctx, const char* const p, const size_t dataStrLen, const size_t dlAIbufferLen, uint16_t* const off) {
+
+	if (!p)
+		*off = CACHE_NO_DATA;
+	else if (p >= ctx->dataStr && p <= ctx->dataStr + dataStrLen)
+		*off = (uint16_t)(p - ctx->dataStr);
+	else if (p >= ctx->dlAIbuffer && p <= ctx->dlAIbuffer + dlAIbufferLen)
+		*off = (uint16_t)((size_t)(p - ctx->dlAIbuffer) + dataStrLen + 1);
+	else
+		return false;
+
+	return true;
+
+}
+
+
+/*
+ *  Record the state left by the setter having processed the input, replacing
+ *  whatever occupied the slot. Inputs that leave state that cannot be
+ *  captured are not cached.
+ *
+ */
+void gs1_cacheStore(gs1_encoder* const ctx, const cacheSetter_t setter, const char* const input, const size_t len, const bool ok) {
+
+	struct gs1_cacheEntry *e;
+	size_t dataStrLen, dlAIbufferLen;
+	uint32_t config;
+	uint64_t hash;
+	int i;
+
+	assert(ctx);
+	assert(input || len == 0);
+
+	if (!cacheEligible(ctx, input, len))
+		return;
+
+	if ((dataStrLen = strlen(ctx->dataStr)) > CACHE_MAX_DATA ||
+	    (dlAIbufferLen = strlen(ctx->dlAIbuffer)) > CACHE_MAX_DATA)
+		return;
+
+	config = cacheConfig(ctx);
+	hash = cacheHash(setter, config, input, len);
+	e = cacheSlot(ctx, hash);
+	e->hash = 0;					// Invalid until complete
+
+	for (i = 0; i < ctx->numAIs; i++) {
+		const struct aiValue* const ai = &ctx->aiData[i];
+		struct cacheAI* const a = &e->aiData[i];
+		if (!cacheOffset(ctx, ai->ai, dataStrLen, dlAIbufferLen, &a->aiOff) ||
+		    !cacheOffset(ctx, ai->value, dataStrLen, dlAIbufferLen, &a->valueOff))
+			return;
+		a->aiEntry = ai->aiEntry;
+		a->ailen = ai->ailen;
+		a->vallen = ai->vallen;
+		a->kind = (uint8_t)ai->kind;
+		a->dlPathOrder = ai->dlPathOrder;
+	}
+	e->numAIs = ctx->numAIs;
+
+	memcpy(e->buf, ctx->dataStr, dataStrLen + 1);
+	memcpy(e->buf + dataStrLen + 1, ctx->dlAIbuffer, dlAIbufferLen + 1);
+	e->dataStrLen = (uint16_t)dataStrLen;
+	e->dlAIbufferLen = (uint16_t)dlAIbufferLen;
+
+	memcpy(e->input, input, len);
+	e->inputLen = (uint16_t)len;
+	e->config = config;
+	e->setter = (uint8_t)setter;
+	e->ok = ok;
+	e->sym = ctx->sym;
+	if (!ok) {
+		e->err = ctx->err;
+		e->linterErr = ctx->linterErr;
+	}
+	e->hash = hash;
+
+}
+
+
+#ifdef UNIT_TESTS
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+
+void test_cache_hits(void) {
+
+	gs1_encoder* ctx;
+	size_t hits, misses;
+	char hri[256], uri[256];
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_CHECK(gs1_encoder_getCacheSize(ctx) == 0);			// Default
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333(10)ABC"));
+	gs1_encoder_getCacheStats(ctx, &hits, &misses);
+	TEST_CHECK(hits == 0 && misses == 0);
+
+	TEST_ASSERT(gs1_encoder_setCacheSize(ctx, 8));
+	TEST_CHECK(gs1_encoder_getCacheSize(ctx) == 8);
+
+	// AI data
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333(10)ABC|(99)XYZ"));
+	gs1_encoder_renderHRI(ctx, hri, sizeof(hri));
+	gs1_encoder_renderDLuri(ctx, NULL, uri, sizeof(uri));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333"));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333(10)ABC|(99)XYZ"));
+	gs1_encoder_getCacheStats(ctx, &hits, &misses);
+	TEST_CHECK(hits == 1 && misses == 2);
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^011231231231233310ABC|^99XYZ") == 0);
+	{
+		char hri2[256], uri2[256];
+		gs1_encoder_renderHRI(ctx, hri2, sizeof(hri2));
+		gs1_encoder_renderDLuri(ctx, NULL, uri2, sizeof(uri2));
+		TEST_CHECK(strcmp(hri, hri2) == 0);
+		TEST_MSG("Expected: %s; Got: %s", hri, hri2);
+		TEST_CHECK(strcmp(uri, uri2) == 0);
+		TEST_MSG("Expected: %s; Got: %s", uri, uri2);
+	}
+
+	// DL URI, with AIs in the dlAIbuffer and ignored query parameters in the dataStr
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "https://a/01/12312312312333/10/ABC?x=y&99=XYZ"));
+	gs1_encoder_renderHRI(ctx, hri, sizeof(hri));
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "https://a/01/12312312312333/10/ABC?x=y&99=XYZ"));
+	{
+		char hri2[256];
+		gs1_encoder_renderHRI(ctx, hri2, sizeof(hri2));
+		TEST_CHECK(strcmp(hri, hri2) == 0);
+		TEST_MSG("Expected: %s; Got: %s", hri, hri2);
+	}
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(01)12312312312333(10)ABC(99)XYZ") == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getAIdataStr(ctx));
+	{
+		char **qp;
+		TEST_CHECK(gs1_encoder_getDLignoredQueryParams(ctx, &qp) == 1);
+		TEST_CHECK(strcmp(qp[0], "x=y") == 0);
+	}
+
+	// Failures are cached along with the error
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901234"));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333"));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901234"));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "AI (01): The numeric check digit is incorrect.") == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getErrMsg(ctx));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMarkup(ctx), "(01)1234567890123|4|") == 0);
+	TEST_CHECK(gs1_encoder_getAIdataStr(ctx) == NULL);
+
+	// Scan data restores the symbology
+	TEST_CHECK(gs1_encoder_setScanData(ctx, "]e0011231231231233310ABC"));
+	TEST_CHECK(gs1_encoder_setSym(ctx, gs1_encoder_sNONE));
+	TEST_CHECK(gs1_encoder_setScanData(ctx, "]e0011231231231233310ABC"));
+	TEST_CHECK(gs1_encoder_getSym(ctx) == gs1_encoder_sDataBarExpanded);
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^011231231231233310ABC") == 0);
+
+	gs1_encoder_getCacheStats(ctx, &hits, &misses);
+	TEST_CHECK(hits == 5 && misses == 5);
+	TEST_MSG("Hits: %d; Misses: %d", (int)hits, (int)misses);
+
+	// Disabling the cache releases it
+	TEST_CHECK(gs1_encoder_setCacheSize(ctx, 0));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333"));
+	gs1_encoder_getCacheStats(ctx, &hits, &misses);
+	TEST_CHECK(hits == 0 && misses == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_cache_config(void) {
+
+	gs1_encoder* ctx;
+	size_t hits, misses;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_ASSERT(gs1_encoder_setCacheSize(ctx, 4));
+
+	// The outcome depends on the settings
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(89)ABC"));
+	TEST_CHECK(gs1_encoder_setPermitUnknownAIs(ctx, true));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(89)ABC"));
+	TEST_CHECK(gs1_encoder_setPermitUnknownAIs(ctx, false));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(89)ABC"));
+
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(21)ABC"));
+	TEST_CHECK(gs1_encoder_setValidationEnabled(ctx, gs1_encoder_vREQUISITE_AIS, false));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(21)ABC"));
+	TEST_CHECK(gs1_encoder_setValidationEnabled(ctx, gs1_encoder_vREQUISITE_AIS, true));
+
+	// The same input given to different setters
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "(21)ABC"));		// Non-GS1 data
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "(21)ABC") == 0);
+	TEST_CHECK(gs1_encoder_getAIdataStr(ctx) == NULL);
+
+	// Collecting errors bypasses the cache
+	TEST_CHECK(gs1_encoder_setCollectErrors(ctx, true));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(21)ABC"));
+	TEST_CHECK(gs1_encoder_getErrRecords(ctx, NULL) == 1);
+	TEST_CHECK(gs1_encoder_setCollectErrors(ctx, false));
+
+	// Input that is too long is not cached
+	TEST_CHECK(gs1_encoder_setDataStr(ctx,
+		"^9912345678901234567890123456789012345678901234567890123456789012345678901234567890123456789"
+		"^9112345678901234567890123456789012345678901234567890123456789012345678901234567890123456789"
+		"^9212345678901234567890123456789012345678901234567890123456789012345678901234567890123456789"));
+
+	gs1_encoder_getCacheStats(ctx, &hits, &misses);
+	TEST_CHECK(hits == 1 && misses == 5);
+	TEST_MSG("Hits: %d; Misses: %d", (int)hits, (int)misses);
+
+	gs1_encoder_free(ctx);
+
+}
+
+#endif  /* UNIT_TESTS */
@@ -0,0 +1,53 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "gs1encoders.h"
+
+
+#define CACHE_MAX_DATA	255		// Longest input, and resulting data, whose outcome is cached
+
+
+typedef enum {
+	cache_DATA_STR,
+	cache_AI_DATA_STR,
+	cache_SCAN_DATA,
+} cacheSetter_t;
+
+
+bool gs1_cacheResize(gs1_encoder *ctx, int entries);
+bool gs1_cacheLookup(gs1_encoder *ctx, cacheSetter_t setter, const char *input, size_t len, bool *ok);
+void gs1_cacheStore(gs1_encoder *ctx, cacheSetter_t setter, const char *input, size_t len, bool ok);
+
+
+#ifdef UNIT_TESTS
+
+void test_cache_hits(void);
+void test_cache_config(void);
+
+#endif
+
+
+#endif  /* CACHE_H */
@@ -24,9 +24,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-#include <ctype.h>
 
 #include "syntax/gs1syntaxdictionary.h"
+#include "syntax/gs1syntaxdictionary-utils.h"
 #include "gs1encoders.h"
 #include "enc-private.h"
 #include "debug.h"
@@ -38,18 +38,29 @@
 
 
 /*
- *  Set of characters that are permissible in URIs, including percent
+ *  Character classes for processing URIs, by table lookup: the characters
+ *  that are permissible in URIs, including percent; the subset of them that
+ *  delimit the path segments, query and fragment; the unreserved characters
+ *  that do not require escaping when used in URI components (path elements
+ *  and query parameter values); and the hex digits of percent escapes.
  *
  */
-static const char *uriCharacters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~:/?#[]@!$&'()*+,;=%";
-
-
-/*
- *  Set of unreserved characters that do not require escaping when used in URI
- *  components (path elements and query parameter values)
- *
- */
-static const char *uriUnreservedCharacters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~";
+#define URI_CHAR	0x01
+#define URI_DELIM	0x02
+#define URI_UNRESERVED	0x04
+#define URI_HEXDIGIT	0x08
+
+static const uint8_t uriCharClass[256] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	/* 0x00 */
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	/* 0x10 */
+	0x00, 0x01, 0x00, 0x03, 0x01, 0x01, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x05, 0x05, 0x03,	/* 0x20 */
+	0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x01, 0x01, 0x00, 0x01, 0x00, 0x03,	/* 0x30 */
+	0x01, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,	/* 0x40 */
+	0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x01, 0x00, 0x01, 0x00, 0x05,	/* 0x50 */
+	0x00, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,	/* 0x60 */
+	0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x05, 0x00,	/* 0x70 */
+	/* 0x80 - 0xff are not permitted */
+};
 
 
 /*
@@ -60,7 +71,7 @@ static const char *uriUnreservedCharacters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefgh
  *  array of space-separated AI sequences which we can efficiently search.
  *
  */
-static bool addDLkeyQualifiers(gs1_encoder* const ctx, char*** const dlKeyQualifiers, size_t* const pos, size_t* const cap, const char* const key, const char* const qualifiers) {
+static bool addDLkeyQualifiers(gs1_syntax_dictionary* const sd, char*** const dlKeyQualifiers, size_t* const pos, size_t* const cap, const char* const key, const char* const qualifiers) {
 
 	int i, j, num;
 	size_t req;
@@ -88,7 +99,7 @@ static bool addDLkeyQualifiers(gs1_encoder* const ctx, char*** const dlKeyQualif
 	if (*pos + req >= *cap) {
 		char **reallocDLkeyQualifiers = realloc(*dlKeyQualifiers, (*pos + req) * sizeof(char *));
 		if (!reallocDLkeyQualifiers) {
-			strcpy(ctx->errMsg, "Failed to reallocate memory for key-qualifiers");
+			strcpy(sd->errMsg, "Failed to reallocate memory for key-qualifiers");
 			return false;
 		}
 		*dlKeyQualifiers = reallocDLkeyQualifiers;
@@ -138,14 +149,14 @@ static int q_cmp(const void* const a, const void* const b) {
 	return strcmp(*(const char**)a, *(const char**)b);
 }
 
-bool gs1_populateDLkeyQualifiers(gs1_encoder* const ctx) {
+bool gs1_populateDLkeyQualifiers(gs1_syntax_dictionary* const sd) {
 
 	int i = 0;
 	size_t pos = 0, cap = DL_KEY_QUALIFIER_INITIAL_CAPACITY;
 
 	char **dlKeyQualifiers = malloc(cap * sizeof(char *));
 	if (!dlKeyQualifiers) {
-		strcpy(ctx->errMsg, "Failed to allocate memory for key-qualifiers");
+		strcpy(sd->errMsg, "Failed to allocate memory for key-qualifiers");
 		return false;
 	}
 
@@ -153,19 +164,19 @@ bool gs1_populateDLkeyQualifiers(gs1_encoder* const ctx) {
 	 *  Parse "dlpkey" attribute
 	 *
 	 */
-	for (i = 0; i < (int)ctx->aiTableEntries; i++) {
+	for (i = 0; i < (int)sd->aiTableEntries; i++) {
 
 		const char *token;
 		char *saveptr = NULL;
 		char attrs[MAX_AI_ATTR_LEN + 1] = { 0 };
 
-		strncat(attrs, ctx->aiTable[i].attrs, MAX_AI_ATTR_LEN);
+		strncat(attrs, sd->aiTable[i].attrs, MAX_AI_ATTR_LEN);
 		for (token = strtok_r(attrs, " ", &saveptr);
 		     token;
 		     token = strtok_r(NULL, " ", &saveptr)) {
 			if (strcmp(token, "dlpkey") == 0) {
-				if (!addDLkeyQualifiers(ctx, &dlKeyQualifiers,
-							&pos, &cap, ctx->aiTable[i].ai, ""))
+				if (!addDLkeyQualifiers(sd, &dlKeyQualifiers,
+							&pos, &cap, sd->aiTable[i].ai, ""))
 					goto fail;
 			} else if (strncmp(token, "dlpkey=", 7) == 0) {
 
@@ -174,8 +185,8 @@ bool gs1_populateDLkeyQualifiers(gs1_encoder* const ctx) {
 				for (token = strtok_r((char*)(token+7), "|", &saveptr2);
 				     token;
 				     token = strtok_r(NULL, " ", &saveptr2))
-					if (!addDLkeyQualifiers(ctx, &dlKeyQualifiers,
-							&pos, &cap, ctx->aiTable[i].ai, token))
+					if (!addDLkeyQualifiers(sd, &dlKeyQualifiers,
+							&pos, &cap, sd->aiTable[i].ai, token))
 						goto fail;
 
 			}
@@ -189,8 +200,13 @@ bool gs1_populateDLkeyQualifiers(gs1_encoder* const ctx) {
 	 */
 	qsort(dlKeyQualifiers, pos, sizeof(dlKeyQualifiers[0]), q_cmp);
 
-	ctx->dlKeyQualifiers = dlKeyQualifiers;
-	ctx->numDLkeyQualifiers = (int)pos;
+	sd->dlKeyQualifiers = dlKeyQualifiers;
+	sd->numDLkeyQualifiers = (int)pos;
+
+	if (!gs1_compileDLkeyQualifiers(sd)) {
+		gs1_freeDLkeyQualifiers(sd);
+		return false;
+	}
 
 	return true;
 
@@ -209,90 +225,231 @@ fail:
 }
 
 
-void gs1_freeDLkeyQualifiers(gs1_encoder* const ctx) {
+/*
+ *  Build a trie of the valid DL key-qualifier sequences over AI table
+ *  positions, so that a sequence of AIs can be validated, and the positions
+ *  at which an AI could be inserted into it can be found, by walking the trie
+ *  rather than by formatting and searching for strings.
+ *
+ */
+bool gs1_compileDLkeyQualifiers(gs1_syntax_dictionary* const sd) {
 
+	struct dlTrieNode *nodes;
+	size_t maxNodes = 1, numNodes = 1;
 	int i;
 
-	assert(ctx);
+	assert(sd);
+	assert(!sd->dlTrie);
+
+	// Each AI of each sequence adds at most one node
+	for (i = 0; i < sd->numDLkeyQualifiers; i++) {
+		const char *p;
+		for (p = sd->dlKeyQualifiers[i]; *p; p++)
+			if (*p == ' ')
+				maxNodes++;
+		maxNodes++;
+	}
+
+	if (maxNodes > UINT16_MAX) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "AI table is broken: too many key-qualifier sequences");
+		return false;
+	}
+
+	nodes = malloc(maxNodes * sizeof(struct dlTrieNode));
+	if (!nodes) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Failed to allocate the key-qualifier trie");
+		return false;
+	}
+	nodes[0] = (struct dlTrieNode){ .ai = 0, .child = 0, .sibling = 0, .entry = -1 };
+
+	for (i = 0; i < sd->numDLkeyQualifiers; i++) {
+
+		const char *p = sd->dlKeyQualifiers[i];
+		uint16_t node = 0;
+
+		while (*p) {
+
+			const size_t len = strcspn(p, " ");
+			const int pos = gs1_aiTablePosition(sd, p, len);
+			uint16_t *link;
 
-	if (!ctx->dlKeyQualifiers)
+			// A sequence including an AI that is not in the table can
+			// never be matched
+			if (pos == -1)
+				goto next;
+
+			link = &nodes[node].child;
+			while (*link && nodes[*link].ai < pos)
+				link = &nodes[*link].sibling;
+
+			if (!*link || nodes[*link].ai != pos) {
+				assert(numNodes < maxNodes);
+				nodes[numNodes] = (struct dlTrieNode){ .ai = (uint16_t)pos, .child = 0, .sibling = *link, .entry = -1 };
+				*link = (uint16_t)numNodes++;
+			}
+			node = *link;
+
+			p += len;
+			if (*p == ' ')
+				p++;
+
+		}
+
+		// Keys with alternative sets of qualifiers appear more than
+		// once; refer to the first, from which the sorted sequences
+		// extending it follow
+		if (nodes[node].entry == -1)
+			nodes[node].entry = i;
+next:
+		;
+
+	}
+
+	sd->dlTrie = nodes;
+
+	return true;
+
+}
+
+
+void gs1_freeDLkeyQualifiers(gs1_syntax_dictionary* const sd) {
+
+	int i;
+
+	assert(sd);
+
+	free(sd->dlTrie);
+	sd->dlTrie = NULL;
+
+	if (!sd->dlKeyQualifiers)
 		return;
 
-	for (i = 0; i < ctx->numDLkeyQualifiers; i++)
-		free(ctx->dlKeyQualifiers[i]);
+	if (!sd->image)		// Otherwise the strings belong to the image
+		for (i = 0; i < sd->numDLkeyQualifiers; i++)
+			free(sd->dlKeyQualifiers[i]);
+
+	free(sd->dlKeyQualifiers);
+	sd->dlKeyQualifiers = NULL;
+	sd->numDLkeyQualifiers = 0;
+
+}
+
+
+/*
+ *  Position of an AI table entry, or -1 for the pseudo entry of a vivified AI
+ *
+ */
+static inline int aiEntryPosition(const gs1_syntax_dictionary* const sd, const struct aiEntry* const entry) {
 
-	free(ctx->dlKeyQualifiers);
-	ctx->dlKeyQualifiers = NULL;
+	const uintptr_t e = (uintptr_t)entry, t = (uintptr_t)sd->aiTable;
+
+	if (e < t || e >= (uintptr_t)(sd->aiTable + sd->aiTableEntries))
+		return -1;
+
+	return (int)((e - t) / sizeof(struct aiEntry));
 
 }
 
 
 /*
- *  Find an entry in the keyQualifier list matching the given AIs, returning
- *  the position in the list or -1 if missing
+ *  Trie node reached from the given node by the AI at the given AI table
+ *  position, or -1 if the sequence cannot be extended by that AI
  *
  */
-static int getDLpathAIseqEntry(gs1_encoder* const ctx, const char seq[MAX_AIS][MAX_AI_LEN+1], const int len) {
+static inline int dlTrieChild(const gs1_syntax_dictionary* const sd, const int node, const int pos) {
+
+	uint16_t c;
+
+	if (node == -1 || pos == -1)
+		return -1;
+
+	for (c = sd->dlTrie[node].child; c && sd->dlTrie[c].ai < pos; c = sd->dlTrie[c].sibling);
+
+	return c && sd->dlTrie[c].ai == pos ? c : -1;
 
-	char aiseq[(MAX_AI_LEN+1) * MAX_AIS] = { 0 };
-	char *p = aiseq;
+}
+
+static inline int dlTrieWalk(const gs1_syntax_dictionary* const sd, int node, const int* const seq, const int len) {
 	int i;
-	size_t s = 0;
-	size_t e = (size_t)ctx->numDLkeyQualifiers;
+	for (i = 0; i < len && node != -1; i++)
+		node = dlTrieChild(sd, node, seq[i]);
+	return node;
+}
 
-	/*
-	 *  Build a space separated AI sequence string
-	 *
-	 */
-	for (i = 0 ; i < len; i++) {
-		const int n = snprintf(p, sizeof(aiseq) - (size_t)(p - aiseq), "%s ", seq[i]);
-		assert(n >= 1 && n < (int)(sizeof(aiseq) - (size_t)(p - aiseq)));
-		p += n;
-	}
-	*--p = '\0';		// Chop stray space
+static inline bool isValidDLtrieNode(const gs1_syntax_dictionary* const sd, const int node) {
+	return node != -1 && sd->dlTrie[node].entry != -1;
+}
 
-	/*
-	 *  Binary search for string in the list of valid key-qualifier
-	 *  associations.
-	 *
-	 */
-	while (s < e) {
-		const size_t m = s + (e - s) / 2;
-		const int cmp = strcmp(ctx->dlKeyQualifiers[m], aiseq);
-		if (cmp == 0)
-			return (int)m;
-		if (cmp < 0)
-			s = m + 1;
-		else
-			e = m;
+static inline bool isDLpkey(const gs1_syntax_dictionary* const sd, const struct aiEntry* const entry) {
+	return isValidDLtrieNode(sd, dlTrieChild(sd, 0, aiEntryPosition(sd, entry)));
+}
+
+
+/*
+ *  Length of the initial run of unreserved characters in s, up to len
+ *  characters. Where vector support is available whole 16-byte blocks are
+ *  first skipped, and the exact end of the run is then found by table lookup.
+ *
+ */
+static inline size_t uriUnreservedSpan(const char* const s, const size_t len) {
+
+	size_t i = 0;
+
+#ifdef GS1_CSET_SIMD
+	while (len - i >= 16) {
+		const gs1_cset_vec_t v = GS1_CSET_LOAD(s + i);
+		const gs1_cset_vec_t m =
+			GS1_CSET_OR(GS1_CSET_OR(GS1_CSET_OR(gs1_cset_range(v, '-', '.'),
+							    gs1_cset_range(v, '0', '9')),
+						GS1_CSET_OR(gs1_cset_range(v, 'A', 'Z'),
+							    gs1_cset_range(v, '_', '_'))),
+				    GS1_CSET_OR(gs1_cset_range(v, 'a', 'z'),
+						gs1_cset_range(v, '~', '~')));
+		if (!GS1_CSET_ALL(m))
+			break;
+		i += 16;
 	}
+#endif
 
-	return -1;
+	while (i < len && (uriCharClass[(uint8_t)s[i]] & URI_UNRESERVED))
+		i++;
 
-}
+	return i;
 
-static inline bool isValidDLpathAIseq(gs1_encoder* const ctx, const char seq[MAX_AIS][MAX_AI_LEN+1], const int len) {
-	return getDLpathAIseqEntry(ctx, seq, len) != -1;
 }
 
-static inline bool isDLpkey(gs1_encoder* const ctx, const char* const p) {
-	char seq[MAX_AIS][MAX_AI_LEN+1] = { { 0 } };
-	strcpy(seq[0], p);
-	return getDLpathAIseqEntry(ctx, (const char(*)[MAX_AI_LEN+1])seq, 1) != -1;
+
+/*
+ *  Value of a character that is known to be a hex digit: its low nibble, plus
+ *  nine for letters, which alone have bit 6 set.
+ *
+ */
+static inline uint8_t hexValue(const char c) {
+	return (uint8_t)(((uint8_t)c & 0x0F) + ((uint8_t)c >> 6) * 9);
 }
 
 
 static size_t URIunescape(char* const out, size_t maxlen, const char* const in, const size_t inlen, const bool is_query_component) {
 
-	size_t i, j;
+	size_t i = 0, j = 0, n;
 
 	assert(in);
 	assert(out);
 
-	for (i = 0, j = 0; i < inlen && j < maxlen; i++, j++) {
-		if (i < inlen - 2 && in[i] == '%' && isxdigit(in[i+1]) && isxdigit(in[i+2])) {
-			const char hex[] = { in[i+1], in[i+2], '\0' };
-			out[j] = (char)strtoul(hex, NULL, 16);
+	while (i < inlen && j < maxlen) {
+
+		// Copy any run of unreserved characters in bulk
+		n = uriUnreservedSpan(&in[i], inlen - i < maxlen - j ? inlen - i : maxlen - j);
+		memcpy(&out[j], &in[i], n);
+		i += n;
+		j += n;
+		if (i == inlen || j == maxlen)
+			break;
+
+		if (in[i] == '%' && i + 2 < inlen &&
+		    (uriCharClass[(uint8_t)in[i+1]] & URI_HEXDIGIT) &&
+		    (uriCharClass[(uint8_t)in[i+2]] & URI_HEXDIGIT)) {
+			out[j] = (char)(hexValue(in[i+1]) << 4 | hexValue(in[i+2]));
 			if (out[j] == 0)	// Illegal null
 				return 0;
 			i += 2;
@@ -300,6 +457,9 @@ static size_t URIunescape(char* const out, size_t maxlen, const char* const in,
 			out[j] = ' ';
 		else
 			out[j] = in[i];
+		i++;
+		j++;
+
 	}
 	out[j] = '\0';
 
@@ -308,24 +468,38 @@ static size_t URIunescape(char* const out, size_t maxlen, const char* const in,
 }
 
 
+static const char hexDigits[] = "0123456789ABCDEF";
+
 static size_t URIescape(char* const out, const size_t maxlen, const char* const in, const size_t inlen, const bool is_query_component) {
 
-	size_t i, j;
+	size_t i = 0, j = 0, n;
 
 	assert(in);
 	assert(out);
 
-	for (i = 0, j = 0; i < inlen && j < maxlen; i++) {
-		if (strchr(uriUnreservedCharacters, in[i]))
-			out[j++] = in[i];
-		else if (in[i] == ' ' && is_query_component)
+	while (i < inlen && j < maxlen) {
+
+		// Copy any run of unreserved characters in bulk
+		n = uriUnreservedSpan(&in[i], inlen - i < maxlen - j ? inlen - i : maxlen - j);
+		memcpy(&out[j], &in[i], n);
+		i += n;
+		j += n;
+		if (i == inlen || j == maxlen)
+			break;
+
+		if (in[i] == ' ' && is_query_component)
 			out[j++] = '+';
 //		else if (in[i] == '+' && !is_query_component)		// Encoding '+' as '%2d' in path info is preferred
 //			out[j++] = '+';
-		else if (j+2 < maxlen)
-			j += (size_t)snprintf(&out[j], 4, "%%%02X", in[i]);
+		else if (j+2 < maxlen) {
+			out[j++] = '%';
+			out[j++] = hexDigits[(uint8_t)in[i] >> 4];
+			out[j++] = hexDigits[(uint8_t)in[i] & 0x0F];
+		}
 		else
 			break;		/* Out of space */
+		i++;
+
 	}
 	out[j] = '\0';
 
@@ -334,123 +508,197 @@ static size_t URIescape(char* const out, const size_t maxlen, const char* const
 }
 
 
+/*
+ *  Offsets of the delimiters of a DL URI, as found by tokenizeDLuri(). The
+ *  path info begins with the first "/" following the domain and consists of
+ *  numSegs segments, each beginning with the "/" at off[i]. The query params
+ *  begin at qp and are separated by the numAmps "&" that follow in off[].
+ *
+ */
+struct dlTokens {
+	size_t pe;				// End of path info
+	size_t qp;				// Start of query params, or 0 if none
+	size_t qe;				// End of query params
+	size_t fr;				// Start of fragment, or 0 if none
+	int numSegs;
+	int numAmps;
+	uint16_t off[MAX_DATA];			// Segments, followed by "&" separators
+};
+
+
+/*
+ *  Validate the characters of a DL URI and locate its delimiters in a single
+ *  forward scan. The scheme has already been matched and is skipped.
+ *
+ */
+static bool tokenizeDLuri(gs1_encoder* const ctx, const char* const dlData, const size_t len, const size_t schemeLen, struct dlTokens* const t) {
+
+	enum { IN_DOMAIN, IN_PATH, IN_QUERY, IN_FRAGMENT } state = IN_DOMAIN;
+	size_t i;
+
+	assert(len <= MAX_DATA);
+
+	t->pe = t->qe = len;
+	t->qp = t->fr = 0;
+	t->numSegs = t->numAmps = 0;
+
+	for (i = 0; i < len; i++) {
+
+		const uint8_t cls = uriCharClass[(uint8_t)dlData[i]];
+
+		if (!cls) {
+			gs1_setErr(ctx, gs1_encoder_eDL_ILLEGAL_CHARACTERS);
+			return false;
+		}
+
+		if (cls & URI_DELIM) {
+			if (i < schemeLen)
+				continue;
+			switch (dlData[i]) {
+			case '/':
+				if (state == IN_DOMAIN)
+					state = IN_PATH;
+				if (state == IN_PATH)
+					t->off[t->numSegs++] = (uint16_t)i;
+				break;
+			case '?':
+				if (state == IN_PATH) {
+					t->pe = i;
+					t->qp = i + 1;
+					state = IN_QUERY;
+				}
+				break;
+			case '&':
+				if (state == IN_QUERY)
+					t->off[t->numSegs + t->numAmps++] = (uint16_t)i;
+				break;
+			default:
+				assert(dlData[i] == '#');
+				if (state == IN_PATH || state == IN_QUERY) {
+					if (state == IN_PATH)
+						t->pe = i;
+					t->qe = i;
+					t->fr = i + 1;
+					state = IN_FRAGMENT;
+				}
+				break;
+			}
+		}
+
+	}
+
+	return true;
+
+}
+
+
 /*
  * Parse a GS1 DL URI, validating the key to key-qualifier associations in the
  * path information, and convert it to a regular AI data string with ^ = FNC1,
  * extracting AI data for HRI purposes.
  *
+ * The URI is delimited by its length, need not be NUL-terminated and is never
+ * written to. Ignored query parameters refer to the URI, which must therefore
+ * remain intact while the extracted AI data is in use.
+ *
  * Note: "Convenience alphas" (e.g. "/gtin/0123...", which have been
  * deprecated) are not supported.
  *
  */
-bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const dataStr) {
+bool gs1_parseDLuriN(gs1_encoder* const ctx, const char* const dlData, const size_t len, char* const dataStr) {
 
-	char* p, *r;
-	const char* pi = NULL;	// Path info
-	char* qp = NULL;	// Query params
-	char* fr = NULL;	// Fragment
-	const char* dp = NULL;	// DL path info
+	const char *p, *r;
+	const char* pe;		// End of path info
+	const char* qp = NULL;	// Query params
+	const char* qe;		// End of query params
+	int dp = -1;		// Segment that begins the DL path info
 	bool ret;
 	bool fnc1req = true;
-	char pathAIseq[MAX_AIS][MAX_AI_LEN+1] = { { 0 } };	// Sequence of AIs extracted from the path info
+	int pathAIpos[MAX_AIS];		// AI table positions of the AIs extracted from the path info
+	int pathNode[MAX_AIS + 1];	// Key-qualifier trie node reached by each prefix of them
 	int numPathAIs;
+	size_t schemeLen;
+	int i;
+	struct gs1_writer out;
+	struct dlTokens t;
 
 	assert(ctx);
-	assert(dlData);
+	assert(dlData || len == 0);
 
-	*dataStr = '\0';
-	*ctx->errMsg = '\0';
-	ctx->linterErr = GS1_LINTER_OK;
-	*ctx->linterErrMarkup = '\0';
+	gs1_writerInit(&out, dataStr, MAX_DATA);
+	gs1_clearErr(ctx);
 
-	DEBUG_PRINT("\nParsing DL data: %s\n", dlData);
+	DEBUG_PRINT("\nParsing DL data: %.*s\n", (int)len, dlData);
 
-	p = dlData;
+	if (len >= 8 && (memcmp(dlData, "https://", 8) == 0 || memcmp(dlData, "HTTPS://", 8) == 0))
+		schemeLen = 8;
+	else if (len >= 7 && (memcmp(dlData, "http://", 7) == 0 || memcmp(dlData, "HTTP://", 7) == 0))
+		schemeLen = 7;
+	else
+		schemeLen = 0;
 
-	if (strspn(p, uriCharacters) != strlen(p)) {
-		strcpy(ctx->errMsg, "URI contains illegal characters");
+	if (len > MAX_DATA) {
+		gs1_setErr(ctx, gs1_encoder_eDATA_TOO_LONG);
 		goto fail;
 	}
 
-	if (strlen(p) >= 8 && strncmp(p, "https://", 8) == 0)
-		p += 8;
-	else if (strlen(p) >= 8 && strncmp(p, "HTTPS://", 8) == 0)
-		p += 8;
-	else if (strlen(p) >= 7 && strncmp(p, "http://", 7) == 0)
-		p += 7;
-	else if (strlen(p) >= 7 && strncmp(p, "HTTP://", 7) == 0)
-		p += 7;
-	else {
-		strcpy(ctx->errMsg, "Scheme must be http:// or HTTP:// or https:// or HTTPS://");
+	// Illegal characters are reported in preference to a bad scheme
+	if (!tokenizeDLuri(ctx, dlData, len, schemeLen, &t))
 		goto fail;
-	}
-
-	DEBUG_PRINT("  Scheme %.*s\n", (int)(p-dlData-3), dlData);
 
-	if (((r = strchr(p, '/')) == NULL) || r-p < 1) {
-		strcpy(ctx->errMsg, "URI must contain a domain and path info");
+	if (schemeLen == 0) {
+		gs1_setErr(ctx, gs1_encoder_eDL_BAD_SCHEME);
 		goto fail;
 	}
 
-	DEBUG_PRINT("  Domain: %.*s\n", (int)(r-p), p);
+	DEBUG_PRINT("  Scheme %.*s\n", (int)(schemeLen-3), dlData);
 
-	pi = p = r;					// Skip the domain name
+	if (t.numSegs == 0 || t.off[0] == schemeLen) {
+		gs1_setErr(ctx, gs1_encoder_eDL_NO_PATH_INFO);
+		goto fail;
+	}
 
-	// Fragment character delimits end of data
-	if ((fr = strchr(pi, '#')) != NULL)
-		*fr++ = '\0';
+	DEBUG_PRINT("  Domain: %.*s\n", (int)(t.off[0]-schemeLen), dlData + schemeLen);
 
-	// Query parameter marker delimits end of path info
-	if ((qp = strchr(pi, '?')) != NULL)
-		*qp++ = '\0';
+	pe = dlData + t.pe;
+	qe = dlData + t.qe;
+	if (t.qp)
+		qp = dlData + t.qp;
 
-	DEBUG_PRINT("  Path info: %s\n", pi);
+	DEBUG_PRINT("  Path info: %.*s\n", (int)(t.pe-t.off[0]), dlData + t.off[0]);
 
 	// Search backwards from the end of the path info looking for an
 	// "/AI/value" pair where AI is a DL primary key
-	while ((r = strrchr(pi, '/')) != NULL) {
+	for (i = t.numSegs - 2; i >= 0; i -= 2) {
 
 		const struct aiEntry* entry;
 
-		*p = '/';				// Restore original pair separator
-							// Clobbers first character of path
-							// info on first iteration
-
-		// Find start of AI
-		*r = '\0';				// Chop off value
-		p = strrchr(pi, '/'); 			// Beginning of AI
-		*r = '/';				// Restore original AI/value separator
-		if (!p)					// At beginning of path
-			break;
-
-		DEBUG_PRINT("      %s\n", p);
+		DEBUG_PRINT("      %.*s\n", (int)(t.pe-t.off[i]), dlData + t.off[i]);
 
-		entry = gs1_lookupAIentry(ctx, p+1, (size_t)(r-p-1));
+		entry = gs1_lookupAIentry(ctx, dlData + t.off[i] + 1, (size_t)(t.off[i+1] - t.off[i] - 1));
 		if (!entry)
 			break;
 
-		if (isDLpkey(ctx, entry->ai)) {		// Found root of DL path info
-			dp = p;
+		if (isDLpkey(ctx->sd, entry)) {		// Found root of DL path info
+			dp = i;
 			break;
 		}
 
-		*p = '\0';
-
 	}
 
-	if (!dp) {
-		strcpy(ctx->errMsg, "No GS1 DL keys found in path info");
+	if (dp == -1) {
+		gs1_setErr(ctx, gs1_encoder_eDL_NO_KEYS);
 		goto fail;
 	}
 
-	DEBUG_PRINT("  Stem: %.*s\n", (int)(dp-dlData), dlData);
+	DEBUG_PRINT("  Stem: %.*s\n", (int)t.off[dp], dlData);
 
-	DEBUG_PRINT("  DL path info: %s\n", dp);
+	DEBUG_PRINT("  DL path info: %.*s\n", (int)(t.pe-t.off[dp]), dlData + t.off[dp]);
 
 	// Process each AI value pair in the DL path info
-	p = (char*)dp;
 	numPathAIs = 0;
-	while (*p) {
+	pathNode[0] = 0;
+	for (i = dp; i < t.numSegs; i += 2) {
 
 		const struct aiEntry* entry;
 		size_t ailen, vallen;
@@ -458,27 +706,25 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 		const char *outai, *outval;
 		const char *ai;
 
-		assert(*p == '/');
-		r = strchr(++p, '/');
-		assert(r);
+		assert(i + 1 < t.numSegs);
 
 		// AI is known to be valid since we previously walked over it
-		ai = p;
-		ailen = (size_t)(r-p);
+		ai = dlData + t.off[i] + 1;
+		ailen = (size_t)(t.off[i+1] - t.off[i] - 1);
 		entry = gs1_lookupAIentry(ctx, ai, ailen);
 		assert(entry);
 
-		if ((p = strchr(++r, '/')) == NULL)
-			p = r + strlen(r);
+		r = dlData + t.off[i+1] + 1;
+		p = i + 2 < t.numSegs ? dlData + t.off[i+2] : pe;
 
 		if (p == r) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) value path element is empty", (int)strlen(entry->ai), ai);
+			gs1_setErrForAI(ctx, gs1_encoder_eDL_PATH_VALUE_EMPTY, ai, strlen(entry->ai));
 			goto fail;
 		}
 
 		// Reverse percent encoding
 		if ((vallen = URIunescape(aival, MAX_AI_VALUE_LEN, r, (size_t)(p-r), false)) == 0) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Decoded AI (%.*s) from DL path info contains illegal null character", (int)ailen, ai);
+			gs1_setErrForAI(ctx, gs1_encoder_eDL_PATH_VALUE_ILLEGAL_NUL, ai, ailen);
 			goto fail;
 		}
 
@@ -496,11 +742,11 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 
 		if (fnc1req)
 			writeDataStr("^");			// Write FNC1, if required
-		outai = dataStr + strlen(dataStr);		// Save start of AI for AI data
+		outai = out.cur;				// Save start of AI for AI data
 		nwriteDataStr(ai, ailen);			// Write AI
 		fnc1req = entry->fnc1;				// Record if required before next AI
 
-		outval = dataStr + strlen(dataStr);		// Save start of value for AI data
+		outval = out.cur;				// Save start of value for AI data
 		nwriteDataStr(aival, vallen);			// Write value
 
 		// Perform certain checks at parse time, before processing the
@@ -510,7 +756,7 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 
 		// Update the AI data
 		if (ctx->numAIs >= MAX_AIS) {
-			strcpy(ctx->errMsg, "Too many AIs");
+			gs1_setErr(ctx, gs1_encoder_eTOO_MANY_AIS);
 			goto fail;
 		}
 
@@ -524,7 +770,8 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 			.dlPathOrder = (uint8_t)numPathAIs
 		};
 
-		strcpy(pathAIseq[numPathAIs], entry->ai);
+		pathAIpos[numPathAIs] = aiEntryPosition(ctx->sd, entry);
+		pathNode[numPathAIs + 1] = dlTrieChild(ctx->sd, pathNode[numPathAIs], pathAIpos[numPathAIs]);
 		numPathAIs++;
 
 	}
@@ -532,10 +779,9 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 	numPathAIs = ctx->numAIs;
 
 	if (qp)
-		DEBUG_PRINT("  Query params: %s\n", qp);
+		DEBUG_PRINT("  Query params: %.*s\n", (int)(qe-qp), qp);
 
-	p = qp;
-	while (p && *p) {
+	for (i = 0; qp && i <= t.numAmps; i++) {
 
 		const struct aiEntry* entry = NULL;
 		size_t ailen = 0, vallen;
@@ -544,10 +790,16 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 
 		aiValueKind_t kind = alValue_dlign;
 
-		while (*p == '&')				// Jump any & separators
-			p++;
-		if ((r = strchr(p, '&')) == NULL)
-			r = p + strlen(p);			// Value-pair finishes at end of data
+		// Value-pair runs to the next & separator or the end of data
+		p = i == 0 ? qp : dlData + t.off[t.numSegs + i - 1] + 1;
+		r = i < t.numAmps ? dlData + t.off[t.numSegs + i] : qe;
+
+		// Jump empty value-pairs, other than one following the final
+		// separator
+		if (p == r && i < t.numAmps)
+			continue;
+		if (p == r && t.numAmps == 0)
+			break;
 
 		// Discard parameters with no value
 		if ((e = memchr(p, '=', (size_t)(r-p))) == NULL) {
@@ -561,7 +813,7 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 		ai = p;
 		ailen = (size_t)(e-p);
 		if (gs1_allDigits((uint8_t*)p, ailen) && (entry = gs1_lookupAIentry(ctx, p, ailen)) == NULL) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Unknown AI (%.*s) in query parameters", (int)ailen, p);
+			gs1_setErrForAI(ctx, gs1_encoder_eDL_QUERY_AI_UNKNOWN, p, ailen);
 			goto fail;
 		}
 
@@ -574,13 +826,13 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 		}
 
 		if (r == ++e) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) value query element is empty", (int)strlen(entry->ai), ai);
+			gs1_setErrForAI(ctx, gs1_encoder_eDL_QUERY_VALUE_EMPTY, ai, strlen(entry->ai));
 			goto fail;
 		}
 
 		// Reverse percent encoding
 		if ((vallen = URIunescape(aival, MAX_AI_VALUE_LEN, e, (size_t)(r-e), true)) == 0) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Decoded AI (%.*s) value from DL query params contains illegal null character", (int)strlen(entry->ai), ai);
+			gs1_setErrForAI(ctx, gs1_encoder_eDL_QUERY_VALUE_ILLEGAL_NUL, ai, strlen(entry->ai));
 			goto fail;
 		}
 
@@ -598,11 +850,11 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 
 		if (fnc1req)
 			writeDataStr("^");			// Write FNC1, if required
-		outai = dataStr + strlen(dataStr);		// Save start of AI for AI data
+		outai = out.cur;				// Save start of AI for AI data
 		nwriteDataStr(ai, ailen);			// Write AI
 		fnc1req = entry->fnc1;				// Record if required before next AI
 
-		outval = dataStr + strlen(dataStr);		// Save start of value for AI data
+		outval = out.cur;				// Save start of value for AI data
 		nwriteDataStr(aival, vallen);			// Write value
 
 		// Perform certain checks at parse time, before processing the
@@ -615,7 +867,7 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 add_query_param_to_ai_data:
 
 		if (ctx->numAIs >= MAX_AIS) {
-			strcpy(ctx->errMsg, "Too many AIs");
+			gs1_setErr(ctx, gs1_encoder_eTOO_MANY_AIS);
 			goto fail;
 		}
 
@@ -629,12 +881,10 @@ add_query_param_to_ai_data:
 			.dlPathOrder = DL_PATH_ORDER_ATTRIBUTE
 		};
 
-		p = r;
-
 	}
 
-	if (fr)
-		DEBUG_PRINT("  Fragment: %s\n", fr);
+	if (t.fr)
+		DEBUG_PRINT("  Fragment: %.*s\n", (int)(len-t.fr), dlData + t.fr);
 
 	DEBUG_PRINT("Parsing DL data successful: %s\n", dataStr);
 
@@ -642,8 +892,8 @@ add_query_param_to_ai_data:
 
 	// Validate that the AI sequence in the path info is a valid
 	// key-qualifier association
-	if (!isValidDLpathAIseq(ctx, (const char(*)[MAX_AI_LEN+1])pathAIseq, numPathAIs)) {
-		strcpy(ctx->errMsg, "The AIs in the path are not a valid key-qualifier sequence for the key");
+	if (!isValidDLtrieNode(ctx->sd, pathNode[numPathAIs])) {
+		gs1_setErr(ctx, gs1_encoder_eDL_INVALID_KEY_QUALIFIERS);
 		ret = false;
 		goto out;
 	}
@@ -654,7 +904,6 @@ add_query_param_to_ai_data:
 		int i;
 		for (i = 0; i < ctx->numAIs; i++) {
 
-			char seq[MAX_AIS][MAX_AI_LEN+1] = { { 0 } };
 			const struct aiValue* const ai = &ctx->aiData[i];
 			int j;
 
@@ -669,7 +918,7 @@ add_query_param_to_ai_data:
 				if (ai2->kind == aiValue_aival &&
 				    ai2->ailen == ai->ailen &&
 				    memcmp(ai2->ai, ai->ai, ai2->ailen) == 0) {
-					snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) is duplicated", ai->ailen, ai->ai);
+					gs1_setErrForAI(ctx, gs1_encoder_eDL_AI_DUPLICATED, ai->ai, ai->ailen);
 					ret = false;
 					goto out;
 				}
@@ -678,22 +927,24 @@ add_query_param_to_ai_data:
 			// Check that the AI is a permitted DL URI data attribute
 			if (ai->aiEntry->dlDataAttr == NO_DATA_ATTR ||
 			    (ai->aiEntry->dlDataAttr == XX_DATA_ATTR && ctx->validationTable[gs1_encoder_vUNKNOWN_AI_NOT_DL_ATTR].enabled)) {
-				snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) is not a valid DL URI data attribute", ai->ailen, ai->ai);
+				if (ai->aiEntry->dlDataAttr == XX_DATA_ATTR)
+					STATS_VALIDATION_FAILURE(ctx, gs1_encoder_vUNKNOWN_AI_NOT_DL_ATTR);
+				gs1_setErrForAI(ctx, gs1_encoder_eDL_INVALID_ATTRIBUTE, ai->ai, ai->ailen);
 				ret = false;
 				goto out;
 			}
 
 			// Trial the AI at each non-initial position of the
 			// path info to see if it results in a valid
-			// key-qualifier sequence
+			// key-qualifier sequence, by inserting it after the
+			// trie node for the preceding AIs and walking the
+			// remainder
 			for (j = 1; j <= numPathAIs; j++) {
 
-				memcpy(&seq[0], &pathAIseq[0], (size_t)j * sizeof(seq[0]));
-				strcpy(seq[j], ai->aiEntry->ai);
-				memcpy(&seq[j+1], &pathAIseq[j], (size_t)(numPathAIs-j) * sizeof(seq[0]));
+				const int node = dlTrieChild(ctx->sd, pathNode[j], aiEntryPosition(ctx->sd, ai->aiEntry));
 
-				if (getDLpathAIseqEntry(ctx, (const char(*)[MAX_AI_LEN+1])seq, numPathAIs + 1) != -1) {
-					snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%s) from query params should be in the path info", seq[j]);
+				if (isValidDLtrieNode(ctx->sd, dlTrieWalk(ctx->sd, node, &pathAIpos[j], numPathAIs - j))) {
+					gs1_setErrForAI(ctx, gs1_encoder_eDL_ATTRIBUTE_IN_PATH, ai->ai, ai->ailen);
 					ret = false;
 					goto out;
 				}
@@ -709,24 +960,14 @@ add_query_param_to_ai_data:
 
 out:
 
-	if (qp) {			// Restore original query parameter delimiter
-//		*(qp-1) = '?';
-		dlData[qp - dlData - 1] = '?';  // Ugly hack generates same code as above to satiate GCC 11
-	}
-
-	if (fr) {			// Restore original fragment delimiter
-//		*(fr-1) = '#';
-		dlData[fr - dlData - 1] = '#';  // Ditto
-	}
-
 	return ret;
 
 fail:
 
-	if (*ctx->errMsg == '\0')
-		strcpy(ctx->errMsg, "Failed to parse DL data");
+	if (ctx->err.code == gs1_encoder_eNO_ERROR)
+		gs1_setErr(ctx, gs1_encoder_eDL_PARSE_FAILED);
 
-	DEBUG_PRINT("Parsing DL data failed: %s\n", ctx->errMsg);
+	DEBUG_PRINT("Parsing DL data failed: %s\n", gs1_encoder_getErrMsg(ctx));
 
 	*dataStr = '\0';
 	ret = false;
@@ -735,22 +976,33 @@ fail:
 }
 
 
+bool gs1_parseDLuri(gs1_encoder* const ctx, const char* const dlData, char* const dataStr) {
+	assert(dlData);
+	return gs1_parseDLuriN(ctx, dlData, strlen(dlData), dataStr);
+}
+
+
 /*
- *  Generate a DL URI from the AI data
+ *  Render a DL URI for the AI data into the given buffer, returning the length
+ *  of the URI, which may exceed the size of the buffer, or 0 on error
  *
  */
-char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
+size_t gs1_renderDLuri(gs1_encoder* const ctx, const char* const stem, char* const buf, const size_t size) {
 
 	int i, maxQualifiers, numQualifiers;
 	const char *key = NULL;
 	int keyEntry = -1, bestKeyEntry;
-	char *p;
 	char *saveptr = NULL;
 	const char *token;
 	char tmp[256];
 	bool emitFixed;
+	char sep = '?';
+	struct gs1_renderer out;
+	const char* const st = stem ? stem : CANONICAL_DL_STEM;
+	size_t stemlen = strlen(st);
 
 	assert(ctx);
+	assert(buf || size == 0);
 
 	/*
 	 *  Select the first AI that is a valid primary key for a DL
@@ -758,27 +1010,28 @@ char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
 	 */
 	for (i = 0; i < ctx->numAIs; i++) {
 
-		char seq[MAX_AIS][MAX_AI_LEN+1] = { { 0 } };
-		int ke;
 		const struct aiValue* const ai = &ctx->aiData[i];
+		int node;
 
 		if (ai->kind != aiValue_aival)
 			continue;
 
 		assert(ai->aiEntry);
 
-		strcpy(seq[0], ai->aiEntry->ai);
-		if ((ke = getDLpathAIseqEntry(ctx, (const char(*)[MAX_AI_LEN+1])seq, 1)) != -1) {
-			keyEntry = ke;
-			key = ctx->dlKeyQualifiers[keyEntry];
+		node = dlTrieChild(ctx->sd, 0, aiEntryPosition(ctx->sd, ai->aiEntry));
+		if (isValidDLtrieNode(ctx->sd, node)) {
+			keyEntry = ctx->sd->dlTrie[node].entry;
+			key = ctx->sd->dlKeyQualifiers[keyEntry];
 			break;
 		}
 
 	}
 
 	if (keyEntry == -1) {
-		snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Cannot create a DL URI without a primary key AI");
-		return NULL;
+		gs1_setErr(ctx, gs1_encoder_eDL_NO_PRIMARY_KEY);
+		if (size)
+			*buf = '\0';
+		return 0;
 	}
 
 	/*
@@ -789,9 +1042,9 @@ char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
 	DEBUG_PRINT("Considering DL key-qualifier sequences\n");
 	bestKeyEntry = keyEntry;
 	maxQualifiers = 0;
-	while (++keyEntry < ctx->numDLkeyQualifiers) {
+	while (++keyEntry < ctx->sd->numDLkeyQualifiers) {
 
-		strcpy(tmp, ctx->dlKeyQualifiers[keyEntry]);
+		strcpy(tmp, ctx->sd->dlKeyQualifiers[keyEntry]);
 		token = strtok_r(tmp, " ", &saveptr);
 		if (strcmp(token, key) != 0)
 			break;
@@ -812,16 +1065,16 @@ char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
 			maxQualifiers = numQualifiers;
 			bestKeyEntry = keyEntry;
 		}
-		DEBUG_PRINT("  %s: %d qualifier matches\n", ctx->dlKeyQualifiers[keyEntry], numQualifiers);
+		DEBUG_PRINT("  %s: %d qualifier matches\n", ctx->sd->dlKeyQualifiers[keyEntry], numQualifiers);
 
 	}
-	DEBUG_PRINT("  Selected '%s'\n", ctx->dlKeyQualifiers[bestKeyEntry]);
+	DEBUG_PRINT("  Selected '%s'\n", ctx->sd->dlKeyQualifiers[bestKeyEntry]);
 
 	/*
 	 *  Apply the path order from the sequence to the AI elements
 	 *
 	 */
-	strcpy(tmp, ctx->dlKeyQualifiers[bestKeyEntry]);
+	strcpy(tmp, ctx->sd->dlKeyQualifiers[bestKeyEntry]);
 	for (i = 0, token = strtok_r(tmp, " ", &saveptr); token; i++, token = strtok_r(NULL, " ", &saveptr)) {
 		int j;
 		for (j = 0; j < ctx->numAIs; j++) {
@@ -841,12 +1094,12 @@ char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
 	 *  Now build the output
 	 *
 	 */
-	p = ctx->outStr;
-	p += snprintf(p, sizeof(ctx->outStr), "%s", stem ? stem : CANONICAL_DL_STEM);
+	gs1_renderInit(&out, buf, size);
 
 	// Trim trailing slash
-	if (*(p-1) == '/')
-		p--;
+	if (stemlen && st[stemlen-1] == '/')
+		stemlen--;
+	gs1_renderN(&out, st, stemlen);
 
 	/*
 	 *  Output the path components in priority order (i.e. primary key AI,
@@ -858,21 +1111,21 @@ char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
 		for (j = 0; j < ctx->numAIs; j++) {
 
 			char encval[MAX_AI_VALUE_LEN*3+1];	// Assuming that we %-escape everything
-			int n;
+			size_t enclen;
 			const struct aiValue* const ai = &ctx->aiData[j];
 
 			if (ai->kind != aiValue_aival || ai->dlPathOrder != i)
 				continue;
 
-			URIescape(encval, sizeof(encval), ai->value, ai->vallen, false);
-			n = snprintf(p, sizeof(ctx->outStr) - (size_t)(p - ctx->outStr), "/%.*s/%s", ai->ailen, ai->ai, encval);
-			assert(n >= 0 && n < (int)(sizeof(ctx->outStr) - (size_t)(p - ctx->outStr)));  // Satisfy analyser
-			p += n;
+			enclen = URIescape(encval, sizeof(encval) - 1, ai->value, ai->vallen, false);
+			gs1_renderChar(&out, '/');
+			gs1_renderN(&out, ai->ai, ai->ailen);
+			gs1_renderChar(&out, '/');
+			gs1_renderN(&out, encval, enclen);
 			break;
 
 		}
 	}
-	p += snprintf(p, 2, "?");
 
 	/*
 	 *  Output the query parameter components (i.e. attribute AIs) in received order (i.e. attribute AIs), fixed-length first
@@ -883,7 +1136,8 @@ again:
 	for (i = 0; i < ctx->numAIs; i++) {
 
 		char encval[MAX_AI_VALUE_LEN*3+1];	// Assuming that we %-escape everything
-		int j, n;
+		size_t enclen;
+		int j;
 		bool skip = false;
 		const struct aiValue* ai = &ctx->aiData[i];
 
@@ -918,15 +1172,19 @@ again:
 		 */
 		if (ai->aiEntry->dlDataAttr == NO_DATA_ATTR ||
 		    (ai->aiEntry->dlDataAttr == XX_DATA_ATTR && ctx->validationTable[gs1_encoder_vUNKNOWN_AI_NOT_DL_ATTR].enabled)) {
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "AI (%.*s) is not a valid DL URI data attribute", ai->ailen, ai->ai);
-			*ctx->outStr = '\0';
-			return NULL;
+			gs1_setErrForAI(ctx, gs1_encoder_eDL_INVALID_ATTRIBUTE, ai->ai, ai->ailen);
+			if (size)
+				*buf = '\0';
+			return 0;
 		}
 
-		URIescape(encval, sizeof(encval), ai->value, ai->vallen, true);
-		n = snprintf(p, sizeof(ctx->outStr) - (size_t)(p - ctx->outStr), "%.*s=%s&", ai->ailen, ai->ai, encval);
-		assert(n >= 0 && n < (int)(sizeof(ctx->outStr) - (size_t)(p - ctx->outStr)));  // Satisfy analyser
-		p += n;
+		// Query parameters are introduced by "?" and separated by "&"
+		enclen = URIescape(encval, sizeof(encval) - 1, ai->value, ai->vallen, true);
+		gs1_renderChar(&out, sep);
+		gs1_renderN(&out, ai->ai, ai->ailen);
+		gs1_renderChar(&out, '=');
+		gs1_renderN(&out, encval, enclen);
+		sep = '&';
 
 	}
 	if (emitFixed) {
@@ -934,8 +1192,24 @@ again:
 		goto again;
 	}
 
-	// Trim the final character, either '?' or '&'
-	*(p-1) = '\0';
+	return gs1_renderEnd(&out);
+
+}
+
+
+/*
+ *  Generate a DL URI from the AI data
+ *
+ */
+char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
+
+	size_t len;
+
+	assert(ctx);
+
+	if ((len = gs1_renderDLuri(ctx, stem, ctx->outStr, sizeof(ctx->outStr))) == 0)
+		return NULL;
+	assert(len < sizeof(ctx->outStr));
 
 	return ctx->outStr;
 
@@ -959,11 +1233,11 @@ static void do_test_parseDLuri(gs1_encoder* const ctx, const char* const file, c
 
 	ctx->numAIs = 0;
 	strcpy(in, dlData);
-	TEST_CHECK(gs1_parseDLuri(ctx, in, out) ^ (!should_succeed));
-	TEST_MSG("Err: %s", ctx->errMsg);
+	TEST_CHECK(gs1_parseDLuriN(ctx, in, strlen(in), out) ^ (!should_succeed));
+	TEST_MSG("Err: %s", gs1_encoder_getErrMsg(ctx));
 	if (should_succeed)
 		TEST_CHECK(strcmp(out, expect) == 0);
-	TEST_MSG("Given: %s; Got: %s; Expected: %s; Err: %s", dlData, out, expect, ctx->errMsg);
+	TEST_MSG("Given: %s; Got: %s; Expected: %s; Err: %s", dlData, out, expect, gs1_encoder_getErrMsg(ctx));
 
 	TEST_CHECK(strcmp(dlData, in) == 0);
 	TEST_MSG("Input data was erroneously clobbered: %s", in);
@@ -1183,6 +1457,22 @@ void test_dl_parseDLuri(void) {
 		"https://a/stem/00/006141411234567890?99=ABC#fragment",
 		"^0000614141123456789099ABC");
 
+	test_parseDLuri(true,					// Query marker within fragment
+		"https://a/stem/00/006141411234567890#frag?99=ABC",
+		"^00006141411234567890");
+
+	test_parseDLuri(true,					// Path separators within query and fragment
+		"https://a/stem/00/006141411234567890?99=A/B#/10/XYZ",
+		"^0000614141123456789099A/B");
+
+	test_parseDLuri(true,					// Query and fragment markers before the path belong to the domain
+		"https://a?99=XYZ#/stem/00/006141411234567890",
+		"^00006141411234567890");
+
+	test_parseDLuri(true,					// Empty query params are skipped
+		"https://a/stem/00/006141411234567890?&&99=ABC&&98=XYZ&",
+		"^0000614141123456789099ABC^98XYZ");
+
 
 	/*
 	 * Examples from DL specification
@@ -1387,6 +1677,12 @@ void test_dl_URIunescape(void) {
 	test_URIunescape("A%g4B", "A%g4B", "A%g4B");			// Non hex digit
 	test_URIunescape("A%G4B", "A%G4B", "A%G4B");			// Non hex digit
 
+	// Escapes around and across the boundaries of 16-character blocks
+	test_URIunescape("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789");
+	test_URIunescape("ABCDEFGHIJKLMNO%20QRSTUVWXYZ+abcdef", "ABCDEFGHIJKLMNO QRSTUVWXYZ+abcdef", "ABCDEFGHIJKLMNO QRSTUVWXYZ abcdef");
+	test_URIunescape("ABCDEFGHIJKLMN%2FOPQRSTUVWXYZ0123%", "ABCDEFGHIJKLMN/OPQRSTUVWXYZ0123%", "ABCDEFGHIJKLMN/OPQRSTUVWXYZ0123%");
+	test_URIunescape("ABCDEFGHIJKLMNOPQRSTUVWXYZ01234%4", "ABCDEFGHIJKLMNOPQRSTUVWXYZ01234%4", "ABCDEFGHIJKLMNOPQRSTUVWXYZ01234%4");
+
 	// Check that \0 is trapped as an illegal character
 	TEST_CHECK(URIunescape(out, MAX_AI_VALUE_LEN, "A%00B", 5, false) == 0);
 
@@ -1450,6 +1746,11 @@ void test_dl_URIescape(void) {
 	test_URIescape("AB ", "AB%20", "AB+");
 	test_URIescape("A  B", "A%20%20B", "A++B");			// Run together
 
+	// Escapes around and across the boundaries of 16-character blocks
+	test_URIescape("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._~", "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._~", "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-._~");
+	test_URIescape("ABCDEFGHIJKLMNO QRSTUVWXYZ/abcdef", "ABCDEFGHIJKLMNO%20QRSTUVWXYZ%2Fabcdef", "ABCDEFGHIJKLMNO+QRSTUVWXYZ%2Fabcdef");
+	test_URIescape("ABCDEFGHIJKLMNOP!", "ABCDEFGHIJKLMNOP%21", "ABCDEFGHIJKLMNOP%21");
+
 	// Truncated input
 	TEST_CHECK(URIescape(out, MAX_AI_VALUE_LEN, "ABCD", 2, false) == 2);
 	TEST_CHECK(memcmp(out, "AB", 3) == 0);			// Includes \0
@@ -1464,6 +1765,9 @@ void test_dl_URIescape(void) {
 	TEST_CHECK(URIescape(out, 4, "A!B", 3, false) == 4);
 	TEST_CHECK(memcmp(out, "A%21", 5) == 0);		// Includes \0
 
+	TEST_CHECK(URIescape(out, 20, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", 26, false) == 20);
+	TEST_CHECK(memcmp(out, "ABCDEFGHIJKLMNOPQRST", 21) == 0);	// Includes \0
+
 	TEST_CHECK(URIescape(out, 3, "A!B", 3, false) == 1);
 	TEST_CHECK(memcmp(out, "A", 2) == 0);			// Includes \0
 
@@ -1560,21 +1864,66 @@ void test_dl_testValidateDLpathAIseq(void) {
 
 	};
 
+	const char bad[][MAX_AIS][MAX_AI_LEN+1] = {
+		{ "21" },				// Not a primary key
+		{ "00", "21" },				// No qualifiers
+		{ "01", "21", "10" },			// Out of order
+		{ "01", "10", "22" },
+		{ "01", "235", "21" },			// Mixed qualifier sets
+		{ "414", "254", "7040" },
+		{ "01", "99" },				// Not a qualifier
+	};
+
 	size_t i;
+	int j, k;
 
 	gs1_encoder* ctx;
 	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
 	assert(ctx);
 
 	for (i = 0; i < SIZEOF_ARRAY(seq); i++) {
-		int num;
+		int num, pos[MAX_AIS];
 		char casename[256] = { 0 };
 		for (num = 0; *seq[i][num]; num++) {
 			strcat(casename, seq[i][num]);
 			strcat(casename, " ");
+			pos[num] = gs1_aiTablePosition(ctx->sd, seq[i][num], strlen(seq[i][num]));
 		}
 		TEST_CASE(casename);
-		TEST_CHECK(isValidDLpathAIseq(ctx, seq[i], num));
+		TEST_CHECK(isValidDLtrieNode(ctx->sd, dlTrieWalk(ctx->sd, 0, pos, num)));
+	}
+
+	for (i = 0; i < SIZEOF_ARRAY(bad); i++) {
+		int num, pos[MAX_AIS];
+		char casename[256] = { 0 };
+		for (num = 0; *bad[i][num]; num++) {
+			strcat(casename, bad[i][num]);
+			strcat(casename, " ");
+			pos[num] = gs1_aiTablePosition(ctx->sd, bad[i][num], strlen(bad[i][num]));
+		}
+		TEST_CASE(casename);
+		TEST_CHECK(!isValidDLtrieNode(ctx->sd, dlTrieWalk(ctx->sd, 0, pos, num)));
+	}
+
+	// Every key-qualifier sequence leads to a trie node for an identical
+	// sequence
+	TEST_CASE("All key-qualifier sequences");
+	for (j = 0; j < ctx->sd->numDLkeyQualifiers; j++) {
+		const char *p = ctx->sd->dlKeyQualifiers[j];
+		int num = 0, pos[MAX_AIS], node;
+		while (*p) {
+			const size_t len = strcspn(p, " ");
+			pos[num++] = gs1_aiTablePosition(ctx->sd, p, len);
+			p += len;
+			if (*p == ' ')
+				p++;
+		}
+		node = dlTrieWalk(ctx->sd, 0, pos, num);
+		TEST_CHECK(isValidDLtrieNode(ctx->sd, node) &&
+			   strcmp(ctx->sd->dlKeyQualifiers[ctx->sd->dlTrie[node].entry], ctx->sd->dlKeyQualifiers[j]) == 0);
+		TEST_MSG("Sequence: %s", ctx->sd->dlKeyQualifiers[j]);
+		for (k = 0; k < num; k++)
+			TEST_CHECK(pos[k] != -1);
 	}
 
 	gs1_encoder_free(ctx);
@@ -1595,7 +1944,7 @@ static void do_test_testGenerateDLuri(gs1_encoder* const ctx, const char* const
 
 	ctx->numAIs = 0;
 	TEST_CHECK((ret = gs1_parseAIdata(ctx, aiData, out)) == true);
-	TEST_MSG("Parse failed for non-pair validation reasons. Err: %s", ctx->errMsg);
+	TEST_MSG("Parse failed for non-pair validation reasons. Err: %s", gs1_encoder_getErrMsg(ctx));
 	if (!ret)
 		return;
 
@@ -1605,7 +1954,7 @@ static void do_test_testGenerateDLuri(gs1_encoder* const ctx, const char* const
 	}
 
 	TEST_CHECK((uri = gs1_generateDLuri(ctx, stem)) != NULL);
-	TEST_MSG("Expected success. Got error: %s", ctx->errMsg);
+	TEST_MSG("Expected success. Got error: %s", gs1_encoder_getErrMsg(ctx));
 
 	if (!uri)
 		return;
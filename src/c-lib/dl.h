@@ -30,9 +30,26 @@
 #define DL_PATH_ORDER_ATTRIBUTE		UINT8_MAX
 
 
-bool gs1_populateDLkeyQualifiers(gs1_encoder *ctx);
-void gs1_freeDLkeyQualifiers(gs1_encoder *ctx);
-bool gs1_parseDLuri(gs1_encoder *ctx, char *dlData, char *dataStr);
+/*
+ *  Node of the trie of valid DL key-qualifier sequences, keyed by AI table
+ *  position and descending from a root node at position 0. The children of
+ *  each node are linked in order of AI table position.
+ *
+ */
+struct dlTrieNode {
+	uint16_t ai;				// AI table position
+	uint16_t child;				// First child, or 0 if none
+	uint16_t sibling;			// Next sibling, or 0 if none
+	int32_t entry;				// Position of the sequence in dlKeyQualifiers, or -1 if not valid
+};
+
+
+bool gs1_populateDLkeyQualifiers(gs1_syntax_dictionary *sd);
+bool gs1_compileDLkeyQualifiers(gs1_syntax_dictionary *sd);
+void gs1_freeDLkeyQualifiers(gs1_syntax_dictionary *sd);
+bool gs1_parseDLuri(gs1_encoder *ctx, const char *dlData, char *dataStr);
+bool gs1_parseDLuriN(gs1_encoder *ctx, const char *dlData, size_t len, char *dataStr);
+size_t gs1_renderDLuri(gs1_encoder* ctx, const char* stem, char* buf, size_t size);
 char* gs1_generateDLuri(gs1_encoder* ctx, const char* stem);
 
 
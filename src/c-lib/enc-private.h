@@ -24,13 +24,16 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "gs1encoders.h"
+#include "stats.h"
 
 
 // Implementation limits that can be changed
 #define MAX_FNAME	120	// Maximum filename
 #define MAX_DATA	8191	// Maximum input buffer size
+#define MAX_ERRS	32	// Maximum errors collected for a message
 
 
 #ifdef _MSC_VER
@@ -63,12 +66,157 @@
 #  define DIAG_DISABLE_DEPRECATED_DECLARATIONS __pragma(warning(disable: 4996))
 #endif
 
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#  define ATOMIC_INCREMENT(x) _InterlockedIncrement(x)
+#  define ATOMIC_DECREMENT(x) _InterlockedDecrement(x)
+#else
+#  define ATOMIC_INCREMENT(x) __atomic_add_fetch(x, 1, __ATOMIC_ACQ_REL)
+#  define ATOMIC_DECREMENT(x) __atomic_sub_fetch(x, 1, __ATOMIC_ACQ_REL)
+#endif
+
 #define SIZEOF_ARRAY(x) (sizeof(x) / sizeof(x[0]))
 
 
+/*
+ *  Bounded writer that appends to a NUL-terminated string by tracking its end
+ *  rather than rescanning it, so that building a message is linear in its
+ *  length. A write that would take the string beyond the limit fails without
+ *  writing anything.
+ *
+ */
+struct gs1_writer {
+	char *base;			// Start of the string
+	char *cur;			// Position of the terminating NUL
+	char *end;			// Furthest permitted position of the terminating NUL
+};
+
+static inline void gs1_writerInit(struct gs1_writer* const w, char* const buf, const size_t max) {
+	w->base = w->cur = buf;
+	w->end = buf + max;
+	*buf = '\0';
+}
+
+static inline size_t gs1_writerLen(const struct gs1_writer* const w) {
+	return (size_t)(w->cur - w->base);
+}
+
+static inline bool gs1_writeN(struct gs1_writer* const w, const char* const s, const size_t len) {
+	if (len > (size_t)(w->end - w->cur))
+		return false;
+	memcpy(w->cur, s, len);
+	w->cur += len;
+	*w->cur = '\0';
+	return true;
+}
+
+static inline bool gs1_writeStr(struct gs1_writer* const w, const char* const s) {
+	return gs1_writeN(w, s, strlen(s));
+}
+
+static inline bool gs1_writeChar(struct gs1_writer* const w, const char c) {
+	if (w->cur == w->end)
+		return false;
+	*w->cur++ = c;
+	*w->cur = '\0';
+	return true;
+}
+
+
+/*
+ *  Render into a caller's buffer of the given size in the manner of
+ *  snprintf(): output beyond the buffer is discarded but still counted, so
+ *  that the caller learns the length that is required.
+ *
+ */
+struct gs1_renderer {
+	char *buf;
+	size_t size;			// Size of buf, including the terminating NUL
+	size_t len;			// Length of the full output
+};
+
+static inline void gs1_renderInit(struct gs1_renderer* const r, char* const buf, const size_t size) {
+	r->buf = buf;
+	r->size = size;
+	r->len = 0;
+}
+
+static inline void gs1_renderN(struct gs1_renderer* const r, const char* const s, const size_t len) {
+	if (r->len + 1 < r->size)
+		memcpy(r->buf + r->len, s, len < r->size - r->len - 1 ? len : r->size - r->len - 1);
+	r->len += len;
+}
+
+static inline void gs1_renderChar(struct gs1_renderer* const r, const char c) {
+	if (r->len + 1 < r->size)
+		r->buf[r->len] = c;
+	r->len++;
+}
+
+static inline size_t gs1_renderEnd(const struct gs1_renderer* const r) {
+	if (r->size)
+		r->buf[r->len < r->size ? r->len : r->size - 1] = '\0';
+	return r->len;
+}
+
+
 #include "ai.h"
 
 
+/*
+ *  A failure is recorded as a code with the arguments of its message, which
+ *  is only formatted into errMsg and linterErrMarkup once it is read. The
+ *  arguments are copied since the data being processed need not outlive the
+ *  call that rejected it.
+ *
+ */
+struct gs1_errRecord {
+	gs1_encoder_error_t code;		// Reason for the failure
+	int aiIndex;				// Position in aiData of the offending AI, or -1
+	size_t offset;				// Offending data within the AI value
+	size_t length;
+	int num;				// Numeric message argument
+	char arg[2][256];			// Text message arguments; for a linter failure the AI and its value
+	bool formatted;				// Whether errMsg and linterErrMarkup reflect the record
+};
+
+
+/*
+ *  Everything derived from the Syntax Dictionary. This is never modified once
+ *  it has been built so it is shared by every gs1_encoder instance that is
+ *  attached to it, with the last reference to be dropped releasing it.
+ *
+ */
+struct gs1_syntax_dictionary {
+
+	volatile long refCount;			// References held by attached contexts and by the user
+
+	struct aiEntry *aiTable;		// Pointer to the AI table
+	size_t aiTableEntries;			// Number of entries in the AI table
+	bool aiTableIsDynamic;			// True if the AI table is loaded from the Syntax Dictionary
+
+	uint8_t aiLengthByPrefix[100];		// AI length by two-digit prefix
+	const uint16_t *aiIndex;		// AI table position plus one, keyed by zero-padded AI
+
+	struct aiRuleSet *aiRuleSets;		// Compiled "ex" and "req" attributes, parallel to the AI table
+	struct aiRule *aiRules;			// Pool of rules referenced by aiRuleSets
+	size_t numAIrules;
+
+	uint8_t *aiPrograms;			// Compiled component validation programs
+	uint32_t *aiProgramOff;			// Position of each program, parallel to the AI table
+
+	char** dlKeyQualifiers;			// List of valid DL key qualifier association strings
+	int numDLkeyQualifiers;			// Number of dlKeyQualifiers strings
+	struct dlTrieNode *dlTrie;		// Trie of the dlKeyQualifiers sequences
+
+	const uint8_t *image;			// Compiled image that the dictionary is loaded from, if any
+	size_t imageSize;
+
+	char errMsg[512];			// Reason that building the dictionary failed
+
+};
+
+
 struct gs1_encoder {
 
 	gs1_encoder_symbologies_t sym;		// Symbology type
@@ -78,11 +226,24 @@ struct gs1_encoder {
 	bool permitZeroSuppressedGTINinDLuris;	// Whether to permit a path component GTIN value to be in GTIN-{8,12,13} format
 	bool includeDataTitlesInHRI;		// Whether to include the Data Titles in HRI string output
 
-	char errMsg[512];
+	struct gs1_errRecord err;		// Most recent failure
+	char errMsg[512];			// Formatted from err on demand
 	gs1_lint_err_t linterErr;		// Error returned by a linter
-	char linterErrMarkup[512];
+	char linterErrMarkup[512];		// Formatted from err on demand
+	const char *errAI;			// AI whose value was rejected, within the data being processed
+	size_t errAIlen;
+	const char *errPos;			// Offending data within that value, or NULL for the whole value
+
+	bool collectErrs;			// Continue past recoverable errors, collecting each of them
+	gs1_encoder_error_record_t errList[MAX_ERRS];	// Collected errors, followed by any error that ended processing
+	int numErrs;
+	bool errCollected;			// Whether err has been added to errList
+	struct gs1_errRecord firstErr;		// First collected error, reported once processing is complete
+	gs1_lint_err_t firstLinterErr;
 
 	char dataStr[MAX_DATA+1];		// Input data buffer passed to the encoders
+	const char *extDataStr;			// Caller's data validated in place, not yet copied into dataStr
+	size_t extDataStrLen;
 	char dlAIbuffer[MAX_DATA+1];		// Populated with unbracketed AI string extracted from DL input
 	char outStr[2*MAX_DATA+1];		// Buffer to return formatted data
 	char *outHRI[MAX_AIS];			// Array of AI element string for HRI printing
@@ -90,20 +251,30 @@ struct gs1_encoder {
 	bool localAlloc;			// True if we malloc()ed this struct
 	FILE *outfp;
 
-	struct aiEntry *aiTable;		// Pointer to the AI table
-	size_t aiTableEntries;			// Number of entries in the AI table
-	bool aiTableIsDynamic;			// True if the AI table is loaded from the Syntax Dictionary
+	gs1_syntax_dictionary *sd;		// Shared Syntax Dictionary, including the AI table
 
 	struct aiValue aiData[MAX_AIS];		// List of AI components
 	int numAIs;
 
+	uint64_t aiPresent[(AI_INDEX_SIZE + 63) / 64];	// Index keys of the AIs in aiData
+	uint8_t aiFirstInstance[AI_INDEX_SIZE];	// Position in aiData of the first instance of each present AI
+
 	struct validationEntry validationTable[gs1_encoder_vNUMVALIDATIONS];
 						// Table of all global validation functions
 
-	uint8_t aiLengthByPrefix[100];		// AI length by two-digit prefix
-
-	char** dlKeyQualifiers;			// List of valid DL key qualifier association strings
-	int numDLkeyQualifiers;			// Number of dlKeyQualifiers strings
+	struct gs1_cacheEntry *cache;		// Outcomes of recently processed inputs
+	int cacheSize;
+	size_t cacheHits;
+	size_t cacheMisses;
+
+#ifdef PERF_STATS
+	gs1_encoder_stats_t stats;		// Performance counters and phase timings
+	gs1_encoder_phase_callback_t phaseCallback;
+	void *phaseUserData;
+	struct gs1_statsFrame statsFrames[STATS_MAX_DEPTH];	// Phases currently entered, innermost last
+	int statsDepth;
+	uint64_t statsMark;			// Time from which the innermost phase is next charged
+#endif
 
 };
 
@@ -113,6 +284,12 @@ struct gs1_encoder {
  *
  */
 bool gs1_allDigits(const uint8_t *str, size_t len);
+void gs1_clearErr(gs1_encoder *ctx);
+void gs1_setErr(gs1_encoder *ctx, gs1_encoder_error_t code);
+void gs1_setErrArg(gs1_encoder *ctx, int n, const char *arg, size_t len);
+void gs1_setErrForAI(gs1_encoder *ctx, gs1_encoder_error_t code, const char *ai, size_t ailen);
+bool gs1_collectErr(gs1_encoder *ctx);
+bool gs1_checkCollectedErrs(gs1_encoder *ctx);
 
 
 #ifdef UNIT_TESTS
@@ -120,6 +297,7 @@ bool gs1_allDigits(const uint8_t *str, size_t len);
 void test_api_getVersion(void);
 void test_api_instanceSize(void);
 void test_api_init(void);
+void test_api_sharedSyntaxDictionary(void);
 void test_api_defaults(void);
 void test_api_sym(void);
 void test_api_addCheckDigit(void);
@@ -128,11 +306,20 @@ void test_api_permitZeroSuppressedGTINinDLuris(void);
 void test_api_validateAIassociations(void);
 void test_api_validations(void);
 void test_api_dataStr(void);
+void test_api_dataStrN(void);
+void test_api_AIdataStrN(void);
 void test_api_getAIdataStr(void);
 void test_api_getScanData(void);
 void test_api_setScanData(void);
+void test_api_setDataStrBatch(void);
+void test_api_setAIdataStrBatch(void);
+void test_api_setScanDataBatch(void);
 void test_api_getHRI(void);
 void test_api_copyHRI(void);
+void test_api_render(void);
+void test_api_getNextAI(void);
+void test_api_getErrRecord(void);
+void test_api_collectErrors(void);
 void test_api_getDLignoredQueryParams(void);
 void test_api_copyDLignoredQueryParams(void);
 
@@ -0,0 +1,597 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gs1encoders.h"
+#include "enc-private.h"
+#include "engine.h"
+
+
+/*
+ *  Minimal threading primitives. Without threads the calling thread does all
+ *  of the work.
+ *
+ */
+#if defined(__EMSCRIPTEN__) || defined(NOTHREADS)
+
+#define ENGINE_NO_THREADS
+
+typedef int engine_mutex_t;
+typedef int engine_cond_t;
+#define MUTEX_INIT(m)		((void)(m), true)
+#define MUTEX_LOCK(m)		(void)(m)
+#define MUTEX_UNLOCK(m)		(void)(m)
+#define MUTEX_DESTROY(m)	(void)(m)
+#define COND_INIT(c)		((void)(c), true)
+#define COND_WAIT(c, m)		(void)(c)
+#define COND_BROADCAST(c)	(void)(c)
+#define COND_DESTROY(c)		(void)(c)
+
+#elif defined(_WIN32)
+
+#include <windows.h>
+
+typedef CRITICAL_SECTION engine_mutex_t;
+typedef CONDITION_VARIABLE engine_cond_t;
+typedef HANDLE engine_thread_t;
+#define MUTEX_INIT(m)		(InitializeCriticalSection(m), true)
+#define MUTEX_LOCK(m)		EnterCriticalSection(m)
+#define MUTEX_UNLOCK(m)		LeaveCriticalSection(m)
+#define MUTEX_DESTROY(m)	DeleteCriticalSection(m)
+#define COND_INIT(c)		(InitializeConditionVariable(c), true)
+#define COND_WAIT(c, m)		SleepConditionVariableCS(c, m, INFINITE)
+#define COND_BROADCAST(c)	WakeAllConditionVariable(c)
+#define COND_DESTROY(c)		(void)(c)
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t engine_mutex_t;
+typedef pthread_cond_t engine_cond_t;
+typedef pthread_t engine_thread_t;
+#define MUTEX_INIT(m)		(pthread_mutex_init(m, NULL) == 0)
+#define MUTEX_LOCK(m)		pthread_mutex_lock(m)
+#define MUTEX_UNLOCK(m)		pthread_mutex_unlock(m)
+#define MUTEX_DESTROY(m)	pthread_mutex_destroy(m)
+#define COND_INIT(c)		(pthread_cond_init(c, NULL) == 0)
+#define COND_WAIT(c, m)		pthread_cond_wait(c, m)
+#define COND_BROADCAST(c)	pthread_cond_broadcast(c)
+#define COND_DESTROY(c)		pthread_cond_destroy(c)
+
+#endif
+
+
+#define ENGINE_MAX_THREADS	256
+#define ENGINE_CHUNK_SPANS	(ENGINE_CHUNK_SIZE * MAX_AIS)
+
+
+typedef size_t (*batch_func_t)(gs1_encoder *ctx, const gs1_encoder_batch_input_t *inputs, size_t count, gs1_encoder_batch_result_t *results, gs1_encoder_batch_span_t *spans, size_t maxSpans);
+
+
+struct engineWorker {
+	gs1_engine *engine;
+	gs1_encoder *ctx;			// Scratch context attached to the shared dictionary
+	gs1_encoder_batch_span_t *spans;	// Spans of the chunk being processed
+#ifndef ENGINE_NO_THREADS
+	engine_thread_t thread;
+	bool started;
+#endif
+};
+
+
+/*
+ *  Worker 0 is the calling thread, which works alongside the pool threads.
+ *
+ *  Chunks of the batch are claimed in order by whichever worker is idle and
+ *  are committed to the caller's results in order, so the outcome is the same
+ *  as for a single context regardless of the number of workers.
+ *
+ */
+struct gs1_engine {
+
+	struct engineWorker *workers;
+	int numWorkers;
+
+	engine_mutex_t lock;
+	engine_cond_t work;			// Signalled when a job is started or on shutdown
+	engine_cond_t done;			// Signalled when the last pool thread completes a job
+	engine_cond_t commit;			// Signalled when a chunk has been committed
+	unsigned long generation;		// Incremented for each job
+	bool shutdown;
+	int active;				// Pool threads yet to complete the current job
+
+	// The current job
+	batch_func_t fn;
+	const gs1_encoder_batch_input_t *inputs;
+	size_t count;
+	gs1_encoder_batch_result_t *results;
+	gs1_encoder_batch_span_t *spans;
+	size_t maxSpans;
+	size_t numChunks;
+	volatile long nextChunk;		// Next chunk to be claimed
+	size_t committed;			// Number of chunks committed
+	size_t numSpans;			// Spans committed to the caller's array
+	size_t numValid;
+
+};
+
+
+/*
+ *  Transfer the spans of a processed chunk into the caller's array, with the
+ *  same allocation of spans that a single context would have made.
+ *
+ */
+static void commitChunk(gs1_engine* const engine, const size_t first, const size_t n, const gs1_encoder_batch_span_t* const spans) {
+
+	size_t i;
+
+	for (i = first; i < first + n; i++) {
+
+		gs1_encoder_batch_result_t* const res = &engine->results[i];
+		const size_t local = res->firstSpan;
+
+		res->firstSpan = engine->numSpans;
+
+		if (res->status != gs1_encoder_bVALID)
+			continue;
+
+		if (res->numSpans > engine->maxSpans - engine->numSpans) {
+			res->status = gs1_encoder_bNO_SPANS;
+			res->errOffset = engine->inputs[i].length;
+			res->numSpans = 0;
+			continue;
+		}
+
+		if (res->numSpans)
+			memcpy(&engine->spans[engine->numSpans], &spans[local], res->numSpans * sizeof(spans[0]));
+		engine->numSpans += res->numSpans;
+		engine->numValid++;
+
+	}
+
+}
+
+
+static void runChunks(struct engineWorker* const w) {
+
+	gs1_engine* const engine = w->engine;
+	long c;
+
+	while ((c = ATOMIC_INCREMENT(&engine->nextChunk) - 1) < (long)engine->numChunks) {
+
+		const size_t first = (size_t)c * ENGINE_CHUNK_SIZE;
+		const size_t n = engine->count - first < ENGINE_CHUNK_SIZE ? engine->count - first : ENGINE_CHUNK_SIZE;
+
+		engine->fn(w->ctx, &engine->inputs[first], n, &engine->results[first], w->spans, ENGINE_CHUNK_SPANS);
+
+		// Wait for the preceding chunks to be committed
+		MUTEX_LOCK(&engine->lock);
+		while (engine->committed != (size_t)c)
+			COND_WAIT(&engine->commit, &engine->lock);
+		MUTEX_UNLOCK(&engine->lock);
+
+		commitChunk(engine, first, n, w->spans);
+
+		MUTEX_LOCK(&engine->lock);
+		engine->committed++;
+		COND_BROADCAST(&engine->commit);
+		MUTEX_UNLOCK(&engine->lock);
+
+	}
+
+}
+
+
+#ifndef ENGINE_NO_THREADS
+
+static void workerLoop(struct engineWorker* const w) {
+
+	gs1_engine* const engine = w->engine;
+	unsigned long generation = 0;
+
+	MUTEX_LOCK(&engine->lock);
+	for (;;) {
+
+		while (!engine->shutdown && engine->generation == generation)
+			COND_WAIT(&engine->work, &engine->lock);
+		if (engine->shutdown)
+			break;
+		generation = engine->generation;
+		MUTEX_UNLOCK(&engine->lock);
+
+		runChunks(w);
+
+		MUTEX_LOCK(&engine->lock);
+		if (--engine->active == 0)
+			COND_BROADCAST(&engine->done);
+
+	}
+	MUTEX_UNLOCK(&engine->lock);
+
+}
+
+#ifdef _WIN32
+static DWORD WINAPI workerMain(LPVOID arg) {
+	workerLoop(arg);
+	return 0;
+}
+#define THREAD_START(t, w)	((*(t) = CreateThread(NULL, 0, workerMain, w, 0, NULL)) != NULL)
+#define THREAD_JOIN(t)		(WaitForSingleObject(t, INFINITE), CloseHandle(t))
+#else
+static void* workerMain(void* arg) {
+	workerLoop(arg);
+	return NULL;
+}
+#define THREAD_START(t, w)	(pthread_create(t, NULL, workerMain, w) == 0)
+#define THREAD_JOIN(t)		pthread_join(t, NULL)
+#endif
+
+#endif  /* ENGINE_NO_THREADS */
+
+
+static int numProcessors(void) {
+#if defined(ENGINE_NO_THREADS)
+	return 1;
+#elif defined(_WIN32)
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return (int)si.dwNumberOfProcessors;
+#else
+	const long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#endif
+}
+
+
+gs1_engine* gs1_engine_init(gs1_encoder* const ctx, int numThreads) {
+
+	gs1_engine *engine;
+	int i;
+
+	assert(ctx);
+
+#ifdef NOMALLOC
+	(void)numThreads;
+	return NULL;
+#endif
+
+	if (numThreads <= 0)
+		numThreads = numProcessors();
+#ifdef ENGINE_NO_THREADS
+	numThreads = 1;
+#endif
+	if (numThreads > ENGINE_MAX_THREADS)
+		numThreads = ENGINE_MAX_THREADS;
+
+	if ((engine = calloc(1, sizeof(gs1_engine))) == NULL)
+		return NULL;
+
+	if (!MUTEX_INIT(&engine->lock)) {
+		free(engine);
+		return NULL;
+	}
+	if (!COND_INIT(&engine->work) || !COND_INIT(&engine->done) || !COND_INIT(&engine->commit))
+		goto fail_cond;
+
+	if ((engine->workers = calloc((size_t)numThreads, sizeof(struct engineWorker))) == NULL)
+		goto fail_cond;
+
+	/*
+	 *  Each worker has a context with the same options as the given
+	 *  context, sharing its dictionary
+	 *
+	 */
+	for (i = 0; i < numThreads; i++) {
+
+		struct engineWorker* const w = &engine->workers[i];
+
+		w->engine = engine;
+		engine->numWorkers++;
+
+		if ((w->ctx = gs1_encoder_initWithSyntaxDictionary(NULL, ctx->sd)) == NULL ||
+		    (w->spans = malloc(ENGINE_CHUNK_SPANS * sizeof(gs1_encoder_batch_span_t))) == NULL)
+			goto fail;
+
+		w->ctx->sym = ctx->sym;
+		w->ctx->addCheckDigit = ctx->addCheckDigit;
+		w->ctx->permitUnknownAIs = ctx->permitUnknownAIs;
+		w->ctx->permitZeroSuppressedGTINinDLuris = ctx->permitZeroSuppressedGTINinDLuris;
+		w->ctx->includeDataTitlesInHRI = ctx->includeDataTitlesInHRI;
+		memcpy(w->ctx->validationTable, ctx->validationTable, sizeof(ctx->validationTable));
+
+	}
+
+#ifndef ENGINE_NO_THREADS
+	for (i = 1; i < numThreads; i++) {
+		struct engineWorker* const w = &engine->workers[i];
+		if (!THREAD_START(&w->thread, w))
+			goto fail;
+		w->started = true;
+	}
+#endif
+
+	return engine;
+
+fail:
+
+	gs1_engine_free(engine);
+	return NULL;
+
+fail_cond:
+
+	MUTEX_DESTROY(&engine->lock);
+	free(engine);
+	return NULL;
+
+}
+
+
+void gs1_engine_free(gs1_engine* const engine) {
+
+	int i;
+
+	if (!engine)
+		return;
+
+#ifndef ENGINE_NO_THREADS
+	MUTEX_LOCK(&engine->lock);
+	engine->shutdown = true;
+	COND_BROADCAST(&engine->work);
+	MUTEX_UNLOCK(&engine->lock);
+
+	for (i = 1; i < engine->numWorkers; i++) {
+		if (engine->workers[i].started)
+			THREAD_JOIN(engine->workers[i].thread);
+	}
+#endif
+
+	for (i = 0; i < engine->numWorkers; i++) {
+		if (engine->workers[i].ctx)
+			gs1_encoder_free(engine->workers[i].ctx);
+		free(engine->workers[i].spans);
+	}
+	free(engine->workers);
+
+	COND_DESTROY(&engine->work);
+	COND_DESTROY(&engine->done);
+	COND_DESTROY(&engine->commit);
+	MUTEX_DESTROY(&engine->lock);
+
+	free(engine);
+
+}
+
+
+__ATTR_PURE int gs1_engine_getNumThreads(gs1_engine* const engine) {
+	assert(engine);
+	return engine->numWorkers;
+}
+
+
+static size_t runJob(gs1_engine* const engine, const batch_func_t fn, const gs1_encoder_batch_input_t* const inputs, const size_t count, gs1_encoder_batch_result_t* const results, gs1_encoder_batch_span_t* const spans, const size_t maxSpans) {
+
+	assert(engine);
+	assert(inputs || count == 0);
+	assert(results || count == 0);
+	assert(spans || maxSpans == 0);
+
+	engine->fn = fn;
+	engine->inputs = inputs;
+	engine->count = count;
+	engine->results = results;
+	engine->spans = spans;
+	engine->maxSpans = maxSpans;
+	engine->numChunks = (count + ENGINE_CHUNK_SIZE - 1) / ENGINE_CHUNK_SIZE;
+	engine->nextChunk = 0;
+	engine->committed = 0;
+	engine->numSpans = 0;
+	engine->numValid = 0;
+
+	// Wake the pool for all but the smallest of batches
+	MUTEX_LOCK(&engine->lock);
+	engine->active = engine->numChunks > 1 ? engine->numWorkers - 1 : 0;
+	if (engine->active) {
+		engine->generation++;
+		COND_BROADCAST(&engine->work);
+	}
+	MUTEX_UNLOCK(&engine->lock);
+
+	runChunks(&engine->workers[0]);
+
+	MUTEX_LOCK(&engine->lock);
+	while (engine->active)
+		COND_WAIT(&engine->done, &engine->lock);
+	MUTEX_UNLOCK(&engine->lock);
+
+	return engine->numValid;
+
+}
+
+
+size_t gs1_engine_setDataStrBatch(gs1_engine* const engine, const gs1_encoder_batch_input_t* const inputs, const size_t count, gs1_encoder_batch_result_t* const results, gs1_encoder_batch_span_t* const spans, const size_t maxSpans) {
+	return runJob(engine, gs1_encoder_setDataStrBatch, inputs, count, results, spans, maxSpans);
+}
+
+
+size_t gs1_engine_setAIdataStrBatch(gs1_engine* const engine, const gs1_encoder_batch_input_t* const inputs, const size_t count, gs1_encoder_batch_result_t* const results, gs1_encoder_batch_span_t* const spans, const size_t maxSpans) {
+	return runJob(engine, gs1_encoder_setAIdataStrBatch, inputs, count, results, spans, maxSpans);
+}
+
+
+size_t gs1_engine_setScanDataBatch(gs1_engine* const engine, const gs1_encoder_batch_input_t* const inputs, const size_t count, gs1_encoder_batch_result_t* const results, gs1_encoder_batch_span_t* const spans, const size_t maxSpans) {
+	return runJob(engine, gs1_encoder_setScanDataBatch, inputs, count, results, spans, maxSpans);
+}
+
+
+#ifdef UNIT_TESTS
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+
+static const char* const engineTestData[] = {
+	"^011231231231233310ABC123^99XYZ",
+	"^0112312312312334",
+	"https://example.org/01/12312312312333/10/ABC%2D123?99=XYZ",
+	"^011231231231233310ABC123^17991301",
+	"barcode",
+	"^011231231231233310ABC|^99XYZ",
+	"^02123123123123331012",
+	"^0112312312312333",
+};
+
+
+static void checkSameResults(const gs1_encoder_batch_result_t* const a, const gs1_encoder_batch_span_t* const as, const gs1_encoder_batch_result_t* const b, const gs1_encoder_batch_span_t* const bs, const size_t count) {
+
+	size_t i, j;
+
+	for (i = 0; i < count; i++) {
+		TEST_CHECK(a[i].status == b[i].status);
+		TEST_CHECK(a[i].linterErr == b[i].linterErr);
+		TEST_CHECK(a[i].errOffset == b[i].errOffset);
+		TEST_CHECK(a[i].firstSpan == b[i].firstSpan);
+		TEST_CHECK(a[i].numSpans == b[i].numSpans);
+		TEST_MSG("Result %d differs", (int)i);
+		if (a[i].numSpans != b[i].numSpans)
+			continue;
+		for (j = 0; j < a[i].numSpans; j++) {
+			const gs1_encoder_batch_span_t* const sa = &as[a[i].firstSpan + j];
+			const gs1_encoder_batch_span_t* const sb = &bs[b[i].firstSpan + j];
+			TEST_CHECK(sa->aiOffset == sb->aiOffset && sa->aiLength == sb->aiLength &&
+				   sa->valueOffset == sb->valueOffset && sa->valueLength == sb->valueLength);
+			TEST_MSG("Span %d of result %d differs", (int)j, (int)i);
+		}
+	}
+
+}
+
+
+void test_engine_batch(void) {
+
+	gs1_encoder* ctx;
+	gs1_engine* engine;
+	gs1_encoder_batch_input_t inputs[3];
+	gs1_encoder_batch_result_t results[3];
+	gs1_encoder_batch_span_t spans[8];
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_ASSERT((engine = gs1_engine_init(ctx, 2)) != NULL);
+	assert(engine);
+#ifndef ENGINE_NO_THREADS
+	TEST_CHECK(gs1_engine_getNumThreads(engine) == 2);
+#endif
+
+	inputs[0] = (gs1_encoder_batch_input_t){ "(01)12312312312333(10)ABC", 25 };
+	inputs[1] = (gs1_encoder_batch_input_t){ "(01)12312312312334", 18 };
+	inputs[2] = (gs1_encoder_batch_input_t){ "(89)ABC", 7 };
+	TEST_CHECK(gs1_engine_setAIdataStrBatch(engine, inputs, 3, results, spans, 8) == 1);
+	TEST_CHECK(results[0].status == gs1_encoder_bVALID && results[0].numSpans == 2);
+	TEST_CHECK(spans[1].aiOffset == 19 && spans[1].valueOffset == 22 && spans[1].valueLength == 3);
+	TEST_CHECK(results[1].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[1].linterErr == GS1_LINTER_INCORRECT_CHECK_DIGIT);
+	TEST_CHECK(results[2].status == gs1_encoder_bINVALID);
+
+	// Options are taken from the given context when the engine is created
+	gs1_engine_free(engine);
+	TEST_ASSERT(gs1_encoder_setPermitUnknownAIs(ctx, true));
+	TEST_ASSERT((engine = gs1_engine_init(ctx, 2)) != NULL);
+	assert(engine);
+	TEST_CHECK(gs1_engine_setAIdataStrBatch(engine, &inputs[2], 1, results, spans, 8) == 1);
+
+	inputs[0] = (gs1_encoder_batch_input_t){ "]e0011231231231233310ABC", 24 };
+	TEST_CHECK(gs1_engine_setScanDataBatch(engine, inputs, 1, results, spans, 8) == 1);
+	TEST_CHECK(results[0].numSpans == 2);
+
+	TEST_CHECK(gs1_engine_setDataStrBatch(engine, inputs, 0, results, spans, 8) == 0);
+
+	gs1_engine_free(engine);
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_engine_deterministic(void) {
+
+	enum { COUNT = 20 * ENGINE_CHUNK_SIZE + 7 };
+
+	static const int threads[] = { 1, 2, 3, 8 };
+	static const size_t spanLimits[] = { 3 * COUNT, COUNT };
+
+	gs1_encoder* ctx;
+	gs1_engine* engine;
+	gs1_encoder_batch_input_t *inputs;
+	gs1_encoder_batch_result_t *expect, *results;
+	gs1_encoder_batch_span_t *expectSpans, *spans;
+	size_t i, j, k, numValid;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_ASSERT((inputs = malloc(COUNT * sizeof(inputs[0]))) != NULL);
+	TEST_ASSERT((expect = malloc(COUNT * sizeof(expect[0]))) != NULL);
+	TEST_ASSERT((results = malloc(COUNT * sizeof(results[0]))) != NULL);
+	TEST_ASSERT((expectSpans = malloc(3 * COUNT * sizeof(expectSpans[0]))) != NULL);
+	TEST_ASSERT((spans = malloc(3 * COUNT * sizeof(spans[0]))) != NULL);
+	assert(inputs && expect && results && expectSpans && spans);
+
+	for (i = 0; i < COUNT; i++) {
+		const char* const s = engineTestData[(i * 7 + i / 5) % SIZEOF_ARRAY(engineTestData)];
+		inputs[i] = (gs1_encoder_batch_input_t){ s, strlen(s) };
+	}
+
+	/*
+	 *  Whatever the number of threads, the outcome must be that of a single
+	 *  context, including when the span array is exhausted part way
+	 *
+	 */
+	for (k = 0; k < SIZEOF_ARRAY(spanLimits); k++) {
+
+		numValid = gs1_encoder_setDataStrBatch(ctx, inputs, COUNT, expect, expectSpans, spanLimits[k]);
+
+		for (j = 0; j < SIZEOF_ARRAY(threads); j++) {
+			TEST_ASSERT((engine = gs1_engine_init(ctx, threads[j])) != NULL);
+			memset(results, 0xAA, COUNT * sizeof(results[0]));
+			TEST_CHECK(gs1_engine_setDataStrBatch(engine, inputs, COUNT, results, spans, spanLimits[k]) == numValid);
+			TEST_MSG("Threads: %d", threads[j]);
+			checkSameResults(expect, expectSpans, results, spans, COUNT);
+			gs1_engine_free(engine);
+		}
+
+	}
+
+	free(spans);
+	free(expectSpans);
+	free(results);
+	free(expect);
+	free(inputs);
+	gs1_encoder_free(ctx);
+
+}
+
+#endif  /* UNIT_TESTS */
@@ -0,0 +1,38 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "gs1encoders.h"
+
+
+#define ENGINE_CHUNK_SIZE	64		// Messages claimed by a worker at a time
+
+
+#ifdef UNIT_TESTS
+
+void test_engine_batch(void);
+void test_engine_deterministic(void);
+
+#endif
+
+
+#endif  /* ENGINE_H */
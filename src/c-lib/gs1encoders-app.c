@@ -23,10 +23,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
 #include "gs1encoders.h"
 
 #define RELEASE __DATE__
 
+#define BATCH_BUFFER_SIZE	(1 << 20)	// Bytes read from the input at a time
+#define BATCH_MAX_LINES		8192		// Messages passed to the engine at a time
+
 static char *inpStr;
 
 // Replacement for the deprecated gets(3) function
@@ -154,9 +163,399 @@ static bool userInt(gs1_encoder* const ctx) {
 	return true;
 }
 
+
+/*
+ *  Batch mode: newline-delimited messages are read from stdin or files and
+ *  validated by a gs1_engine, with one result written per line
+ *
+ */
+typedef enum {
+	input_BRACKETED,
+	input_UNBRACKETED,
+	input_DL,
+	input_SCAN,
+} batchInput_t;
+
+typedef enum {
+	output_TSV,
+	output_JSON,
+} batchOutput_t;
+
+struct batchState {
+	gs1_encoder *ctx;
+	gs1_engine *engine;
+	batchInput_t input;
+	batchOutput_t output;
+	char *buf;
+	char *msg;				// NUL-terminated copy of a message that failed
+	gs1_encoder_batch_input_t *inputs;
+	gs1_encoder_batch_result_t *results;
+	gs1_encoder_batch_span_t *spans;
+	size_t maxSpans;
+	size_t count;
+	unsigned long line;
+	unsigned long numValid;
+	unsigned long numInvalid;
+	unsigned long long numBytes;
+};
+
+
+static double now(void) {
+#ifdef _WIN32
+	LARGE_INTEGER freq, t;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+#endif
+}
+
+
+static void writeTSVfield(const char* const s, const size_t len) {
+
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (s[i] == '\t')
+			fputs("\\t", stdout);
+		else if (s[i] == '\\')
+			fputs("\\\\", stdout);
+		else
+			putchar(s[i]);
+	}
+
+}
+
+
+static void writeJSONstr(const char* const s, const size_t len) {
+
+	size_t i;
+
+	putchar('"');
+	for (i = 0; i < len; i++) {
+		const unsigned char c = (unsigned char)s[i];
+		if (c == '"' || c == '\\')
+			printf("\\%c", c);
+		else if (c < 0x20)
+			printf("\\u%04x", c);
+		else
+			putchar(c);
+	}
+	putchar('"');
+
+}
+
+
+/*
+ *  Invalid messages are rare, so their error message and markup are
+ *  obtained by reprocessing them with the single-message setter
+ *
+ */
+static void getBatchError(struct batchState* const st, const gs1_encoder_batch_input_t* const in, const gs1_encoder_batch_result_t* const res, const char** const errMsg, const char** const errMarkup) {
+
+	*errMarkup = "";
+
+	if (res->status == gs1_encoder_bTOO_LONG) {
+		*errMsg = "Input is too long";
+		return;
+	}
+	if (res->status == gs1_encoder_bNO_SPANS) {
+		*errMsg = "Too many AIs in the batch";
+		return;
+	}
+
+	memcpy(st->msg, in->data, in->length);
+	st->msg[in->length] = '\0';
+	if (st->input == input_BRACKETED)
+		gs1_encoder_setAIdataStr(st->ctx, st->msg);
+	else if (st->input == input_SCAN)
+		gs1_encoder_setScanData(st->ctx, st->msg);
+	else
+		gs1_encoder_setDataStr(st->ctx, st->msg);
+
+	*errMsg = gs1_encoder_getErrMsg(st->ctx);
+	*errMarkup = gs1_encoder_getErrMarkup(st->ctx);
+
+}
+
+
+static void writeBatchResult(struct batchState* const st, const gs1_encoder_batch_input_t* const in, const gs1_encoder_batch_result_t* const res, const unsigned long line) {
+
+	const char *errMsg, *errMarkup;
+	size_t i;
+
+	if (res->status == gs1_encoder_bVALID) {
+
+		if (st->output == output_TSV) {
+			printf("%lu\tVALID", line);
+			for (i = 0; i < res->numSpans; i++) {
+				const gs1_encoder_batch_span_t* const span = &st->spans[res->firstSpan + i];
+				putchar('\t');
+				writeTSVfield(in->data + span->aiOffset, span->aiLength);
+				putchar('\t');
+				writeTSVfield(in->data + span->valueOffset, span->valueLength);
+			}
+			putchar('\n');
+		} else {
+			printf("{\"line\":%lu,\"valid\":true,\"ais\":[", line);
+			for (i = 0; i < res->numSpans; i++) {
+				const gs1_encoder_batch_span_t* const span = &st->spans[res->firstSpan + i];
+				fputs(i ? ",{\"ai\":" : "{\"ai\":", stdout);
+				writeJSONstr(in->data + span->aiOffset, span->aiLength);
+				fputs(",\"value\":", stdout);
+				writeJSONstr(in->data + span->valueOffset, span->valueLength);
+				putchar('}');
+			}
+			fputs("]}\n", stdout);
+		}
+
+		return;
+
+	}
+
+	getBatchError(st, in, res, &errMsg, &errMarkup);
+
+	if (st->output == output_TSV) {
+		printf("%lu\t%s\t%lu\t", line, res->status == gs1_encoder_bTOO_LONG ? "TOO_LONG" : "INVALID", (unsigned long)res->errOffset);
+		writeTSVfield(errMsg, strlen(errMsg));
+		putchar('\t');
+		writeTSVfield(errMarkup, strlen(errMarkup));
+		putchar('\n');
+	} else {
+		printf("{\"line\":%lu,\"valid\":false,\"offset\":%lu,\"error\":", line, (unsigned long)res->errOffset);
+		writeJSONstr(errMsg, strlen(errMsg));
+		fputs(",\"markup\":", stdout);
+		writeJSONstr(errMarkup, strlen(errMarkup));
+		fputs("}\n", stdout);
+	}
+
+}
+
+
+static void flushBatch(struct batchState* const st) {
+
+	const unsigned long first = st->line - st->count + 1;
+	size_t i;
+
+	if (st->count == 0)
+		return;
+
+	if (st->input == input_BRACKETED)
+		gs1_engine_setAIdataStrBatch(st->engine, st->inputs, st->count, st->results, st->spans, st->maxSpans);
+	else if (st->input == input_SCAN)
+		gs1_engine_setScanDataBatch(st->engine, st->inputs, st->count, st->results, st->spans, st->maxSpans);
+	else
+		gs1_engine_setDataStrBatch(st->engine, st->inputs, st->count, st->results, st->spans, st->maxSpans);
+
+	for (i = 0; i < st->count; i++) {
+		if (st->results[i].status == gs1_encoder_bVALID)
+			st->numValid++;
+		else
+			st->numInvalid++;
+		writeBatchResult(st, &st->inputs[i], &st->results[i], first + (unsigned long)i);
+	}
+
+	st->count = 0;
+
+}
+
+
+static void addBatchLine(struct batchState* const st, const char* const data, size_t len) {
+
+	if (len && data[len - 1] == '\r')
+		len--;
+
+	st->inputs[st->count++] = (gs1_encoder_batch_input_t){ data, len };
+	st->line++;
+	st->numBytes += len;
+
+	if (st->count == BATCH_MAX_LINES)
+		flushBatch(st);
+
+}
+
+
+static bool processBatchStream(struct batchState* const st, FILE* const fp) {
+
+	size_t have = 0, start, n;
+	bool eof = false, skipping = false;
+
+	while (!eof) {
+
+		n = fread(st->buf + have, 1, BATCH_BUFFER_SIZE - have, fp);
+		if (n == 0) {
+			if (ferror(fp))
+				return false;
+			eof = true;
+		}
+		have += n;
+
+		for (start = 0;;) {
+			const char* const nl = memchr(st->buf + start, '\n', have - start);
+			size_t len;
+			if (!nl)
+				break;
+			len = (size_t)(nl - (st->buf + start));
+			if (!skipping)
+				addBatchLine(st, st->buf + start, len);
+			skipping = false;
+			start += len + 1;
+		}
+
+		if (eof && start < have && !skipping) {
+			addBatchLine(st, st->buf + start, have - start);
+			start = have;
+		}
+
+		// A line that fills the buffer is reported as too long and its remainder is skipped
+		if (start == 0 && have == BATCH_BUFFER_SIZE) {
+			if (!skipping)
+				addBatchLine(st, st->buf, have);
+			skipping = true;
+			start = have;
+		}
+
+		// The pending messages refer to the buffer, so are processed before it is refilled
+		flushBatch(st);
+		memmove(st->buf, st->buf + start, have - start);
+		have -= start;
+
+	}
+
+	return true;
+
+}
+
+
+static void batchUsage(void) {
+	fprintf(stderr, "Usage: gs1encoders-app --batch [--input=bracketed|unbracketed|dl|scan] [--output=tsv|json] [--threads N] [FILE...]\n");
+}
+
+
+static int batchMode(gs1_encoder* const ctx, const int argc, const char* const argv[]) {
+
+	struct batchState st;
+	int numThreads = 0, numFiles = 0, i, ret = 2;
+	double start, elapsed;
+
+	memset(&st, 0, sizeof(st));
+	st.ctx = ctx;
+	st.input = input_UNBRACKETED;
+	st.output = output_TSV;
+
+	for (i = 1; i < argc; i++) {
+		const char* const arg = argv[i];
+		if (strcmp(arg, "--batch") == 0)
+			continue;
+		else if (strcmp(arg, "--input=bracketed") == 0)
+			st.input = input_BRACKETED;
+		else if (strcmp(arg, "--input=unbracketed") == 0)
+			st.input = input_UNBRACKETED;
+		else if (strcmp(arg, "--input=dl") == 0)
+			st.input = input_DL;
+		else if (strcmp(arg, "--input=scan") == 0)
+			st.input = input_SCAN;
+		else if (strcmp(arg, "--output=tsv") == 0)
+			st.output = output_TSV;
+		else if (strcmp(arg, "--output=json") == 0)
+			st.output = output_JSON;
+		else if (strncmp(arg, "--threads=", 10) == 0)
+			numThreads = atoi(arg + 10);
+		else if (strcmp(arg, "--threads") == 0 && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else if (strncmp(arg, "--", 2) == 0 && arg[2] != '\0') {
+			batchUsage();
+			return 2;
+		} else
+			numFiles++;
+	}
+
+	st.maxSpans = BATCH_BUFFER_SIZE / 2;	// Every AI occupies at least two bytes of the message
+	st.buf = malloc(BATCH_BUFFER_SIZE);
+	st.msg = malloc(2 * (size_t)gs1_encoder_getMaxDataStrLength() + 1);	// Bracketed AI data may be longer than a barcode message
+	st.inputs = malloc(BATCH_MAX_LINES * sizeof(st.inputs[0]));
+	st.results = malloc(BATCH_MAX_LINES * sizeof(st.results[0]));
+	st.spans = malloc(st.maxSpans * sizeof(st.spans[0]));
+	if (!st.buf || !st.msg || !st.inputs || !st.results || !st.spans) {
+		fprintf(stderr, "Failed to allocate the batch buffers!\n");
+		goto out;
+	}
+
+	if ((st.engine = gs1_engine_init(ctx, numThreads)) == NULL) {
+		fprintf(stderr, "Failed to initialise the batch engine!\n");
+		goto out;
+	}
+
+	start = now();
+
+	ret = 0;
+	if (numFiles == 0 && !processBatchStream(&st, stdin)) {
+		fprintf(stderr, "Failed to read from stdin\n");
+		ret = 2;
+	}
+	for (i = 1; i < argc && ret != 2; i++) {
+		const char* const arg = argv[i];
+		FILE *fp;
+		bool ok;
+		if (strncmp(arg, "--", 2) == 0 && arg[2] != '\0') {
+			if (strcmp(arg, "--threads") == 0)
+				i++;
+			continue;
+		}
+		if (strcmp(arg, "-") == 0) {
+			ok = processBatchStream(&st, stdin);
+		} else {
+			if ((fp = fopen(arg, "rb")) == NULL) {
+				fprintf(stderr, "Failed to open %s\n", arg);
+				ret = 2;
+				break;
+			}
+			ok = processBatchStream(&st, fp);
+			fclose(fp);
+		}
+		if (!ok) {
+			fprintf(stderr, "Failed to read from %s\n", arg);
+			ret = 2;
+		}
+	}
+
+	if (fflush(stdout) != 0 || ferror(stdout)) {
+		fprintf(stderr, "Failed to write the results\n");
+		ret = 2;
+	}
+
+	elapsed = now() - start;
+	if (elapsed <= 0)
+		elapsed = 1e-9;
+
+	fprintf(stderr, "Processed %lu messages (%lu valid, %lu invalid) in %.3f s using %d thread(s): %.0f messages/s, %.2f MiB/s\n",
+		st.line, st.numValid, st.numInvalid, elapsed, gs1_engine_getNumThreads(st.engine),
+		(double)st.line / elapsed, (double)st.numBytes / elapsed / (1024 * 1024));
+
+	if (ret == 0 && st.numInvalid)
+		ret = 1;
+
+out:
+
+	gs1_engine_free(st.engine);
+	free(st.spans);
+	free(st.results);
+	free(st.inputs);
+	free(st.msg);
+	free(st.buf);
+
+	return ret;
+
+}
+
+
 int main(int argc, const char* const argv[]) {
 
 	gs1_encoder* ctx;
+	int ret = 0, i;
 
 	inpStr = malloc((size_t)gs1_encoder_getMaxDataStrLength()+1);
 	if (inpStr == NULL) {
@@ -176,6 +575,13 @@ int main(int argc, const char* const argv[]) {
 		goto out;
 	}
 
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--batch") == 0) {
+			ret = batchMode(ctx, argc, argv);
+			goto out;
+		}
+	}
+
 	printf("\nGS1 Syntax Engine Console Demo (Built " RELEASE "):");
 	printf("\n\nCopyright (c) 2020-2024 GS1 AISBL. License: Apache-2.0");
 
@@ -186,5 +592,5 @@ out:
 	gs1_encoder_free(ctx);
 	free(inpStr);
 
-	return 0;
+	return ret;
 }
@@ -0,0 +1,522 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ *  Benchmark suite
+ *
+ *  Times the principal operations of the library over small corpora of
+ *  representative messages and writes the results as JSON, e.g.
+ *
+ *    gs1encoders-bench.bin --time=500 > bench.json
+ *
+ *  Each operation is timed individually, after a warm-up pass that also checks
+ *  that every message in the corpus is still processed successfully. For each
+ *  benchmark the mean time per operation, the median and 99th percentile
+ *  latencies and the number of heap allocations per operation are reported,
+ *  along with the peak RSS of the process. The times include the overhead of
+ *  reading the clock, which is the same for every build.
+ *
+ *  Context initialisation is timed with a Syntax Dictionary that is already
+ *  loaded. Loading the embedded AI table is timed by loading a Syntax
+ *  Dictionary file that is known not to exist, since the default file would
+ *  otherwise be picked up from the working directory; this includes the
+ *  failed attempt to open the file.
+ *
+ *  Two sets of results are compared with bench-compare.pl.
+ *
+ *  The library reports problems with the Syntax Dictionary on stdout, so the
+ *  results are written to a duplicate of stdout, which is itself redirected
+ *  to the null device while benchmarking to keep the JSON intact.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gs1encoders.h"
+#include "syntax/gs1syntaxdictionary.h"
+
+
+#define MAX_SAMPLES	(1 << 20)	// Latencies retained for each benchmark
+#define DEFAULT_TIME_MS	200		// Minimum duration of each benchmark
+
+
+/*
+ *  Heap allocations are counted by interposing on the allocator, which is
+ *  only possible with glibc. Elsewhere the counts are reported as null.
+ *
+ */
+#ifdef __GLIBC__
+#define COUNT_ALLOCS
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static uint64_t numAllocs = 0;
+
+void *malloc(size_t size) {
+	numAllocs++;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+	numAllocs++;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+	numAllocs++;
+	return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+	__libc_free(ptr);
+}
+#endif
+
+
+/*
+ *  Corpora
+ *
+ */
+
+static const char* const aiDataCorpus[] = {
+	"(01)12312312312333",
+	"(01)12312312312333(10)ABC123(17)251231",
+	"(01)12312312312333(17)251231(10)ABC123(21)XYZ9876543210",
+	"(00)123456789012345675",
+	"(01)12312312312333(3103)000189(3922)2499(11)240101",
+	"(01)12312312312333(10)ABC123(21)SERIAL(7003)2501011200(99)INTERNAL",
+	"(414)1234567890128(254)ABCDE",
+	"(01)12312312312333(10)ABC123|(99)COMPOSITE(98)XYZ",
+	"(8004)9521234ABC123(8003)09521234567899SERIAL12345678",
+	"(01)12312312312333(10)\\(ESCAPED)(21)12345(240)ADDITIONAL(250)SECONDARY",
+};
+
+static const char* const dataStrCorpus[] = {
+	"^0112312312312333",
+	"^011231231231233317251231^10ABC123",
+	"^01123123123123331725123110ABC123^21XYZ9876543210",
+	"^00123456789012345675",
+	"^01123123123123333103000189^39222499^11240101",
+	"^011231231231233310ABC123^21SERIAL^70032501011200^99INTERNAL",
+	"^4141234567890128254ABCDE",
+	"^011231231231233310ABC123|^99COMPOSITE^98XYZ",
+	"^80049521234ABC123^800309521234567899SERIAL12345678",
+	"^011231231231233310(ESCAPED)^2112345^240ADDITIONAL^250SECONDARY",
+};
+
+static const char* const dlURIcorpus[] = {
+	"https://id.gs1.org/01/12312312312333",
+	"https://id.gs1.org/01/12312312312333/10/ABC123/21/XYZ9876543210",
+	"https://example.com/01/12312312312333/22/ABC/10/DEF/21/GHI",
+	"https://example.com/some/path/01/12312312312333/10/ABC123?17=251231&3103=000189",
+	"https://id.gs1.org/00/123456789012345675",
+	"https://id.gs1.org/414/1234567890128/254/ABCDE",
+	"https://example.com/01/12312312312333?99=INTERNAL&linktype=all&3103=000189&3922=2499",
+	"https://id.gs1.org/8004/9521234567890123456789",
+	"https://example.com/01/12312312312333/10/A%2FB%2DC?11=240101#fragment",
+	"HTTPS://ID.GS1.ORG/01/12312312312333/21/12345",
+};
+
+/*
+ *  Scan data for each symbology is generated from these messages when the
+ *  suite starts
+ *
+ */
+static const struct {
+	gs1_encoder_symbologies_t sym;
+	const char *name;
+	const char *dataStr;
+} scanSources[] = {
+	{ gs1_encoder_sDataBarOmni,		"DataBarOmni",		"^0124012345678905|^99COMPOSITE^98XYZ" },
+	{ gs1_encoder_sDataBarTruncated,	"DataBarTruncated",	"^0124012345678905" },
+	{ gs1_encoder_sDataBarStacked,		"DataBarStacked",	"^0124012345678905" },
+	{ gs1_encoder_sDataBarStackedOmni,	"DataBarStackedOmni",	"^0124012345678905" },
+	{ gs1_encoder_sDataBarLimited,		"DataBarLimited",	"^0115012345678907|^99COMPOSITE^98XYZ" },
+	{ gs1_encoder_sDataBarExpanded,		"DataBarExpanded",	"^011231231231233310ABC123^99TESTING" },
+	{ gs1_encoder_sUPCA,			"UPCA",			"^0100416000336108" },
+	{ gs1_encoder_sUPCE,			"UPCE",			"^0100001234000057|^99COMPOSITE^98XYZ" },
+	{ gs1_encoder_sEAN13,			"EAN13",		"^0102112345678900" },
+	{ gs1_encoder_sEAN8,			"EAN8",			"^0100000002345673|^99COMPOSITE^98XYZ" },
+	{ gs1_encoder_sGS1_128_CCA,		"GS1_128_CCA",		"^011231231231233310ABC123^99TESTING" },
+	{ gs1_encoder_sGS1_128_CCC,		"GS1_128_CCC",		"^011231231231233310ABC123|^99COMPOSITE^98XYZ" },
+	{ gs1_encoder_sQR,			"QR",			"^011231231231233310ABC123^99TESTING" },
+	{ gs1_encoder_sDM,			"DM",			"^011231231231233310ABC123^99TESTING" },
+};
+
+#define NUM_SCAN_SOURCES (sizeof(scanSources) / sizeof(scanSources[0]))
+
+static char scanData[NUM_SCAN_SOURCES][2 * 256];
+
+static const struct linter {
+	const char *name;
+	gs1_linter_t fn;
+	const char *data;
+} linters[] = {
+	{ "couponcode",		gs1_lint_couponcode,	"012345612345611110123" },
+	{ "couponposoffer",	gs1_lint_couponposoffer, "001234561234560123456" },
+	{ "cset39",		gs1_lint_cset39,	"#-/0123456789ABCDEFG" },
+	{ "cset64",		gs1_lint_cset64,	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdef0123456789-_" },
+	{ "cset82",		gs1_lint_cset82,	"ABC123!\"%&'()*+,-./:;<=>?_abcdefghij" },
+	{ "csetnumeric",	gs1_lint_csetnumeric,	"01234567890123456789" },
+	{ "csum",		gs1_lint_csum,		"12312312312333" },
+	{ "csumalpha",		gs1_lint_csumalpha,	"1987654Ad4X4bL5ttr2310c2K" },
+	{ "hasnondigit",	gs1_lint_hasnondigit,	"0123456789A" },
+	{ "hh",			gs1_lint_hh,		"23" },
+	{ "hhmm",		gs1_lint_hhmm,		"2359" },
+	{ "hyphen",		gs1_lint_hyphen,	"--" },
+	{ "iban",		gs1_lint_iban,		"FR7630006000011234567890189" },
+	{ "importeridx",	gs1_lint_importeridx,	"0" },
+	{ "iso3166",		gs1_lint_iso3166,	"840" },
+	{ "iso3166999",		gs1_lint_iso3166999,	"999" },
+	{ "iso3166alpha2",	gs1_lint_iso3166alpha2,	"GB" },
+	{ "iso3166list",	gs1_lint_iso3166list,	"004840826" },
+	{ "iso4217",		gs1_lint_iso4217,	"978" },
+	{ "iso5218",		gs1_lint_iso5218,	"1" },
+	{ "key",		gs1_lint_key,		"9521234ABC123" },
+	{ "latitude",		gs1_lint_latitude,	"0279085848" },
+	{ "longitude",		gs1_lint_longitude,	"3015297971" },
+	{ "mediatype",		gs1_lint_mediatype,	"02" },
+	{ "mm",			gs1_lint_mm,		"59" },
+	{ "mmoptss",		gs1_lint_mmoptss,	"5959" },
+	{ "nonzero",		gs1_lint_nonzero,	"001" },
+	{ "nozeroprefix",	gs1_lint_nozeroprefix,	"210" },
+	{ "pcenc",		gs1_lint_pcenc,		"ABC%20DEF%2FGHI" },
+	{ "pieceoftotal",	gs1_lint_pieceoftotal,	"0102" },
+	{ "posinseqslash",	gs1_lint_posinseqslash,	"1/2" },
+	{ "ss",			gs1_lint_ss,		"59" },
+	{ "winding",		gs1_lint_winding,	"1" },
+	{ "yesno",		gs1_lint_yesno,		"1" },
+	{ "yymmd0",		gs1_lint_yymmd0,	"251200" },
+	{ "yymmdd",		gs1_lint_yymmdd,	"251231" },
+	{ "yymmddhh",		gs1_lint_yymmddhh,	"25123123" },
+	{ "yyyymmd0",		gs1_lint_yyyymmd0,	"20251200" },
+	{ "yyyymmdd",		gs1_lint_yyyymmdd,	"20251231" },
+	{ "zero",		gs1_lint_zero,		"0" },
+};
+
+#define NUM_LINTERS (sizeof(linters) / sizeof(linters[0]))
+
+
+/*
+ *  Operations
+ *
+ *  Each operation processes one message from its corpus, returning false on
+ *  failure. The optional preparation step is not timed.
+ *
+ */
+
+struct bench {
+	const char *name;
+	bool (*prep)(gs1_encoder *ctx, const char *in);
+	bool (*op)(gs1_encoder *ctx, const char *in, const void *arg);
+	const void *arg;
+	const char* const *corpus;
+	size_t n;
+};
+
+static const char *syntaxDictionaryFile = "gs1-syntax-dictionary.txt";
+
+static gs1_syntax_dictionary *embeddedSd;	// Shared by the contexts initialised by opInit
+
+static bool opSetAIdataStr(gs1_encoder* const ctx, const char* const in, const void* const arg) {
+	(void)arg;
+	return gs1_encoder_setAIdataStr(ctx, in);
+}
+
+static bool opSetDataStr(gs1_encoder* const ctx, const char* const in, const void* const arg) {
+	(void)arg;
+	return gs1_encoder_setDataStr(ctx, in);
+}
+
+static bool opSetScanData(gs1_encoder* const ctx, const char* const in, const void* const arg) {
+	(void)arg;
+	return gs1_encoder_setScanData(ctx, in);
+}
+
+static bool opGetHRI(gs1_encoder* const ctx, const char* const in, const void* const arg) {
+	char **hri;
+	(void)in;
+	(void)arg;
+	return gs1_encoder_getHRI(ctx, &hri) > 0;
+}
+
+static bool opGetDLuri(gs1_encoder* const ctx, const char* const in, const void* const arg) {
+	(void)in;
+	(void)arg;
+	return gs1_encoder_getDLuri(ctx, NULL) != NULL;
+}
+
+static bool opLint(gs1_encoder* const ctx, const char* const in, const void* const arg) {
+	const struct linter* const l = arg;
+	size_t errPos, errLen;
+	(void)ctx;
+	return l->fn(in, &errPos, &errLen) == GS1_LINTER_OK;
+}
+
+static bool opInit(gs1_encoder* const ctx, const char* const in, const void* const arg) {
+	gs1_encoder *c;
+	(void)ctx;
+	(void)in;
+	(void)arg;
+	if ((c = gs1_encoder_initWithSyntaxDictionary(NULL, embeddedSd)) == NULL)
+		return false;
+	gs1_encoder_free(c);
+	return true;
+}
+
+static bool opLoadSyntaxDictionary(gs1_encoder* const ctx, const char* const in, const void* const arg) {
+	gs1_syntax_dictionary *sd;
+	(void)ctx;
+	(void)arg;
+	if ((sd = gs1_encoder_loadSyntaxDictionary(in)) == NULL)
+		return false;
+	gs1_encoder_freeSyntaxDictionary(sd);
+	return true;
+}
+
+static bool prepAIdataStr(gs1_encoder* const ctx, const char* const in) {
+	return gs1_encoder_setAIdataStr(ctx, in);
+}
+
+
+/*
+ *  Runner
+ *
+ */
+
+static uint64_t samples[MAX_SAMPLES];
+
+static FILE *out;		// Results, on the original stdout
+
+static inline uint64_t now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int cmpSamples(const void* const a, const void* const b) {
+	const uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+static bool runBench(gs1_encoder* const ctx, const struct bench* const b, const uint64_t minTime, bool* const first) {
+
+	uint64_t start, total = 0, ops = 0, allocs = 0;
+	size_t i, numSamples = 0;
+
+	// Warm up, checking that the corpus is still valid
+	for (i = 0; i < b->n; i++) {
+		if ((b->prep && !b->prep(ctx, b->corpus[i])) || !b->op(ctx, b->corpus[i], b->arg)) {
+			fprintf(stderr, "%s: Failed to process \"%s\"\n", b->name, b->corpus[i]);
+			return false;
+		}
+	}
+
+	start = now();
+	do {
+		for (i = 0; i < b->n; i++) {
+			uint64_t t, a = 0;
+			if (b->prep)
+				b->prep(ctx, b->corpus[i]);
+#ifdef COUNT_ALLOCS
+			a = numAllocs;
+#endif
+			t = now();
+			b->op(ctx, b->corpus[i], b->arg);
+			t = now() - t;
+#ifdef COUNT_ALLOCS
+			a = numAllocs - a;
+#endif
+			allocs += a;
+			total += t;
+			ops++;
+			if (numSamples < MAX_SAMPLES)
+				samples[numSamples++] = t;
+		}
+	} while (now() - start < minTime);
+
+	qsort(samples, numSamples, sizeof(samples[0]), cmpSamples);
+
+	fprintf(out, "%s\n    {\"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.1f, \"p50_ns\": %llu, \"p99_ns\": %llu, ",
+	       *first ? "" : ",", b->name, (unsigned long long)ops, (double)total / (double)ops,
+	       (unsigned long long)samples[numSamples / 2], (unsigned long long)samples[numSamples * 99 / 100]);
+#ifdef COUNT_ALLOCS
+	fprintf(out, "\"allocs_per_op\": %.2f}", (double)allocs / (double)ops);
+#else
+	(void)allocs;
+	fprintf(out, "\"allocs_per_op\": null}");
+#endif
+	*first = false;
+
+	return true;
+
+}
+
+
+static void usage(void) {
+	fprintf(stderr, "Usage: gs1encoders-bench [--time=MS] [--filter=TEXT] [--syntax-dictionary=FILE] [--list]\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "  --time=MS                   Minimum duration of each benchmark (default %d)\n", DEFAULT_TIME_MS);
+	fprintf(stderr, "  --filter=TEXT               Only run benchmarks whose name contains TEXT\n");
+	fprintf(stderr, "  --syntax-dictionary=FILE    Syntax Dictionary file to load (default %s)\n", syntaxDictionaryFile);
+	fprintf(stderr, "  --list                      List the benchmarks without running them\n");
+}
+
+
+#define CORPUS(c) c, sizeof(c) / sizeof(c[0])
+
+int main(int argc, char *argv[]) {
+
+	static struct bench benches[8 + NUM_SCAN_SOURCES + NUM_LINTERS];
+	static char scanNames[NUM_SCAN_SOURCES][64];
+	static char lintNames[NUM_LINTERS][64];
+	static const char *scanCorpora[NUM_SCAN_SOURCES][1];
+	static const char *lintCorpora[NUM_LINTERS][1];
+	static const char* const emptyCorpus[] = { "" };
+	static const char *sdCorpus[] = { "" };
+	static const char *embeddedCorpus[] = { "" };
+	static char missingDir[256], missingFile[300];
+
+	gs1_encoder *ctx;
+	struct rusage ru;
+	const char *filter = NULL, *tmpDir;
+	uint64_t minTime = DEFAULT_TIME_MS * UINT64_C(1000000);
+	size_t i, numBenches = 0;
+	bool list = false, first = true, ok = true;
+	FILE *fp;
+	int arg, fd;
+
+	for (arg = 1; arg < argc; arg++) {
+		if (strncmp(argv[arg], "--time=", 7) == 0)
+			minTime = strtoull(argv[arg] + 7, NULL, 10) * UINT64_C(1000000);
+		else if (strncmp(argv[arg], "--filter=", 9) == 0)
+			filter = argv[arg] + 9;
+		else if (strncmp(argv[arg], "--syntax-dictionary=", 20) == 0)
+			syntaxDictionaryFile = argv[arg] + 20;
+		else if (strcmp(argv[arg], "--list") == 0)
+			list = true;
+		else {
+			usage();
+			return 1;
+		}
+	}
+
+	fflush(stdout);
+	if ((fd = dup(STDOUT_FILENO)) == -1 || (out = fdopen(fd, "w")) == NULL ||
+	    freopen("/dev/null", "w", stdout) == NULL) {
+		fprintf(stderr, "Failed to redirect stdout\n");
+		return 1;
+	}
+
+	if ((ctx = gs1_encoder_init(NULL)) == NULL) {
+		fprintf(stderr, "Failed to initialise the library\n");
+		return 1;
+	}
+
+	benches[numBenches++] = (struct bench){ "setAIdataStr", NULL, opSetAIdataStr, NULL, CORPUS(aiDataCorpus) };
+	benches[numBenches++] = (struct bench){ "setDataStr/unbracketed", NULL, opSetDataStr, NULL, CORPUS(dataStrCorpus) };
+	benches[numBenches++] = (struct bench){ "setDataStr/dl", NULL, opSetDataStr, NULL, CORPUS(dlURIcorpus) };
+
+	for (i = 0; i < NUM_SCAN_SOURCES; i++) {
+		const char *s;
+		if (!gs1_encoder_setSym(ctx, scanSources[i].sym) ||
+		    !gs1_encoder_setDataStr(ctx, scanSources[i].dataStr) ||
+		    (s = gs1_encoder_getScanData(ctx)) == NULL) {
+			fprintf(stderr, "Failed to generate scan data for %s: %s\n", scanSources[i].name, gs1_encoder_getErrMsg(ctx));
+			return 1;
+		}
+		snprintf(scanData[i], sizeof(scanData[i]), "%s", s);
+		snprintf(scanNames[i], sizeof(scanNames[i]), "setScanData/%s", scanSources[i].name);
+		scanCorpora[i][0] = scanData[i];
+		benches[numBenches++] = (struct bench){ scanNames[i], NULL, opSetScanData, NULL, scanCorpora[i], 1 };
+	}
+	gs1_encoder_setSym(ctx, gs1_encoder_sNONE);
+
+	benches[numBenches++] = (struct bench){ "getHRI", prepAIdataStr, opGetHRI, NULL, CORPUS(aiDataCorpus) };
+	benches[numBenches++] = (struct bench){ "getDLuri", prepAIdataStr, opGetDLuri, NULL, CORPUS(aiDataCorpus) };
+
+	for (i = 0; i < NUM_LINTERS; i++) {
+		snprintf(lintNames[i], sizeof(lintNames[i]), "lint/%s", linters[i].name);
+		lintCorpora[i][0] = linters[i].data;
+		benches[numBenches++] = (struct bench){ lintNames[i], NULL, opLint, &linters[i], lintCorpora[i], 1 };
+	}
+
+	// A fresh directory has no Syntax Dictionary file, so loading one from
+	// it falls back to the embedded AI table
+	tmpDir = getenv("TMPDIR");
+	snprintf(missingDir, sizeof(missingDir), "%s/gs1encoders-bench-XXXXXX", tmpDir && *tmpDir ? tmpDir : "/tmp");
+	if (mkdtemp(missingDir) == NULL) {
+		fprintf(stderr, "Failed to create a temporary directory\n");
+		return 1;
+	}
+	snprintf(missingFile, sizeof(missingFile), "%s/gs1-syntax-dictionary.txt", missingDir);
+	embeddedCorpus[0] = missingFile;
+	if ((embeddedSd = gs1_encoder_loadSyntaxDictionary(missingFile)) == NULL) {
+		fprintf(stderr, "Failed to load the embedded AI table\n");
+		rmdir(missingDir);
+		return 1;
+	}
+
+	benches[numBenches++] = (struct bench){ "init", NULL, opInit, NULL, CORPUS(emptyCorpus) };
+	benches[numBenches++] = (struct bench){ "loadSyntaxDictionary/embedded", NULL, opLoadSyntaxDictionary, NULL, CORPUS(embeddedCorpus) };
+	if ((fp = fopen(syntaxDictionaryFile, "r")) != NULL) {
+		fclose(fp);
+		sdCorpus[0] = syntaxDictionaryFile;
+		benches[numBenches++] = (struct bench){ "loadSyntaxDictionary/file", NULL, opLoadSyntaxDictionary, NULL, CORPUS(sdCorpus) };
+	}
+
+	if (list) {
+		for (i = 0; i < numBenches; i++)
+			fprintf(out, "%s\n", benches[i].name);
+		gs1_encoder_freeSyntaxDictionary(embeddedSd);
+		rmdir(missingDir);
+		gs1_encoder_free(ctx);
+		return 0;
+	}
+
+	fprintf(out, "{\n  \"version\": \"%s\",\n  \"benchmarks\": [", gs1_encoder_getVersion());
+	for (i = 0; i < numBenches; i++) {
+		if (filter && !strstr(benches[i].name, filter))
+			continue;
+		fprintf(stderr, "%s\n", benches[i].name);
+		if (!runBench(ctx, &benches[i], minTime, &first))
+			ok = false;
+	}
+
+	getrusage(RUSAGE_SELF, &ru);
+	fprintf(out, "\n  ],\n  \"peak_rss_kb\": %ld\n}\n", ru.ru_maxrss);
+
+	gs1_encoder_freeSyntaxDictionary(embeddedSd);
+	rmdir(missingDir);
+	gs1_encoder_free(ctx);
+
+	return ok ? 0 : 1;
+
+}
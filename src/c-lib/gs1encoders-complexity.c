@@ -0,0 +1,344 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ *  Algorithmic complexity checks
+ *
+ *  Generates inputs that are worst cases for each of the processing paths,
+ *  growing them towards the limits of MAX_AIS AIs or the maximum data length,
+ *  and checks that the processing time grows no faster than linearly, e.g.
+ *
+ *    gs1encoders-complexity.bin [--max-ratio=3] [--verbose]
+ *
+ *  Each case is timed at sizes n/4, n/2 and n, taking the fastest of many
+ *  repetitions at each size. Since the time at each size includes a fixed
+ *  overhead, growth is judged by the ratio of the increments in time between
+ *  successive doublings of the input, which is 2 for linear growth and 4 for
+ *  quadratic growth. A case is measured again if the ratio exceeds the limit,
+ *  to rule out interference from other activity on the machine, and the exit
+ *  status is non-zero if the ratio for any case exceeds the limit on each
+ *  attempt.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gs1encoders.h"
+
+
+#define MAX_INPUT	8192
+#define MIN_TIME_NS	UINT64_C(50000000)	// Time spent at each size
+#define BATCH		8			// Operations timed together
+#define DEFAULT_MAX_RATIO	3.0
+#define NUM_SIZES	3
+#define ATTEMPTS	3			// Measurements of a case before it fails
+
+
+struct complexityCase {
+	const char *name;
+	int maxUnits;
+	void (*generate)(char *buf, int units);
+	bool (*prep)(gs1_encoder *ctx, const char *in);	// Untimed, or NULL
+	bool (*op)(gs1_encoder *ctx, const char *in);
+};
+
+
+static void append(char* const buf, size_t* const len, const char* const s) {
+	const size_t n = strlen(s);
+	if (*len + n < MAX_INPUT) {
+		memcpy(buf + *len, s, n + 1);
+		*len += n;
+	}
+}
+
+static void repeat(char* const buf, const char* const head, const char* const unit, const int units, const char* const tail) {
+	size_t len = 0;
+	int i;
+	*buf = '\0';
+	append(buf, &len, head);
+	for (i = 0; i < units; i++)
+		append(buf, &len, unit);
+	append(buf, &len, tail);
+}
+
+
+/*
+ *  Generators
+ *
+ */
+
+// Repeated AIs, which must all be compared for equal values
+static void genRepeatedAIs(char* const buf, const int units) {
+	repeat(buf, "(01)12312312312333", "(99)ABCDEFGHIJKLMNOPQRSTUVWXYZ", units, "");
+}
+
+static void genRepeatedAIsUnbracketed(char* const buf, const int units) {
+	repeat(buf, "^0112312312312333", "^99ABCDEFGHIJKLMNOPQRSTUVWXYZ", units, "");
+}
+
+static void genRepeatedAIsScanData(char* const buf, const int units) {
+	repeat(buf, "]d20112312312312333", "99ABCDEFGHIJKLMNOPQRSTUVWXYZ\x1D", units, "99ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+}
+
+// AIs whose requisites and exclusions must be checked against every other AI
+static void genAssociatedAIs(char* const buf, const int units) {
+	repeat(buf, "(01)12312312312333(21)SERIAL", "(10)ABC123(17)251231(11)240101", units, "");
+}
+
+// Values that are all escaped characters
+static void genEscapedValues(char* const buf, const int units) {
+	repeat(buf, "(01)12312312312333", "(99)\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(\\(", units, "");
+}
+
+// Plain data with no AIs
+static void genPlainData(char* const buf, const int units) {
+	repeat(buf, "", "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", units, "");
+}
+
+// A long DL URI stem before the primary key
+static void genDLstem(char* const buf, const int units) {
+	repeat(buf, "https://example.com", "/01", units, "/01/12312312312333/10/ABC");
+}
+
+// Query parameters that are not AIs
+static void genDLignoredParams(char* const buf, const int units) {
+	repeat(buf, "https://example.com/01/12312312312333/10/ABC?", "linktype=all&", units, "99=XYZ");
+}
+
+// Query parameter attributes, each of which is trialled in the path info
+static void genDLattributes(char* const buf, const int units) {
+	static const char* const attrs[] = {
+		"11=240101&", "13=240101&", "15=240101&", "17=240101&", "3103=000189&",
+		"3922=2499&", "20=01&", "240=ABC&", "241=ABC&", "242=123&",
+		"250=ABC&", "251=ABC&", "30=12&", "7007=240101&", "7003=2501011200&",
+		"7006=240101&", "90=ABC&", "91=ABC&", "92=ABC&", "93=ABC&",
+		"94=ABC&", "95=ABC&", "96=ABC&", "97=ABC&", "98=ABC&",
+	};
+	size_t len = 0;
+	int i;
+	*buf = '\0';
+	append(buf, &len, "https://example.com/01/12312312312333/22/ABC/10/DEF/21/GHI?");
+	for (i = 0; i < units; i++)
+		append(buf, &len, attrs[i]);
+	append(buf, &len, "99=XYZ");
+}
+
+// Percent-encoded values in the path and query
+static void genDLpercentEncoded(char* const buf, const int units) {
+	repeat(buf, "https://example.com/01/12312312312333/10/%21%22%25%26?", "linktype=%21%22%25%26%27%28%29%2A%2B%2C&", units, "99=%21%22%25%26%27%28%29");
+}
+
+
+/*
+ *  Operations
+ *
+ */
+
+static bool opSetAIdataStr(gs1_encoder* const ctx, const char* const in) {
+	return gs1_encoder_setAIdataStr(ctx, in);
+}
+
+static bool opSetDataStr(gs1_encoder* const ctx, const char* const in) {
+	return gs1_encoder_setDataStr(ctx, in);
+}
+
+static bool opSetScanData(gs1_encoder* const ctx, const char* const in) {
+	return gs1_encoder_setScanData(ctx, in);
+}
+
+static bool prepAIdataStr(gs1_encoder* const ctx, const char* const in) {
+	return gs1_encoder_setAIdataStr(ctx, in);
+}
+
+static bool prepDataStr(gs1_encoder* const ctx, const char* const in) {
+	return gs1_encoder_setDataStr(ctx, in);
+}
+
+static bool opGetDLuri(gs1_encoder* const ctx, const char* const in) {
+	(void)in;
+	return gs1_encoder_getDLuri(ctx, NULL) != NULL;
+}
+
+static bool opGetHRI(gs1_encoder* const ctx, const char* const in) {
+	char **hri;
+	(void)in;
+	return gs1_encoder_getHRI(ctx, &hri) > 0;
+}
+
+static bool opGetAIdataStr(gs1_encoder* const ctx, const char* const in) {
+	(void)in;
+	return gs1_encoder_getAIdataStr(ctx) != NULL;
+}
+
+static bool opGetScanData(gs1_encoder* const ctx, const char* const in) {
+	(void)in;
+	return gs1_encoder_getScanData(ctx) != NULL;
+}
+
+
+static const struct complexityCase cases[] = {
+	{ "setAIdataStr/repeated-ais",		60,	genRepeatedAIs,			NULL,		opSetAIdataStr },
+	{ "setAIdataStr/associated-ais",	20,	genAssociatedAIs,		NULL,		opSetAIdataStr },
+	{ "setAIdataStr/escaped-values",	60,	genEscapedValues,		NULL,		opSetAIdataStr },
+	{ "setDataStr/repeated-ais",		60,	genRepeatedAIsUnbracketed,	NULL,		opSetDataStr },
+	{ "setDataStr/plain-data",		220,	genPlainData,			NULL,		opSetDataStr },
+	{ "setDataStr/dl-stem",			2000,	genDLstem,			NULL,		opSetDataStr },
+	{ "setDataStr/dl-ignored-params",	60,	genDLignoredParams,		NULL,		opSetDataStr },
+	{ "setDataStr/dl-attributes",		24,	genDLattributes,		NULL,		opSetDataStr },
+	{ "setDataStr/dl-percent-encoded",	60,	genDLpercentEncoded,		NULL,		opSetDataStr },
+	{ "setScanData/repeated-ais",		60,	genRepeatedAIsScanData,		NULL,		opSetScanData },
+	{ "getDLuri/repeated-ais",		60,	genRepeatedAIs,			prepAIdataStr,	opGetDLuri },
+	{ "getDLuri/dl-attributes",		24,	genDLattributes,		prepDataStr,	opGetDLuri },
+	{ "getHRI/repeated-ais",		60,	genRepeatedAIs,			prepAIdataStr,	opGetHRI },
+	{ "getAIdataStr/repeated-ais",		60,	genRepeatedAIsUnbracketed,	prepDataStr,	opGetAIdataStr },
+	{ "getScanData/repeated-ais",		60,	genRepeatedAIs,			prepAIdataStr,	opGetScanData },
+};
+
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+
+static inline uint64_t now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+
+/*
+ *  Fastest time for a single operation on each of the inputs, which are timed
+ *  in turn so that any change in the speed of the machine affects each alike
+ *
+ */
+static void timeOps(gs1_encoder* const ctx, const struct complexityCase* const c, char in[][MAX_INPUT], double* const t) {
+
+	uint64_t start, best[NUM_SIZES];
+	int i, j;
+
+	for (j = 0; j < NUM_SIZES; j++)
+		best[j] = UINT64_MAX;
+
+	start = now();
+	do {
+		for (j = 0; j < NUM_SIZES; j++) {
+			uint64_t u;
+			if (c->prep)
+				c->prep(ctx, in[j]);
+			u = now();
+			for (i = 0; i < BATCH; i++)
+				c->op(ctx, in[j]);
+			u = now() - u;
+			if (u < best[j])
+				best[j] = u;
+		}
+	} while (now() - start < MIN_TIME_NS);
+
+	for (j = 0; j < NUM_SIZES; j++)
+		t[j] = (double)best[j] / BATCH;
+
+}
+
+
+int main(int argc, char *argv[]) {
+
+	static char in[NUM_SIZES][MAX_INPUT];
+	gs1_encoder *ctx;
+	double maxRatio = DEFAULT_MAX_RATIO;
+	bool verbose = false;
+	const char *filter = NULL;
+	size_t i;
+	int arg, failures = 0;
+
+	for (arg = 1; arg < argc; arg++) {
+		if (strncmp(argv[arg], "--max-ratio=", 12) == 0)
+			maxRatio = strtod(argv[arg] + 12, NULL);
+		else if (strncmp(argv[arg], "--filter=", 9) == 0)
+			filter = argv[arg] + 9;
+		else if (strcmp(argv[arg], "--verbose") == 0)
+			verbose = true;
+		else {
+			fprintf(stderr, "Usage: gs1encoders-complexity [--max-ratio=R] [--filter=TEXT] [--verbose]\n");
+			return 1;
+		}
+	}
+
+	if ((ctx = gs1_encoder_init(NULL)) == NULL) {
+		fprintf(stderr, "Failed to initialise the library\n");
+		return 1;
+	}
+
+	for (i = 0; i < NUM_CASES; i++) {
+
+		const struct complexityCase* const c = &cases[i];
+		const int units[NUM_SIZES] = { c->maxUnits / 4, c->maxUnits / 2, c->maxUnits };
+		double t[NUM_SIZES], ratio = 0;
+		bool ok = true;
+		int j;
+
+		if (filter && !strstr(c->name, filter))
+			continue;
+
+		// Each input must be processed successfully for the full path to be exercised
+		for (j = 0; j < NUM_SIZES; j++) {
+			c->generate(in[j], units[j]);
+			if ((c->prep && !c->prep(ctx, in[j])) || !c->op(ctx, in[j])) {
+				fprintf(stderr, "%s: Failed to process input of %d units: %s\n", c->name, units[j], gs1_encoder_getErrMsg(ctx));
+				ok = false;
+			}
+		}
+		if (!ok) {
+			failures++;
+			continue;
+		}
+
+		for (j = 0; j < ATTEMPTS; j++) {
+			timeOps(ctx, c, in, t);
+			// Increments below the timer resolution are treated as linear growth
+			ratio = t[1] - t[0] > 1.0 ? (t[2] - t[1]) / (t[1] - t[0]) : 2.0;
+			if (ratio <= maxRatio)
+				break;
+		}
+		ok = ratio <= maxRatio;
+
+		printf("%-36s %s  ratio %5.2f", c->name, ok ? "ok  " : "FAIL", ratio);
+		if (verbose)
+			printf("  (%d: %.0f ns, %d: %.0f ns, %d: %.0f ns; %zu bytes)",
+			       units[0], t[0], units[1], t[1], units[2], t[2], strlen(in[2]));
+		printf("\n");
+
+		if (!ok)
+			failures++;
+
+	}
+
+	gs1_encoder_free(ctx);
+
+	if (failures) {
+		printf("%d case(s) grew faster than linearly (ratio > %.2f)\n", failures, maxRatio);
+		return 1;
+	}
+
+	return 0;
+
+}
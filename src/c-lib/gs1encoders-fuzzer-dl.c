@@ -77,7 +77,7 @@ int LLVMFuzzerTestOneInput(const uint8_t* const buf, size_t len) {
 	 */
 	if (!gs1_encoder_setDataStr(ctx, outDL1)) {
 		printf("\nFailed setting data to DL: %s\n", outDL1);
-		printf("\nError: %s\n", ctx->errMsg);
+		printf("\nError: %s\n", gs1_encoder_getErrMsg(ctx));
 		abort();
 	}
 
@@ -26,7 +26,7 @@
 #include "enc-private.h"
 #include "syn.h"
 
-static gs1_encoder *ctx = NULL;
+static gs1_syntax_dictionary dict;
 
 
 int LLVMFuzzerInitialize(int *argc, char ***argv) {
@@ -34,8 +34,6 @@ int LLVMFuzzerInitialize(int *argc, char ***argv) {
 	(void)argc;
 	(void)argv;
 
-	ctx = gs1_encoder_init(NULL);
-
 	return 0;
 
 }
@@ -53,8 +51,8 @@ int LLVMFuzzerTestOneInput(const uint8_t* const buf, size_t len) {
 	memcpy(in, buf, len);
 	in[len] = '\0';
 
-	parseSyntaxDictionaryEntry(ctx, in, sd, &tmp, sizeof(sd) / sizeof(sd[0]));
-	gs1_freeSyntaxDictionaryEntries(ctx, sd);
+	parseSyntaxDictionaryEntry(&dict, in, sd, &tmp, sizeof(sd) / sizeof(sd[0]));
+	gs1_freeSyntaxDictionaryEntries(sd);
 
 	return 0;
 
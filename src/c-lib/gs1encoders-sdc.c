@@ -0,0 +1,48 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2021-2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ *  Syntax Dictionary compiler
+ *
+ *  Converts the Syntax Dictionary text format into a binary image that can be
+ *  loaded with gs1_encoder_loadSyntaxDictionary() without being parsed, e.g.
+ *
+ *    gs1encoders-sdc.bin gs1-syntax-dictionary.txt gs1-syntax-dictionary.bin
+ *
+ */
+
+#include <stdio.h>
+
+#include "gs1encoders.h"
+
+
+int main(int argc, char *argv[]) {
+
+	if (argc != 3) {
+		fprintf(stderr, "Usage: %s <syntax-dictionary.txt> <output.bin>\n", argv[0]);
+		return 2;
+	}
+
+	if (!gs1_encoder_compileSyntaxDictionary(argv[1], argv[2]))
+		return 1;
+
+	return 0;
+
+}
@@ -43,8 +43,11 @@
 #include <stddef.h>
 
 #include "enc-private.h"
+#include "cache.h"
 #include "dl.h"
+#include "engine.h"
 #include "scandata.h"
+#include "stats.h"
 #include "syn.h"
 
 
@@ -57,6 +60,7 @@ TEST_LIST = {
     { "api_getVersion", test_api_getVersion },
     { "api_instanceSize", test_api_instanceSize },
     { "api_init", test_api_init },
+    { "api_sharedSyntaxDictionary", test_api_sharedSyntaxDictionary },
     { "api_defaults", test_api_defaults },
     { "api_sym", test_api_sym },
     { "api_addCheckDigit", test_api_addCheckDigit },
@@ -65,11 +69,20 @@ TEST_LIST = {
     { "api_validateAIassociations", test_api_validateAIassociations },
     { "api_validations", test_api_validations },
     { "api_dataStr", test_api_dataStr },
+    { "api_dataStrN", test_api_dataStrN },
+    { "api_AIdataStrN", test_api_AIdataStrN },
     { "api_getAIdataStr", test_api_getAIdataStr },
     { "api_getScanData", test_api_getScanData },
     { "api_setScanData", test_api_setScanData },
+    { "api_setDataStrBatch", test_api_setDataStrBatch },
+    { "api_setAIdataStrBatch", test_api_setAIdataStrBatch },
+    { "api_setScanDataBatch", test_api_setScanDataBatch },
     { "api_getHRI", test_api_getHRI },
     { "api_copyHRI", test_api_copyHRI },
+    { "api_render", test_api_render },
+    { "api_getNextAI", test_api_getNextAI },
+    { "api_getErrRecord", test_api_getErrRecord },
+    { "api_collectErrors", test_api_collectErrors },
     { "api_getDLignoredQueryParams", test_api_getDLignoredQueryParams },
     { "api_copyDLignoredQueryParams", test_api_copyDLignoredQueryParams },
 
@@ -79,6 +92,7 @@ TEST_LIST = {
      *
      */
     { "syn_parseSyntaxDictionaryEntry", test_syn_parseSyntaxDictionaryEntry },
+    { "syn_compileSyntaxDictionary", test_syn_compileSyntaxDictionary },
 
 
     /*
@@ -86,6 +100,7 @@ TEST_LIST = {
      *
      */
     { "ai_lookupAIentry", test_ai_lookupAIentry },
+    { "ai_embeddedAIindex", test_ai_embeddedAIindex },
     { "ai_test_ai_checkAIlengthByPrefix", test_ai_checkAIlengthByPrefix },
     { "ai_AItableVsPrefixLength", test_ai_AItableVsPrefixLength },
     { "ai_AItableVsIsFNC1required", test_ai_AItableVsIsFNC1required },
@@ -93,6 +108,17 @@ TEST_LIST = {
     { "ai_linters", test_ai_linters },
     { "ai_gs1_processAIdata", test_ai_processAIdata },
     { "ai_validateAIs", test_ai_validateAIs },
+    { "ai_compileAIrules", test_ai_compileAIrules },
+    { "ai_compileAIprograms", test_ai_compileAIprograms },
+    { "ai_generatedValidators", test_ai_generatedValidators },
+
+
+    /*
+     * cache.c
+     *
+     */
+    { "cache_hits", test_cache_hits },
+    { "cache_config", test_cache_config },
 
 
     /*
@@ -106,6 +132,14 @@ TEST_LIST = {
     { "dl_generateDLuri", test_dl_generateDLuri },
 
 
+    /*
+     * engine.c
+     *
+     */
+    { "engine_batch", test_engine_batch },
+    { "engine_deterministic", test_engine_deterministic },
+
+
     /*
      * scandata.c
      *
@@ -114,5 +148,13 @@ TEST_LIST = {
     { "scandata_generateScanData", test_scandata_generateScanData },
     { "scandata_processScanData", test_scandata_processScanData },
 
+
+    /*
+     * stats.c
+     *
+     */
+    { "stats_counters", test_stats_counters },
+    { "stats_phases", test_stats_phases },
+
     { NULL, NULL }
 };
@@ -0,0 +1,516 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ *  Bulk transcoder
+ *
+ *  Converts a file of newline-delimited messages between bracketed AI element
+ *  strings, unbracketed AI element strings, GS1 Digital Link URIs and scan
+ *  data, e.g.
+ *
+ *    gs1encoders-transcode.bin --from=bracketed --to=dl archive.txt > uris.txt
+ *
+ *  The input file is mapped into memory and divided at line boundaries into
+ *  chunks that are converted by a pool of threads, each with its own context
+ *  attached to a shared Syntax Dictionary. The output of each chunk is
+ *  buffered and written in the order of the input, so the output has one line
+ *  for each input line. A message that cannot be converted produces an empty
+ *  output line and a diagnostic on stderr.
+ *
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gs1encoders.h"
+
+
+#define CHUNK_SIZE	(1 << 20)	// Approximate bytes of input per chunk
+#define MAX_THREADS	256
+
+
+typedef enum {
+	fmt_BRACKETED,
+	fmt_UNBRACKETED,
+	fmt_DL,
+	fmt_SCAN,
+} format_t;
+
+static const char* const formatNames[] = {
+	[fmt_BRACKETED] = "bracketed",
+	[fmt_UNBRACKETED] = "unbracketed",
+	[fmt_DL] = "dl",
+	[fmt_SCAN] = "scan",
+};
+
+static const char* const symNames[] = {
+	[gs1_encoder_sDataBarOmni] = "DataBarOmni",
+	[gs1_encoder_sDataBarTruncated] = "DataBarTruncated",
+	[gs1_encoder_sDataBarStacked] = "DataBarStacked",
+	[gs1_encoder_sDataBarStackedOmni] = "DataBarStackedOmni",
+	[gs1_encoder_sDataBarLimited] = "DataBarLimited",
+	[gs1_encoder_sDataBarExpanded] = "DataBarExpanded",
+	[gs1_encoder_sUPCA] = "UPCA",
+	[gs1_encoder_sUPCE] = "UPCE",
+	[gs1_encoder_sEAN13] = "EAN13",
+	[gs1_encoder_sEAN8] = "EAN8",
+	[gs1_encoder_sGS1_128_CCA] = "GS1_128_CCA",
+	[gs1_encoder_sGS1_128_CCC] = "GS1_128_CCC",
+	[gs1_encoder_sQR] = "QR",
+	[gs1_encoder_sDM] = "DM",
+};
+
+
+struct buffer {
+	char *data;
+	size_t len;
+	size_t size;
+};
+
+struct lineError {
+	unsigned long line;			// Line within the chunk
+	char *msg;
+};
+
+struct worker {
+	struct transcoder *tc;
+	gs1_encoder *ctx;
+	char *msg;				// NUL-terminated copy of the current message
+	struct buffer out;
+	unsigned long numLines;			// Lines in the current chunk
+	struct lineError *errors;
+	size_t numErrors;
+	size_t maxErrors;
+	pthread_t thread;
+	bool started;
+	bool failed;
+};
+
+struct transcoder {
+
+	format_t from;
+	format_t to;
+	const char *stem;
+	int sym;
+	size_t maxMsgLen;
+
+	const char *data;
+	size_t size;
+	FILE *out;
+
+	pthread_mutex_t lock;
+	pthread_cond_t committed;
+	size_t nextPos;				// Start of the next chunk to be claimed
+	unsigned long nextChunk;
+	unsigned long numCommitted;		// Chunks written out
+	unsigned long numLines;			// Lines written out
+	unsigned long numErrors;
+	bool writeFailed;
+
+};
+
+
+static bool appendBuffer(struct buffer* const b, const char* const s, const size_t len) {
+
+	if (b->len + len + 1 > b->size) {
+		size_t size = b->size ? b->size : 4096;
+		char *p;
+		while (b->len + len + 1 > size)
+			size *= 2;
+		if ((p = realloc(b->data, size)) == NULL)
+			return false;
+		b->data = p;
+		b->size = size;
+	}
+	memcpy(b->data + b->len, s, len);
+	b->len += len;
+
+	return true;
+
+}
+
+
+static bool recordError(struct worker* const w, const unsigned long line, const char* const msg) {
+
+	char *copy;
+
+	if (w->numErrors == w->maxErrors) {
+		const size_t max = w->maxErrors ? 2 * w->maxErrors : 64;
+		struct lineError* const p = realloc(w->errors, max * sizeof(w->errors[0]));
+		if (!p)
+			return false;
+		w->errors = p;
+		w->maxErrors = max;
+	}
+	if ((copy = malloc(strlen(msg) + 1)) == NULL)
+		return false;
+	strcpy(copy, msg);
+	w->errors[w->numErrors++] = (struct lineError){ line, copy };
+
+	return true;
+
+}
+
+
+static const char* convertMessage(struct worker* const w, const char* const in, const size_t len) {
+
+	struct transcoder* const tc = w->tc;
+	gs1_encoder* const ctx = w->ctx;
+	const char *res;
+	bool ok;
+
+	if (len > tc->maxMsgLen)
+		return NULL;
+	memcpy(w->msg, in, len);
+	w->msg[len] = '\0';
+
+	if (tc->from == fmt_BRACKETED)
+		ok = gs1_encoder_setAIdataStr(ctx, w->msg);
+	else if (tc->from == fmt_SCAN)
+		ok = gs1_encoder_setScanData(ctx, w->msg);
+	else
+		ok = gs1_encoder_setDataStr(ctx, w->msg);
+	if (!ok)
+		return NULL;
+
+	if (tc->sym != gs1_encoder_sNONE && !gs1_encoder_setSym(ctx, tc->sym))
+		return NULL;
+
+	switch (tc->to) {
+		case fmt_BRACKETED:
+			res = gs1_encoder_getAIdataStr(ctx);
+			break;
+		case fmt_UNBRACKETED:
+			res = gs1_encoder_getDataStr(ctx);
+			break;
+		case fmt_DL:
+			res = gs1_encoder_getDLuri(ctx, tc->stem);
+			break;
+		default:
+			res = gs1_encoder_getScanData(ctx);
+			break;
+	}
+
+	return res;
+
+}
+
+
+static bool convertChunk(struct worker* const w, const char* p, const char* const end) {
+
+	unsigned long line = 0;
+
+	w->out.len = 0;
+	w->numLines = 0;
+	w->numErrors = 0;
+
+	while (p < end) {
+
+		const char* const nl = memchr(p, '\n', (size_t)(end - p));
+		const char* const eol = nl ? nl : end;
+		size_t len = (size_t)(eol - p);
+		const char *res;
+
+		if (len && p[len - 1] == '\r')
+			len--;
+
+		res = convertMessage(w, p, len);
+		if (res) {
+			if (!appendBuffer(&w->out, res, strlen(res)))
+				return false;
+		} else {
+			const char* const msg = len > w->tc->maxMsgLen ? "Input is too long" :
+						*gs1_encoder_getErrMsg(w->ctx) ? gs1_encoder_getErrMsg(w->ctx) :
+						"Not AI-based data";
+			if (!recordError(w, line, msg))
+				return false;
+		}
+		if (!appendBuffer(&w->out, "\n", 1))
+			return false;
+
+		line++;
+		p = eol + 1;
+
+	}
+
+	w->numLines = line;
+
+	return true;
+
+}
+
+
+static void* workerMain(void* const arg) {
+
+	struct worker* const w = arg;
+	struct transcoder* const tc = w->tc;
+
+	for (;;) {
+
+		unsigned long chunk;
+		const char *start, *end;
+		size_t i;
+
+		// Claim the next chunk, extending it to the end of a line
+		pthread_mutex_lock(&tc->lock);
+		if (tc->nextPos >= tc->size || tc->writeFailed) {
+			pthread_mutex_unlock(&tc->lock);
+			break;
+		}
+		chunk = tc->nextChunk++;
+		start = tc->data + tc->nextPos;
+		end = tc->size - tc->nextPos > CHUNK_SIZE ? start + CHUNK_SIZE : tc->data + tc->size;
+		if (end < tc->data + tc->size) {
+			const char* const nl = memchr(end - 1, '\n', (size_t)(tc->data + tc->size - end + 1));
+			end = nl ? nl + 1 : tc->data + tc->size;
+		}
+		tc->nextPos = (size_t)(end - tc->data);
+		pthread_mutex_unlock(&tc->lock);
+
+		if (!convertChunk(w, start, end))
+			w->failed = true;
+
+		// Write out in order
+		pthread_mutex_lock(&tc->lock);
+		while (tc->numCommitted != chunk)
+			pthread_cond_wait(&tc->committed, &tc->lock);
+
+		if (w->failed || fwrite(w->out.data, 1, w->out.len, tc->out) != w->out.len)
+			tc->writeFailed = true;
+		for (i = 0; i < w->numErrors; i++) {
+			fprintf(stderr, "Line %lu: %s\n", tc->numLines + w->errors[i].line + 1, w->errors[i].msg);
+			free(w->errors[i].msg);
+		}
+		tc->numErrors += w->numErrors;
+		tc->numLines += w->numLines;
+		w->numErrors = 0;
+
+		tc->numCommitted++;
+		pthread_cond_broadcast(&tc->committed);
+		pthread_mutex_unlock(&tc->lock);
+
+	}
+
+	return NULL;
+
+}
+
+
+static bool parseFormat(const char* const name, format_t* const fmt) {
+
+	size_t i;
+
+	for (i = 0; i < sizeof(formatNames) / sizeof(formatNames[0]); i++) {
+		if (strcmp(name, formatNames[i]) == 0) {
+			*fmt = (format_t)i;
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+
+static bool parseSym(const char* const name, int* const sym) {
+
+	size_t i;
+
+	for (i = 0; i < sizeof(symNames) / sizeof(symNames[0]); i++) {
+		if (strcmp(name, symNames[i]) == 0) {
+			*sym = (int)i;
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+
+static void usage(const char* const prog) {
+	fprintf(stderr, "Usage: %s --from=FORMAT --to=FORMAT [--stem=URI] [--sym=SYMBOLOGY] [--threads N] [--permit-unknown-ais] <input> [output]\n", prog);
+	fprintf(stderr, "  FORMAT is one of: bracketed, unbracketed, dl, scan\n");
+	fprintf(stderr, "  --sym is required for conversion to scan data, e.g. --sym=DM\n");
+}
+
+
+int main(int argc, char *argv[]) {
+
+	struct transcoder tc;
+	struct worker *workers = NULL;
+	gs1_syntax_dictionary *sd = NULL;
+	const char *inFile = NULL, *outFile = NULL;
+	bool haveFrom = false, haveTo = false, permitUnknownAIs = false;
+	int numThreads = 0, i, fd = -1, ret = 2;
+	void *map = MAP_FAILED;
+	struct stat st;
+
+	memset(&tc, 0, sizeof(tc));
+	tc.sym = gs1_encoder_sNONE;
+	tc.out = stdout;
+
+	for (i = 1; i < argc; i++) {
+		const char* const arg = argv[i];
+		if (strncmp(arg, "--from=", 7) == 0 && parseFormat(arg + 7, &tc.from))
+			haveFrom = true;
+		else if (strncmp(arg, "--to=", 5) == 0 && parseFormat(arg + 5, &tc.to))
+			haveTo = true;
+		else if (strncmp(arg, "--stem=", 7) == 0)
+			tc.stem = arg + 7;
+		else if (strncmp(arg, "--sym=", 6) == 0 && parseSym(arg + 6, &tc.sym))
+			continue;
+		else if (strncmp(arg, "--threads=", 10) == 0)
+			numThreads = atoi(arg + 10);
+		else if (strcmp(arg, "--threads") == 0 && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else if (strcmp(arg, "--permit-unknown-ais") == 0)
+			permitUnknownAIs = true;
+		else if (strncmp(arg, "--", 2) != 0 && !inFile)
+			inFile = arg;
+		else if (strncmp(arg, "--", 2) != 0 && !outFile)
+			outFile = arg;
+		else {
+			usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (!haveFrom || !haveTo || !inFile || (tc.to == fmt_SCAN && tc.sym == gs1_encoder_sNONE && tc.from != fmt_SCAN)) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	if (numThreads <= 0) {
+		const long n = sysconf(_SC_NPROCESSORS_ONLN);
+		numThreads = n > 0 ? (int)n : 1;
+	}
+	if (numThreads > MAX_THREADS)
+		numThreads = MAX_THREADS;
+
+	// Bracketed AI data may be longer than a barcode message
+	tc.maxMsgLen = tc.from == fmt_BRACKETED ? 2 * (size_t)gs1_encoder_getMaxDataStrLength() : (size_t)gs1_encoder_getMaxDataStrLength();
+
+	if ((fd = open(inFile, O_RDONLY)) < 0 || fstat(fd, &st) != 0) {
+		fprintf(stderr, "Failed to open %s\n", inFile);
+		goto out;
+	}
+	if (!S_ISREG(st.st_mode)) {
+		fprintf(stderr, "%s is not a regular file\n", inFile);
+		goto out;
+	}
+	tc.size = (size_t)st.st_size;
+	if (tc.size) {
+		if ((map = mmap(NULL, tc.size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+			fprintf(stderr, "Failed to map %s\n", inFile);
+			goto out;
+		}
+		madvise(map, tc.size, MADV_SEQUENTIAL);
+		tc.data = map;
+	}
+
+	if (outFile && (tc.out = fopen(outFile, "wb")) == NULL) {
+		fprintf(stderr, "Failed to create %s\n", outFile);
+		goto out;
+	}
+
+	// All of the workers' contexts share a single dictionary
+	if ((sd = gs1_encoder_loadSyntaxDictionary(NULL)) == NULL) {
+		fprintf(stderr, "Failed to initialise GS1 Encoders library!\n");
+		goto out;
+	}
+
+	pthread_mutex_init(&tc.lock, NULL);
+	pthread_cond_init(&tc.committed, NULL);
+
+	if ((workers = calloc((size_t)numThreads, sizeof(struct worker))) == NULL)
+		goto out_threads;
+
+	for (i = 0; i < numThreads; i++) {
+		struct worker* const w = &workers[i];
+		w->tc = &tc;
+		if ((w->ctx = gs1_encoder_initWithSyntaxDictionary(NULL, sd)) == NULL ||
+		    (w->msg = malloc(tc.maxMsgLen + 1)) == NULL ||
+		    !gs1_encoder_setPermitUnknownAIs(w->ctx, permitUnknownAIs)) {
+			fprintf(stderr, "Failed to initialise the workers\n");
+			goto out_threads;
+		}
+	}
+
+	for (i = 0; i < numThreads; i++) {
+		if (pthread_create(&workers[i].thread, NULL, workerMain, &workers[i]) != 0) {
+			// Remaining workers pick up the slack
+			if (i == 0) {
+				fprintf(stderr, "Failed to start the workers\n");
+				goto out_threads;
+			}
+			break;
+		}
+		workers[i].started = true;
+	}
+
+	for (i = 0; i < numThreads; i++) {
+		if (workers[i].started)
+			pthread_join(workers[i].thread, NULL);
+	}
+
+	if (tc.writeFailed || fflush(tc.out) != 0) {
+		fprintf(stderr, "Failed to write the output\n");
+		goto out_threads;
+	}
+
+	fprintf(stderr, "Converted %lu of %lu lines\n", tc.numLines - tc.numErrors, tc.numLines);
+	ret = tc.numErrors ? 1 : 0;
+
+out_threads:
+
+	if (workers) {
+		for (i = 0; i < numThreads; i++) {
+			gs1_encoder_free(workers[i].ctx);
+			free(workers[i].msg);
+			free(workers[i].out.data);
+			free(workers[i].errors);
+		}
+		free(workers);
+	}
+	pthread_cond_destroy(&tc.committed);
+	pthread_mutex_destroy(&tc.lock);
+
+out:
+
+	if (sd)
+		gs1_encoder_freeSyntaxDictionary(sd);
+	if (tc.out && tc.out != stdout)
+		fclose(tc.out);
+	if (map != MAP_FAILED)
+		munmap(map, tc.size);
+	if (fd >= 0)
+		close(fd);
+
+	return ret;
+
+}
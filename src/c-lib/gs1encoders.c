@@ -28,16 +28,17 @@
 #include "syntax/gs1syntaxdictionary.h"
 #include "enc-private.h"
 #include "gs1encoders.h"
+#include "cache.h"
 #include "dl.h"
 #include "scandata.h"
+#include "stats.h"
 #include "syn.h"
 
 
 static inline void reset_error(gs1_encoder* const ctx) {
 	assert(ctx);
-	*ctx->errMsg = '\0';
-	ctx->linterErr = GS1_LINTER_OK;
-	*ctx->linterErrMarkup = '\0';
+	gs1_clearErr(ctx);
+	ctx->numErrs = 0;
 }
 
 
@@ -52,6 +53,11 @@ __ATTR_CONST int gs1_encoder_getMaxDataStrLength(void) {
 
 
 gs1_encoder* gs1_encoder_init(void* const mem) {
+	return gs1_encoder_initWithSyntaxDictionary(mem, NULL);
+}
+
+
+gs1_encoder* gs1_encoder_initWithSyntaxDictionary(void* const mem, gs1_syntax_dictionary* const sd) {
 
 	gs1_encoder *ctx = NULL;
 
@@ -72,19 +78,25 @@ gs1_encoder* gs1_encoder_init(void* const mem) {
 		.permitUnknownAIs = false,
 		.permitZeroSuppressedGTINinDLuris = false,
 		.includeDataTitlesInHRI = false,
-		.aiTable = NULL,
-		.aiTableEntries = 0,
-		.aiTableIsDynamic = false,
-		.dlKeyQualifiers = NULL,
-		.numDLkeyQualifiers = 0,
+		.collectErrs = false,
+		.sd = NULL,
 		.numAIs = 0,
 		.dataStr = { 0 },
+		.err = { .code = gs1_encoder_eNO_ERROR, .aiIndex = -1 },
 		.errMsg = { 0 },
 		.linterErr = GS1_LINTER_OK,
-		.linterErrMarkup = { 0 }
+		.linterErrMarkup = { 0 },
+		.cache = NULL,
+		.cacheSize = 0,
 	}), sizeof(struct gs1_encoder));
 
-	gs1_loadSyntaxDictionary(ctx, NULL);
+	ctx->sd = sd ? gs1_retainSyntaxDictionary(sd) : gs1_loadSyntaxDictionary(NULL);
+	if (!ctx->sd) {
+		if (ctx->localAlloc)
+			free(ctx);
+		return NULL;
+	}
+
 	gs1_loadValidationTable(ctx);
 
 	return ctx;
@@ -96,17 +108,32 @@ void gs1_encoder_free(gs1_encoder* const ctx) {
 	assert(ctx);
 	reset_error(ctx);
 
-	if (ctx->aiTable && ctx->aiTableIsDynamic) {
-		gs1_freeSyntaxDictionaryEntries(ctx, ctx->aiTable);
-		free(ctx->aiTable);
-	}
+	gs1_cacheResize(ctx, 0);
+
+	gs1_releaseSyntaxDictionary(ctx->sd);
+	ctx->sd = NULL;
 
-	gs1_freeDLkeyQualifiers(ctx);
 	if (ctx->localAlloc)
 		free(ctx);
 }
 
 
+gs1_syntax_dictionary* gs1_encoder_loadSyntaxDictionary(const char* const fname) {
+	return gs1_loadSyntaxDictionary(fname);
+}
+
+
+void gs1_encoder_freeSyntaxDictionary(gs1_syntax_dictionary* const sd) {
+	gs1_releaseSyntaxDictionary(sd);
+}
+
+
+bool gs1_encoder_compileSyntaxDictionary(const char* const infile, const char* const outfile) {
+	assert(outfile);
+	return gs1_compileSyntaxDictionary(infile, outfile);
+}
+
+
 __ATTR_CONST char* gs1_encoder_getVersion(void) {
 	return __DATE__;
 }
@@ -121,7 +148,7 @@ bool gs1_encoder_setSym(gs1_encoder* const ctx, const gs1_encoder_symbologies_t
 	assert(ctx);
 	reset_error(ctx);
 	if (sym < gs1_encoder_sNONE || sym >= gs1_encoder_sNUMSYMS) {
-		strcpy(ctx->errMsg, "Unknown symbology");
+		gs1_setErr(ctx, gs1_encoder_eUNKNOWN_SYMBOLOGY);
 		return false;
 	}
 	ctx->sym = sym;
@@ -191,11 +218,11 @@ bool gs1_encoder_setValidationEnabled(gs1_encoder* const ctx, const gs1_encoder_
 	assert(ctx);
 	reset_error(ctx);
 	if ((signed int)validation < 0 || validation >= gs1_encoder_vNUMVALIDATIONS) {  // Cast satisfies "unsigned enum < 0" checks
-		strcpy(ctx->errMsg, "Unknown validation");
+		gs1_setErr(ctx, gs1_encoder_eUNKNOWN_VALIDATION);
 		return false;
 	}
 	if (ctx->validationTable[validation].locked) {
-		strcpy(ctx->errMsg, "This validation cannont be amended");
+		gs1_setErr(ctx, gs1_encoder_eLOCKED_VALIDATION);
 		return false;
 	}
 	ctx->validationTable[validation].enabled = enabled;
@@ -216,45 +243,156 @@ bool gs1_encoder_setIncludeDataTitlesInHRI(gs1_encoder* const ctx, const bool in
 }
 
 
-char* gs1_encoder_getDataStr(gs1_encoder* const ctx) {
+bool gs1_encoder_getCollectErrors(gs1_encoder* const ctx) {
 	assert(ctx);
 	reset_error(ctx);
-	return ctx->dataStr;
+	return ctx->collectErrs;
+}
+bool gs1_encoder_setCollectErrors(gs1_encoder* const ctx, const bool collectErrors) {
+	assert(ctx);
+	reset_error(ctx);
+	ctx->collectErrs = collectErrors;
+	return true;
 }
-bool gs1_encoder_setDataStr(gs1_encoder* const ctx, const char* const dataStr) {
 
-	char *cc;
 
+int gs1_encoder_getCacheSize(gs1_encoder* const ctx) {
 	assert(ctx);
-	assert(dataStr);
 	reset_error(ctx);
-
-	if (strlen(dataStr) > MAX_DATA) {
-		snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Maximum data length is %d characters", MAX_DATA);
+	return ctx->cacheSize;
+}
+bool gs1_encoder_setCacheSize(gs1_encoder* const ctx, const int entries) {
+	assert(ctx);
+	reset_error(ctx);
+	if (entries < 0) {
+		gs1_setErr(ctx, gs1_encoder_eCACHE_SIZE_INVALID);
 		return false;
 	}
-	if (ctx->dataStr != dataStr)					// File input is via ctx->dataStr
-		strcpy(ctx->dataStr, dataStr);
+	if (!gs1_cacheResize(ctx, entries)) {
+		gs1_setErr(ctx, gs1_encoder_eCACHE_ALLOC_FAILED);
+		return false;
+	}
+	return true;
+}
+void gs1_encoder_getCacheStats(gs1_encoder* const ctx, size_t* const hits, size_t* const misses) {
+	assert(ctx);
+	reset_error(ctx);
+	if (hits)
+		*hits = ctx->cacheHits;
+	if (misses)
+		*misses = ctx->cacheMisses;
+}
+
+
+bool gs1_encoder_getStats(gs1_encoder* const ctx, gs1_encoder_stats_t* const stats) {
+	assert(ctx);
+	assert(stats);
+	reset_error(ctx);
+#ifdef PERF_STATS
+	*stats = ctx->stats;
+	return true;
+#else
+	(void)stats;
+	gs1_setErr(ctx, gs1_encoder_eSTATS_UNAVAILABLE);
+	return false;
+#endif
+}
+bool gs1_encoder_resetStats(gs1_encoder* const ctx) {
+	assert(ctx);
+	reset_error(ctx);
+#ifdef PERF_STATS
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+	return true;
+#else
+	gs1_setErr(ctx, gs1_encoder_eSTATS_UNAVAILABLE);
+	return false;
+#endif
+}
+bool gs1_encoder_setPhaseCallback(gs1_encoder* const ctx, const gs1_encoder_phase_callback_t callback, void* const userData) {
+	assert(ctx);
+	reset_error(ctx);
+#ifdef PERF_STATS
+	ctx->phaseCallback = callback;
+	ctx->phaseUserData = userData;
+	return true;
+#else
+	(void)callback;
+	(void)userData;
+	gs1_setErr(ctx, gs1_encoder_eSTATS_UNAVAILABLE);
+	return false;
+#endif
+}
+const char* gs1_encoder_getStatsLinterName(const int index) {
+	return gs1_statsLinterName(index);
+}
+
+
+/*
+ *  Data given to gs1_encoder_setDataStrN() is validated where it lies. It is
+ *  only copied into ctx->dataStr, with any GS converted to "^", once something
+ *  needs the message itself.
+ *
+ */
+static void syncDataStr(gs1_encoder* const ctx) {
+
+	size_t i;
+
+	if (!ctx->extDataStr)
+		return;
+
+	for (i = 0; i < ctx->extDataStrLen; i++)
+		ctx->dataStr[i] = ctx->extDataStr[i] == '\x1D' ? '^' : ctx->extDataStr[i];
+	ctx->dataStr[i] = '\0';
+
+	ctx->extDataStr = NULL;
+
+}
+
+
+char* gs1_encoder_getDataStr(gs1_encoder* const ctx) {
+	assert(ctx);
+	reset_error(ctx);
+	syncDataStr(ctx);
+	return ctx->dataStr;
+}
+
+
+static inline bool isDLuri(const char* const data, const size_t len) {
+	return (len >= 8 && strncmp(data, "https://", 8) == 0) ||
+	       (len >= 8 && strncmp(data, "HTTPS://", 8) == 0) ||
+	       (len >= 7 && strncmp(data, "http://",  7) == 0) ||
+	       (len >= 7 && strncmp(data, "HTTP://",  7) == 0);
+}
+
+
+/*
+ *  Validate and process a message of the given length, including extraction
+ *  of HRI, without modifying it. The extracted AIs refer to the message. When
+ *  gsIsFNC1 is set then ASCII GS is accepted as FNC1 alongside "^". On failure
+ *  the partial results are left in place for the caller to inspect before
+ *  clearing them.
+ *
+ */
+static bool processDataStr(gs1_encoder* const ctx, const char* const data, const size_t len, const bool gsIsFNC1) {
+
+	const char *cc;
 
-	// Validate and process data, including extraction of HRI
 	ctx->numAIs = 0;
-	if ((strlen(ctx->dataStr) >= 8 && strncmp(ctx->dataStr, "https://", 8) == 0) ||	// GS1 Digital Link URI
-	    (strlen(ctx->dataStr) >= 8 && strncmp(ctx->dataStr, "HTTPS://", 8) == 0) ||
-	    (strlen(ctx->dataStr) >= 7 && strncmp(ctx->dataStr, "http://",  7) == 0) ||
-	    (strlen(ctx->dataStr) >= 7 && strncmp(ctx->dataStr, "HTTP://",  7) == 0)) {
+	if (isDLuri(data, len)) {					// GS1 Digital Link URI
 		// We extract AIs with the element string stored in dlAIbuffer
-		if (!gs1_parseDLuri(ctx, ctx->dataStr, ctx->dlAIbuffer))
+		if (!gs1_parseDLuriN(ctx, data, len, ctx->dlAIbuffer))
 			goto fail;
 	}
-	else if ((cc = strchr(ctx->dataStr, '|')) != NULL) {		// Composite symbol
+	else if ((cc = memchr(data, '|', len)) != NULL) {		// Composite symbol
 
-		*cc = '\0';						// Delimit end of linear component
+		const size_t linlen = (size_t)(cc - data);		// Linear component precedes "|"
 
-		if (*ctx->dataStr == '^' && !gs1_processAIdata(ctx, ctx->dataStr, true))
+		if (linlen && (*data == '^' || (gsIsFNC1 && *data == '\x1D')) &&
+		    !gs1_processAIdataN(ctx, data, linlen, true, gsIsFNC1))
 			goto fail;
 
 		if (ctx->numAIs >= MAX_AIS) {
-			strcpy(ctx->errMsg, "Too many AIs");
+			gs1_setErr(ctx, gs1_encoder_eTOO_MANY_AIS);
 			goto fail;
 		}
 
@@ -262,150 +400,774 @@ bool gs1_encoder_setDataStr(gs1_encoder* const ctx, const char* const dataStr) {
 		ctx->aiData[ctx->numAIs].kind = aiValue_ccsep;
 		ctx->numAIs++;
 
-		if (!gs1_processAIdata(ctx, cc + 1, true))
+		if (!gs1_processAIdataN(ctx, cc + 1, len - linlen - 1, true, gsIsFNC1))
 			goto fail;
 
-		*cc = '|';						// Restore orginal "|"
-
 	}
 	else {								// Linear-only symbol
-		if (*ctx->dataStr == '^' && !gs1_processAIdata(ctx, ctx->dataStr, true))
+		if (len && (*data == '^' || (gsIsFNC1 && *data == '\x1D')) &&
+		    !gs1_processAIdataN(ctx, data, len, true, gsIsFNC1))
 			goto fail;
 	}
 
-	if (!gs1_validateAIs(ctx))
-		goto fail;
-
-	return true;
+	return gs1_validateAIs(ctx);
 
 fail:
 
-	*ctx->dataStr = '\0';
-	ctx->numAIs = 0;
 	return false;
 
 }
 
 
-bool gs1_encoder_setAIdataStr(gs1_encoder* const ctx, const char* const aiData) {
+static bool setDataStr(gs1_encoder* const ctx, const char* const dataStr) {
 
-	char *cc;
+	size_t len;
+	bool ok;
 
 	assert(ctx);
-	assert(aiData);
+	assert(dataStr);
 	reset_error(ctx);
+	ctx->extDataStr = NULL;
+
+	if ((len = strlen(dataStr)) > MAX_DATA) {
+		gs1_setErr(ctx, gs1_encoder_eDATA_TOO_LONG);
+		ctx->err.num = MAX_DATA;
+		return false;
+	}
+
+	if (gs1_cacheLookup(ctx, cache_DATA_STR, dataStr, len, &ok))
+		return ok;
+
+	if (ctx->dataStr != dataStr)					// File input is via ctx->dataStr
+		memcpy(ctx->dataStr, dataStr, len + 1);
+
+	if (!(ok = processDataStr(ctx, ctx->dataStr, len, false))) {
+		*ctx->dataStr = '\0';
+		ctx->numAIs = 0;
+	}
+
+	gs1_cacheStore(ctx, cache_DATA_STR, dataStr, len, ok);
+
+	return ok;
+
+}
 
-	// Validate AI data
+
+/*
+ *  Each message given to a setter is timed as the parse phase, within which
+ *  the lint and validate phases are nested, and counted by its entry point.
+ *
+ */
+bool gs1_encoder_setDataStr(gs1_encoder* const ctx, const char* const dataStr) {
+
+	bool ok;
+
+	STATS_ENTER(ctx, gs1_encoder_pPARSE, NULL, 0);
+	ok = setDataStr(ctx, dataStr);
+	STATS_LEAVE(ctx);
+	STATS_MESSAGE(ctx, gs1_encoder_mDATA_STR, ok);
+
+	return ok;
+
+}
+
+
+static bool setDataStrN(gs1_encoder* const ctx, const char* const dataStr, const size_t len) {
+
+	assert(ctx);
+	assert(dataStr || len == 0);
+	reset_error(ctx);
+	ctx->extDataStr = NULL;
+
+	if (len > MAX_DATA) {
+		gs1_setErr(ctx, gs1_encoder_eDATA_TOO_LONG);
+		ctx->err.num = MAX_DATA;
+		return false;
+	}
+	if (len && memchr(dataStr, '\0', len) != NULL) {
+		gs1_setErr(ctx, gs1_encoder_eDATA_ILLEGAL_NUL);
+		return false;
+	}
+
+	if (!processDataStr(ctx, dataStr, len, true)) {
+		*ctx->dataStr = '\0';
+		ctx->numAIs = 0;
+		return false;
+	}
+
+	ctx->extDataStr = dataStr;
+	ctx->extDataStrLen = len;
+
+	return true;
+
+}
+
+
+bool gs1_encoder_setDataStrN(gs1_encoder* const ctx, const char* const dataStr, const size_t len) {
+
+	bool ok;
+
+	STATS_ENTER(ctx, gs1_encoder_pPARSE, NULL, 0);
+	ok = setDataStrN(ctx, dataStr, len);
+	STATS_LEAVE(ctx);
+	STATS_MESSAGE(ctx, gs1_encoder_mDATA_STR, ok);
+
+	return ok;
+
+}
+
+
+/*
+ *  Parse and validate AI data of the given length into ctx->dataStr, without
+ *  modifying the input. As for processDataStr(), partial results are left in
+ *  place on failure.
+ *
+ */
+static bool processAIdataStr(gs1_encoder* const ctx, const char* const aiData, const size_t len) {
+
+	const char *cc;
+
+	ctx->extDataStr = NULL;
 	ctx->numAIs = 0;
-	if ((cc = strchr(aiData, '|')) != NULL)		// Composite symbol
+	if ((cc = memchr(aiData, '|', len)) != NULL)		// Composite symbol
 	{
 
-		*cc = '\0';					// Delimit end of linear component
+		const size_t linlen = (size_t)(cc - aiData);	// Linear component precedes "|"
+		size_t n;
 
-		if (!gs1_parseAIdata(ctx, aiData, ctx->dataStr))
+		if (!gs1_parseAIdataN(ctx, aiData, linlen, ctx->dataStr))
 			goto fail;
 
 		if (ctx->numAIs >= MAX_AIS) {
-			strcpy(ctx->errMsg, "Too many AIs");
+			gs1_setErr(ctx, gs1_encoder_eTOO_MANY_AIS);
 			goto fail;
 		}
 
-		strcat(ctx->dataStr, "|");
+		n = strlen(ctx->dataStr);
+		ctx->dataStr[n++] = '|';
+		ctx->dataStr[n] = '\0';
 
 		// Indicate separator in HRI
 		ctx->aiData[ctx->numAIs].kind = aiValue_ccsep;
 		ctx->numAIs++;
 
-		if (!gs1_parseAIdata(ctx, cc+1, ctx->dataStr + strlen(ctx->dataStr)))
+		if (!gs1_parseAIdataN(ctx, cc + 1, len - linlen - 1, ctx->dataStr + n))
 			goto fail;
 
-		*cc = '|';					// Restore orginal "|"
-
 	}
 	else {							// Linear-only symbol
-		if (!gs1_parseAIdata(ctx, aiData, ctx->dataStr))
+		if (!gs1_parseAIdataN(ctx, aiData, len, ctx->dataStr))
 			goto fail;
 	}
 
-	if (!gs1_validateAIs(ctx))
-		goto fail;
-
-	return true;
+	return gs1_validateAIs(ctx);
 
 fail:
 
-	*ctx->dataStr = '\0';
-	ctx->numAIs = 0;
 	return false;
 
 }
 
 
-char* gs1_encoder_getAIdataStr(gs1_encoder* const ctx) {
+static bool setAIdataStr(gs1_encoder* const ctx, const char* const aiData) {
+
+	size_t len;
+	bool ok;
+
+	assert(ctx);
+	assert(aiData);
+	reset_error(ctx);
+	len = strlen(aiData);
+
+	if (gs1_cacheLookup(ctx, cache_AI_DATA_STR, aiData, len, &ok))
+		return ok;
+
+	if (!(ok = processAIdataStr(ctx, aiData, len))) {
+		*ctx->dataStr = '\0';
+		ctx->numAIs = 0;
+	}
+
+	gs1_cacheStore(ctx, cache_AI_DATA_STR, aiData, len, ok);
+
+	return ok;
+
+}
+
+
+bool gs1_encoder_setAIdataStr(gs1_encoder* const ctx, const char* const aiData) {
+
+	bool ok;
+
+	STATS_ENTER(ctx, gs1_encoder_pPARSE, NULL, 0);
+	ok = setAIdataStr(ctx, aiData);
+	STATS_LEAVE(ctx);
+	STATS_MESSAGE(ctx, gs1_encoder_mAI_DATA_STR, ok);
+
+	return ok;
+
+}
+
+
+static bool setAIdataStrN(gs1_encoder* const ctx, const char* const aiData, const size_t len) {
+
+	assert(ctx);
+	assert(aiData || len == 0);
+	reset_error(ctx);
+
+	if (len && memchr(aiData, '\0', len) != NULL) {
+		ctx->extDataStr = NULL;
+		*ctx->dataStr = '\0';
+		ctx->numAIs = 0;
+		gs1_setErr(ctx, gs1_encoder_eAI_DATA_ILLEGAL_NUL);
+		return false;
+	}
+
+	if (!processAIdataStr(ctx, aiData, len)) {
+		*ctx->dataStr = '\0';
+		ctx->numAIs = 0;
+		return false;
+	}
+
+	return true;
+
+}
+
+
+bool gs1_encoder_setAIdataStrN(gs1_encoder* const ctx, const char* const aiData, const size_t len) {
+
+	bool ok;
+
+	STATS_ENTER(ctx, gs1_encoder_pPARSE, NULL, 0);
+	ok = setAIdataStrN(ctx, aiData, len);
+	STATS_LEAVE(ctx);
+	STATS_MESSAGE(ctx, gs1_encoder_mAI_DATA_STR, ok);
+
+	return ok;
+
+}
+
+
+size_t gs1_encoder_renderAIdataStr(gs1_encoder* const ctx, char* const buf, const size_t size) {
 
 	int i, j;
-	char *p = ctx->outStr;
+	struct gs1_renderer out;
+	size_t len;
 
 	assert(ctx);
 	assert(ctx->numAIs <= MAX_AIS);
+	assert(buf || size == 0);
 	reset_error(ctx);
 
-	if (ctx->numAIs == 0)		// Not GS1 data
-		return NULL;
-
+	STATS_ENTER(ctx, gs1_encoder_pRENDER, NULL, 0);
+	gs1_renderInit(&out, buf, size);
 	for (i = 0; i < ctx->numAIs; i++) {
 		const struct aiValue *ai = &ctx->aiData[i];
 		if (ai->kind == aiValue_aival) {
-			int n = snprintf(p, sizeof(ctx->outStr) - (size_t)(p - ctx->outStr), "(%.*s)", ai->ailen, ai->ai);
-			assert(n >= 0 || n < (int)(sizeof(ctx->outStr) - (size_t)(p - ctx->outStr)));
-			p += n;
+			gs1_renderChar(&out, '(');
+			gs1_renderN(&out, ai->ai, ai->ailen);
+			gs1_renderChar(&out, ')');
 			for (j = 0; j < ai->vallen; j++) {
 				if (ai->value[j] == '(')	// Escape data "("
-					*p++ = '\\';
-				*p++ = ai->value[j];
+					gs1_renderChar(&out, '\\');
+				gs1_renderChar(&out, ai->value[j]);
 			}
 		} else if (ai->kind == aiValue_ccsep) {
-			*p++ = '|';
+			gs1_renderChar(&out, '|');
 		}	// Otherwise ignored parameters
 	}
-	*p = '\0';
+	len = gs1_renderEnd(&out);
+	STATS_LEAVE(ctx);
+
+	return len;
+
+}
+
+
+char* gs1_encoder_getAIdataStr(gs1_encoder* const ctx) {
+
+	size_t len;
+
+	assert(ctx);
+
+	if (ctx->numAIs == 0) {		// Not GS1 data
+		reset_error(ctx);
+		return NULL;
+	}
+
+	len = gs1_encoder_renderAIdataStr(ctx, ctx->outStr, sizeof(ctx->outStr));
+	assert(len < sizeof(ctx->outStr));	// Output is sized for the longest message
+	(void)len;
 
 	return ctx->outStr;
 
 }
 
 
+static void describeAI(const struct aiValue* const ai, gs1_encoder_ai_t* const out) {
+
+	assert(ai->aiEntry);
+
+	*out = (gs1_encoder_ai_t) {
+		.ai = ai->ai,
+		.aiLength = ai->ailen,
+		.value = ai->value,
+		.valueLength = ai->vallen,
+		.fnc1 = ai->aiEntry->fnc1,
+		.dlPathOrder = ai->dlPathOrder == DL_PATH_ORDER_ATTRIBUTE ? -1 : ai->dlPathOrder,
+		.title = ai->aiEntry->title ? ai->aiEntry->title : "",
+		.attrs = ai->aiEntry->attrs ? ai->aiEntry->attrs : "",
+	};
+
+}
+
+
+bool gs1_encoder_getNextAI(gs1_encoder* const ctx, int* const cursor, gs1_encoder_ai_t* const ai) {
+
+	assert(ctx);
+	assert(cursor);
+	assert(ai);
+	assert(*cursor >= 0);
+
+	while (*cursor < ctx->numAIs) {
+		const struct aiValue* const aiv = &ctx->aiData[(*cursor)++];
+		if (aiv->kind == aiValue_aival) {
+			describeAI(aiv, ai);
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+
+bool gs1_encoder_findAI(gs1_encoder* const ctx, const char* const ai, gs1_encoder_ai_t* const out) {
+
+	size_t ailen;
+	int i;
+
+	assert(ctx);
+	assert(ai);
+	assert(out);
+
+	ailen = strlen(ai);
+
+	for (i = 0; i < ctx->numAIs; i++) {
+		const struct aiValue* const aiv = &ctx->aiData[i];
+		if (aiv->kind == aiValue_aival && aiv->ailen == ailen && memcmp(aiv->ai, ai, ailen) == 0) {
+			describeAI(aiv, out);
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+
 char* gs1_encoder_getDLuri(gs1_encoder* const ctx, const char* const stem) {
+	char *uri;
 	assert(ctx);
-	return gs1_generateDLuri(ctx, stem);
+	STATS_ENTER(ctx, gs1_encoder_pRENDER, NULL, 0);
+	uri = gs1_generateDLuri(ctx, stem);
+	STATS_LEAVE(ctx);
+	return uri;
+}
+
+
+size_t gs1_encoder_renderDLuri(gs1_encoder* const ctx, const char* const stem, char* const buf, const size_t size) {
+	size_t len;
+	assert(ctx);
+	STATS_ENTER(ctx, gs1_encoder_pRENDER, NULL, 0);
+	len = gs1_renderDLuri(ctx, stem, buf, size);
+	STATS_LEAVE(ctx);
+	return len;
 }
 
 
 char* gs1_encoder_getScanData(gs1_encoder* const ctx) {
+	char *scanData;
 	assert(ctx);
-	return gs1_generateScanData(ctx);
+	syncDataStr(ctx);
+	STATS_ENTER(ctx, gs1_encoder_pRENDER, NULL, 0);
+	scanData = gs1_generateScanData(ctx);
+	STATS_LEAVE(ctx);
+	return scanData;
 }
 
 
-bool gs1_encoder_setScanData(gs1_encoder* const ctx, const char* const scanData) {
+static bool setScanData(gs1_encoder* const ctx, const char* const scanData) {
+
+	size_t len;
+	bool ok;
+
 	assert(ctx);
 	assert(scanData);
+	reset_error(ctx);
+	len = strlen(scanData);
+	ctx->extDataStr = NULL;
+
+	if (gs1_cacheLookup(ctx, cache_SCAN_DATA, scanData, len, &ok))
+		return ok;
+
+	ok = gs1_processScanData(ctx, scanData) && gs1_validateAIs(ctx);
+
+	gs1_cacheStore(ctx, cache_SCAN_DATA, scanData, len, ok);
+
+	return ok;
+
+}
+
+
+bool gs1_encoder_setScanData(gs1_encoder* const ctx, const char* const scanData) {
+
+	bool ok;
+
+	STATS_ENTER(ctx, gs1_encoder_pPARSE, NULL, 0);
+	ok = setScanData(ctx, scanData);
+	STATS_LEAVE(ctx);
+	STATS_MESSAGE(ctx, gs1_encoder_mSCAN_DATA, ok);
+
+	return ok;
+
+}
+
+
+/*
+ *  Batch processing
+ *
+ *  Each message is processed as by the corresponding setter, but without the
+ *  per-call overheads, and the outcome is reported into the caller's results
+ *  rather than as an error message. The extracted AIs and any error are
+ *  located within the caller's message.
+ *
+ */
+
+typedef enum {
+	batch_DATA_STR,
+	batch_AI_DATA_STR,
+	batch_SCAN_DATA,
+} batchFormat_t;
+
+typedef enum {
+	batchEsc_NONE,				// Values appear verbatim in the message
+	batchEsc_BRACKET,			// Data "(" is escaped as "\("
+	batchEsc_URI,				// Values are percent-encoded
+} batchEsc_t;
+
+
+static inline bool inBuffer(const char* const p, const char* const buf, const size_t len) {
+	return (uintptr_t)p >= (uintptr_t)buf && (uintptr_t)p <= (uintptr_t)(buf + len);
+}
+
+
+static inline int hexVal(const char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	return -1;
+}
+
+
+/*
+ *  Match a value extracted from a message against its encoded form starting
+ *  at in[*pos], advancing *pos over the encoded form on success.
+ *
+ */
+static bool matchBatchValue(const char* const in, const size_t len, size_t* const pos, const char* const val, const size_t vallen, const batchEsc_t esc) {
+
+	size_t i = *pos, j;
+
+	for (j = 0; j < vallen; j++) {
+
+		if (i >= len)
+			return false;
 
-	if (!gs1_processScanData(ctx, scanData))
-		goto fail;
+		if (esc == batchEsc_URI && in[i] == '%' && i + 2 < len && hexVal(in[i+1]) >= 0 && hexVal(in[i+2]) >= 0) {
+			if ((char)(hexVal(in[i+1]) * 16 + hexVal(in[i+2])) != val[j])
+				return false;
+			i += 3;
+		} else if (esc == batchEsc_URI && in[i] == '+' && val[j] == ' ') {
+			i++;
+		} else if (esc == batchEsc_BRACKET && in[i] == '\\' && i + 1 < len && in[i+1] == '(' && val[j] == '(') {
+			i += 2;
+		} else if (in[i] == val[j]) {
+			i++;
+		} else {
+			return false;
+		}
 
-	if (!gs1_validateAIs(ctx))
-		goto fail;
+	}
 
+	*pos = i;
 	return true;
 
-fail:
+}
+
+
+/*
+ *  Find the next occurrence of an AI followed by (a prefix of) its value at
+ *  or beyond *cursor. The AI may be delimited from its value by ")", "/" or
+ *  "=", and in DL URIs a GTIN may have been given zero-suppressed.
+ *
+ */
+static bool locateBatchAI(const char* const in, const size_t len, size_t* const cursor, const char* const ai, const size_t ailen, const char* const val, const size_t vallen, const batchEsc_t esc, gs1_encoder_batch_span_t* const span) {
+
+	size_t pos, q, i, skip;
+
+	for (pos = *cursor; pos + ailen <= len; pos++) {
+
+		if (memcmp(in + pos, ai, ailen) != 0)
+			continue;
+
+		q = pos + ailen;
+		if (q < len && (in[q] == ')' || in[q] == '/' || in[q] == '='))
+			q++;
+
+		for (skip = 0; ; skip++) {
+			i = q;
+			if (matchBatchValue(in, len, &i, val + skip, vallen - skip, esc)) {
+				span->aiOffset = pos;
+				span->aiLength = ailen;
+				span->valueOffset = q;
+				span->valueLength = i - q;
+				*cursor = i;
+				return true;
+			}
+			if (esc != batchEsc_URI || skip >= vallen || val[skip] != '0')
+				break;
+		}
+
+	}
 
 	return false;
 
 }
 
 
+/*
+ *  Determine the position of a failure within the message, from the AI (and
+ *  optionally the data within its value) that was blamed. This is either in
+ *  the copy of the message that was processed, or else in data derived from it
+ *  whose AIs must be matched against the message.
+ *
+ */
+static size_t batchErrOffset(const gs1_encoder* const ctx, const char* const in, const size_t len, const char* const copy, const batchEsc_t esc) {
+
+	gs1_encoder_batch_span_t span;
+	size_t cursor = 0, q;
+	int i;
+
+	if (!ctx->errAI)
+		return len;
+
+	if (inBuffer(ctx->errAI, copy, len)) {
+		if (ctx->errPos && inBuffer(ctx->errPos, copy, len))
+			return (size_t)(ctx->errPos - copy);
+		q = (size_t)(ctx->errAI - copy) + ctx->errAIlen;
+		if (q < len && (in[q] == ')' || in[q] == '/' || in[q] == '='))
+			q++;
+		return q < len ? q : len;
+	}
+
+	for (i = 0; i < ctx->numAIs; i++) {
+		const struct aiValue* const ai = &ctx->aiData[i];
+		if (ai->kind != aiValue_aival)
+			continue;
+		if (ai->ai == ctx->errAI)
+			break;
+		locateBatchAI(in, len, &cursor, ai->ai, ai->ailen, ai->value, ai->vallen, esc, &span);
+	}
+
+	if (!locateBatchAI(in, len, &cursor, ctx->errAI, ctx->errAIlen, ctx->errAI + ctx->errAIlen,
+			   ctx->errPos ? (size_t)(ctx->errPos - ctx->errAI) - ctx->errAIlen : 0, esc, &span))
+		return len;
+
+	return span.valueOffset + span.valueLength;
+
+}
+
+
+static size_t processBatch(gs1_encoder* const ctx, const batchFormat_t format, const gs1_encoder_batch_input_t* const inputs, const size_t count, gs1_encoder_batch_result_t* const results, gs1_encoder_batch_span_t* const spans, const size_t maxSpans) {
+
+	size_t n, numValid = 0, numSpans = 0;
+
+	assert(ctx);
+	assert(inputs || count == 0);
+	assert(results || count == 0);
+	assert(spans || maxSpans == 0);
+
+	ctx->extDataStr = NULL;
+
+	for (n = 0; n < count; n++) {
+
+		const char* const in = inputs[n].data;
+		const size_t len = inputs[n].length;
+		gs1_encoder_batch_result_t* const res = &results[n];
+		const char *copy;
+		size_t maxlen, cursor, first;
+		batchEsc_t esc;
+		bool ok;
+		int i;
+
+		assert(in || len == 0);
+
+		*res = (gs1_encoder_batch_result_t) {
+			.status = gs1_encoder_bINVALID,
+			.linterErr = 0,
+			.errOffset = len,
+			.firstSpan = numSpans,
+			.numSpans = 0,
+		};
+
+		/*
+		 *  Messages are copied to where the corresponding setter would
+		 *  find them, with AI data and scan data being held in outStr
+		 *  since they are transformed into dataStr
+		 *
+		 */
+		maxlen = format == batch_AI_DATA_STR ? sizeof(ctx->outStr) - 1 : MAX_DATA;
+		if (len > maxlen) {
+			res->status = gs1_encoder_bTOO_LONG;
+			res->errOffset = maxlen;
+			continue;
+		}
+		if (len && memchr(in, '\0', len) != NULL) {
+			res->errOffset = (size_t)((const char*)memchr(in, '\0', len) - in);
+			continue;
+		}
+
+		reset_error(ctx);
+
+		STATS_ENTER(ctx, gs1_encoder_pPARSE, NULL, 0);
+		if (format == batch_DATA_STR) {
+			memcpy(ctx->dataStr, in, len);
+			ctx->dataStr[len] = '\0';
+			copy = ctx->dataStr;
+			ok = processDataStr(ctx, ctx->dataStr, len, false);
+		} else {
+			memcpy(ctx->outStr, in, len);
+			ctx->outStr[len] = '\0';
+			copy = ctx->outStr;
+			if (format == batch_AI_DATA_STR)
+				ok = processAIdataStr(ctx, ctx->outStr, len);
+			else
+				ok = gs1_processScanData(ctx, ctx->outStr) && gs1_validateAIs(ctx);
+		}
+		STATS_LEAVE(ctx);
+		STATS_MESSAGE(ctx, format == batch_DATA_STR ? gs1_encoder_mDATA_STR :
+				   format == batch_AI_DATA_STR ? gs1_encoder_mAI_DATA_STR : gs1_encoder_mSCAN_DATA, ok);
+
+		if (format == batch_AI_DATA_STR)
+			esc = batchEsc_BRACKET;
+		else if ((len >= 7 && (strncmp(in, "http://", 7) == 0 || strncmp(in, "HTTP://", 7) == 0)) ||
+			 (len >= 8 && (strncmp(in, "https://", 8) == 0 || strncmp(in, "HTTPS://", 8) == 0)) ||
+			 (format == batch_SCAN_DATA && len >= 10 && in[0] == ']' && (strncmp(in + 3, "http://", 7) == 0 || strncmp(in + 3, "HTTP://", 7) == 0)) ||
+			 (format == batch_SCAN_DATA && len >= 11 && in[0] == ']' && (strncmp(in + 3, "https://", 8) == 0 || strncmp(in + 3, "HTTPS://", 8) == 0)))
+			esc = batchEsc_URI;
+		else
+			esc = batchEsc_NONE;
+
+		if (!ok) {
+			res->linterErr = (int)ctx->linterErr;
+			res->errOffset = batchErrOffset(ctx, in, len, copy, esc);
+			*ctx->dataStr = '\0';
+			ctx->numAIs = 0;
+			continue;
+		}
+
+		/*
+		 *  AIs extracted from the copy of the message are located
+		 *  directly, otherwise they are matched against the message
+		 *
+		 */
+		first = numSpans;
+		cursor = 0;
+		for (i = 0; i < ctx->numAIs; i++) {
+
+			const struct aiValue* const ai = &ctx->aiData[i];
+			gs1_encoder_batch_span_t* span;
+
+			if (ai->kind != aiValue_aival)
+				continue;
+
+			if (numSpans >= maxSpans) {
+				res->status = gs1_encoder_bNO_SPANS;
+				numSpans = first;
+				break;
+			}
+
+			span = &spans[numSpans++];
+			if (inBuffer(ai->ai, copy, len)) {
+				*span = (gs1_encoder_batch_span_t) {
+					.aiOffset = (size_t)(ai->ai - copy),
+					.aiLength = ai->ailen,
+					.valueOffset = (size_t)(ai->value - copy),
+					.valueLength = ai->vallen,
+				};
+			} else if (!locateBatchAI(in, len, &cursor, ai->ai, ai->ailen, ai->value, ai->vallen, esc, span)) {
+				*span = (gs1_encoder_batch_span_t) {
+					.aiOffset = len,
+					.aiLength = 0,
+					.valueOffset = len,
+					.valueLength = 0,
+				};
+			}
+
+		}
+
+		if (res->status == gs1_encoder_bNO_SPANS)
+			continue;
+
+		res->status = gs1_encoder_bVALID;
+		res->errOffset = 0;
+		res->numSpans = numSpans - first;
+		numValid++;
+
+	}
+
+	return numValid;
+
+}
+
+
+size_t gs1_encoder_setDataStrBatch(gs1_encoder* const ctx, const gs1_encoder_batch_input_t* const inputs, const size_t count, gs1_encoder_batch_result_t* const results, gs1_encoder_batch_span_t* const spans, const size_t maxSpans) {
+	assert(ctx);
+	reset_error(ctx);
+	return processBatch(ctx, batch_DATA_STR, inputs, count, results, spans, maxSpans);
+}
+
+
+size_t gs1_encoder_setAIdataStrBatch(gs1_encoder* const ctx, const gs1_encoder_batch_input_t* const inputs, const size_t count, gs1_encoder_batch_result_t* const results, gs1_encoder_batch_span_t* const spans, const size_t maxSpans) {
+	assert(ctx);
+	reset_error(ctx);
+	return processBatch(ctx, batch_AI_DATA_STR, inputs, count, results, spans, maxSpans);
+}
+
+
+size_t gs1_encoder_setScanDataBatch(gs1_encoder* const ctx, const gs1_encoder_batch_input_t* const inputs, const size_t count, gs1_encoder_batch_result_t* const results, gs1_encoder_batch_span_t* const spans, const size_t maxSpans) {
+	assert(ctx);
+	reset_error(ctx);
+	return processBatch(ctx, batch_SCAN_DATA, inputs, count, results, spans, maxSpans);
+}
+
+
+static void renderHRIentry(const gs1_encoder* const ctx, struct gs1_renderer* const out, const struct aiValue* const ai) {
+
+	assert(ai->aiEntry);
+
+	if (ctx->includeDataTitlesInHRI && *ai->aiEntry->title != '\0') {
+		gs1_renderN(out, ai->aiEntry->title, strlen(ai->aiEntry->title));
+		gs1_renderChar(out, ' ');
+	}
+	gs1_renderChar(out, '(');
+	gs1_renderN(out, ai->ai, ai->ailen);
+	gs1_renderN(out, ") ", 2);
+	gs1_renderN(out, ai->value, ai->vallen);
+
+}
+
+
 int gs1_encoder_getHRI(gs1_encoder* const ctx, char*** const out) {
 
 	int i, j;
@@ -415,31 +1177,31 @@ int gs1_encoder_getHRI(gs1_encoder* const ctx, char*** const out) {
 	assert(ctx->numAIs <= MAX_AIS);
 	reset_error(ctx);
 
+	STATS_ENTER(ctx, gs1_encoder_pRENDER, NULL, 0);
 	*p = '\0';
 	for (i = 0, j = 0; i < ctx->numAIs; i++) {
 
 		const struct aiValue* const ai = &ctx->aiData[i];
-		int n;
+		struct gs1_renderer r;
+		size_t len;
 
 		if (ai->kind != aiValue_aival)
 			continue;
 
-		assert(ai->aiEntry);
-
 		ctx->outHRI[j] = p;
 
-		if (!ctx->includeDataTitlesInHRI || *ai->aiEntry->title == '\0')
-			n = snprintf(p, sizeof(ctx->outStr) - (size_t)(p - ctx->outStr), "(%.*s) %.*s", ai->ailen, ai->ai, ai->vallen, ai->value);
-		else
-			n = snprintf(p, sizeof(ctx->outStr) - (size_t)(p - ctx->outStr), "%s (%.*s) %.*s", ai->aiEntry->title, ai->ailen, ai->ai, ai->vallen, ai->value);
-		assert(n >= 0 && n < (int)(sizeof(ctx->outStr) - (size_t)(p - ctx->outStr)));
-		p += n;
+		// Each HRI string follows the terminating NUL of the previous one
+		gs1_renderInit(&r, p, sizeof(ctx->outStr) - (size_t)(p - ctx->outStr));
+		renderHRIentry(ctx, &r, ai);
+		len = gs1_renderEnd(&r);
+		assert(len < r.size);
 
-		*p++ = '\0';
+		p += len + 1;
 
 		j++;
 
 	}
+	STATS_LEAVE(ctx);
 
 	*out = ctx->outHRI;
 
@@ -448,148 +1210,442 @@ int gs1_encoder_getHRI(gs1_encoder* const ctx, char*** const out) {
 }
 
 
+size_t gs1_encoder_renderHRI(gs1_encoder* const ctx, char* const buf, const size_t size) {
+
+	int i;
+	struct gs1_renderer out;
+	bool first = true;
+	size_t len;
+
+	assert(ctx);
+	assert(ctx->numAIs <= MAX_AIS);
+	assert(buf || size == 0);
+	reset_error(ctx);
+
+	STATS_ENTER(ctx, gs1_encoder_pRENDER, NULL, 0);
+	gs1_renderInit(&out, buf, size);
+	for (i = 0; i < ctx->numAIs; i++) {
+
+		const struct aiValue* const ai = &ctx->aiData[i];
+
+		if (ai->kind != aiValue_aival)
+			continue;
+
+		if (!first)
+			gs1_renderChar(&out, '|');
+		renderHRIentry(ctx, &out, ai);
+		first = false;
+
+	}
+	len = gs1_renderEnd(&out);
+	STATS_LEAVE(ctx);
+
+	return len;
+
+}
+
+
 size_t gs1_encoder_getHRIsize(gs1_encoder* const ctx) {
 
+	const size_t len = gs1_encoder_renderHRI(ctx, NULL, 0);
+
+	return len ? len + 1 : 0;  // Includes NULL terminator
+
+}
+
+
+void gs1_encoder_copyHRI(gs1_encoder* const ctx, void* const buf, const size_t max) {
+
+	// Nothing is copied unless all of the HRI fits
+	if (gs1_encoder_renderHRI(ctx, buf, max) >= max && max)
+		*(char*)buf = '\0';
+
+}
+
+
+int gs1_encoder_getDLignoredQueryParams(gs1_encoder* const ctx, char*** const out) {
+
+	int i, j;
+	char *p = ctx->outStr;
+
+	assert(ctx);
+	assert(ctx->numAIs <= MAX_AIS);
+	reset_error(ctx);
+
+	*p = '\0';
+	for (i = 0, j = 0; i < ctx->numAIs; i++) {
+
+		const struct aiValue* const ai = &ctx->aiData[i];
+
+		if (ai->kind != alValue_dlign)
+			continue;
+
+		ctx->outHRI[j] = p;
+
+		assert(ai->vallen < sizeof(ctx->outStr) - (size_t)(p - ctx->outStr));
+		memcpy(p, ai->value, ai->vallen);
+		p += ai->vallen;
+		*p++ = '\0';
+
+		j++;
+
+	}
+
+	*out = ctx->outHRI;
+	return j;
+
+}
+
+
+size_t gs1_encoder_renderDLignoredQueryParams(gs1_encoder* const ctx, char* const buf, const size_t size) {
+
+	int i;
+	struct gs1_renderer out;
+	bool first = true;
+
+	assert(ctx);
+	assert(ctx->numAIs <= MAX_AIS);
+	assert(buf || size == 0);
+	reset_error(ctx);
+
+	gs1_renderInit(&out, buf, size);
+	for (i = 0; i < ctx->numAIs; i++) {
+
+		const struct aiValue* const ai = &ctx->aiData[i];
+
+		if (ai->kind != alValue_dlign)
+			continue;
+
+		if (!first)
+			gs1_renderChar(&out, '&');
+		gs1_renderN(&out, ai->value, ai->vallen);
+		first = false;
+
+	}
+
+	return gs1_renderEnd(&out);
+
+}
+
+
+size_t gs1_encoder_getDLignoredQueryParamsSize(gs1_encoder* const ctx) {
+
 	size_t sz = 0;
 	int i;
-	char **hri;
-	const int numhri = gs1_encoder_getHRI(ctx, &hri);
+	char **qp;
+	const int numqp = gs1_encoder_getDLignoredQueryParams(ctx, &qp);
 
-	for (i = 0; i < numhri; i++)
-		sz += strlen(hri[i]) + 1;  // Includes "|" or NULL terminator
+	for (i = 0; i < numqp; i++)
+		sz += strlen(qp[i]) + 1;  // Includes "&" or NULL terminator
 
 	return sz;
 
 }
 
 
-void gs1_encoder_copyHRI(gs1_encoder* const ctx, void* const buf, const size_t max) {
+void gs1_encoder_copyDLignoredQueryParams(gs1_encoder* const ctx, void* const buf, const size_t max) {
+
+	// Nothing is copied unless all of the parameters fit
+	if (gs1_encoder_renderDLignoredQueryParams(ctx, buf, max) >= max && max)
+		*(char*)buf = '\0';
+
+}
+
+
+/*
+ *  Message for each error code, in which "%s" is replaced by the next text
+ *  argument of the error record, "%d" by its numeric argument and "%l" by the
+ *  description of the linter error.
+ *
+ */
+static const char* const errFormats[gs1_encoder_eNUMERRORS] = {
+	[gs1_encoder_eNO_ERROR]				= "",
+	[gs1_encoder_eUNKNOWN_SYMBOLOGY]		= "Unknown symbology",
+	[gs1_encoder_eUNKNOWN_VALIDATION]		= "Unknown validation",
+	[gs1_encoder_eLOCKED_VALIDATION]		= "This validation cannont be amended",
+	[gs1_encoder_eTOO_MANY_AIS]			= "Too many AIs",
+	[gs1_encoder_eDATA_TOO_LONG]			= "Maximum data length is %d characters",
+	[gs1_encoder_eDATA_ILLEGAL_NUL]			= "Data contains an illegal null character",
+	[gs1_encoder_eAI_DATA_ILLEGAL_NUL]		= "AI data contains an illegal null character",
+	[gs1_encoder_eAI_INCORRECT_LENGTH]		= "AI (%s) data has incorrect length",
+	[gs1_encoder_eAI_LINT_FAILURE]			= "AI (%s): %l",
+	[gs1_encoder_eAI_VALUE_EMPTY]			= "AI (%s) data is empty",
+	[gs1_encoder_eAI_VALUE_TOO_SHORT]		= "AI (%s) value is too short",
+	[gs1_encoder_eAI_VALUE_TOO_LONG]		= "AI (%s) value is too long",
+	[gs1_encoder_eAI_VALUE_ILLEGAL_CARET]		= "AI (%s) contains illegal ^ character",
+	[gs1_encoder_eAI_UNRECOGNISED]			= "Unrecognised AI: %s",
+	[gs1_encoder_eAI_PARSE_FAILED]			= "Failed to parse AI data",
+	[gs1_encoder_eMISSING_FNC1_IN_FIRST]		= "Missing FNC1 in first position",
+	[gs1_encoder_eAI_DATA_EMPTY]			= "The AI data is empty",
+	[gs1_encoder_eAI_NO_KNOWN_PREFIX]		= "No known AI is a prefix of: %s...",
+	[gs1_encoder_eAI_DATA_TOO_LONG]			= "AI (%s) data is too long",
+	[gs1_encoder_eAI_INVALID_PAIRING]		= "It is invalid to pair AI (%s) with AI (%s)",
+	[gs1_encoder_eAI_REQUISITES_UNSATISFIED]	= "Required AIs for AI (%s) are not satisfied: %s",
+	[gs1_encoder_eAI_INSTANCES_DIFFER]		= "Multiple instances of AI (%s) have different values",
+	[gs1_encoder_eAI_SERIAL_REQUIRED]		= "Serial component must be present for AI (%s) when used with AI (8030)",
+	[gs1_encoder_eDL_ILLEGAL_CHARACTERS]		= "URI contains illegal characters",
+	[gs1_encoder_eDL_BAD_SCHEME]			= "Scheme must be http:// or HTTP:// or https:// or HTTPS://",
+	[gs1_encoder_eDL_NO_PATH_INFO]			= "URI must contain a domain and path info",
+	[gs1_encoder_eDL_NO_KEYS]			= "No GS1 DL keys found in path info",
+	[gs1_encoder_eDL_PATH_VALUE_EMPTY]		= "AI (%s) value path element is empty",
+	[gs1_encoder_eDL_PATH_VALUE_ILLEGAL_NUL]	= "Decoded AI (%s) from DL path info contains illegal null character",
+	[gs1_encoder_eDL_QUERY_AI_UNKNOWN]		= "Unknown AI (%s) in query parameters",
+	[gs1_encoder_eDL_QUERY_VALUE_EMPTY]		= "AI (%s) value query element is empty",
+	[gs1_encoder_eDL_QUERY_VALUE_ILLEGAL_NUL]	= "Decoded AI (%s) value from DL query params contains illegal null character",
+	[gs1_encoder_eDL_INVALID_KEY_QUALIFIERS]	= "The AIs in the path are not a valid key-qualifier sequence for the key",
+	[gs1_encoder_eDL_AI_DUPLICATED]			= "AI (%s) is duplicated",
+	[gs1_encoder_eDL_INVALID_ATTRIBUTE]		= "AI (%s) is not a valid DL URI data attribute",
+	[gs1_encoder_eDL_ATTRIBUTE_IN_PATH]		= "AI (%s) from query params should be in the path info",
+	[gs1_encoder_eDL_PARSE_FAILED]			= "Failed to parse DL data",
+	[gs1_encoder_eDL_NO_PRIMARY_KEY]		= "Cannot create a DL URI without a primary key AI",
+	[gs1_encoder_ePRIMARY_WRONG_LENGTH_NO_CD]	= "Primary data must be %d digits without check digit",
+	[gs1_encoder_ePRIMARY_WRONG_LENGTH]		= "Primary data must be %d digits",
+	[gs1_encoder_ePRIMARY_NOT_DIGITS]		= "Primary data must be all digits",
+	[gs1_encoder_ePRIMARY_INCORRECT_CD]		= "Primary data check digit is incorrect",
+	[gs1_encoder_ePRIMARY_VALUE_TOO_LARGE]		= "Primary data item value is too large",
+	[gs1_encoder_eSCAN_MISSING_SYMID]		= "Missing symbology identifier",
+	[gs1_encoder_eSCAN_UNSUPPORTED_SYMID]		= "Unsupported symbology identifier",
+	[gs1_encoder_eSCAN_PRIMARY_TOO_SHORT]		= "Primary scan data is too short",
+	[gs1_encoder_eSCAN_PRIMARY_TOO_LONG]		= "Primary message is too long",
+	[gs1_encoder_eSCAN_PRIMARY_NOT_DIGITS]		= "Primary message number only contain digits",
+	[gs1_encoder_eSCAN_PRIMARY_INCORRECT_CD]	= "Primary message check digit is incorrect",
+	[gs1_encoder_eSCAN_ILLEGAL_CARET]		= "Scan data contains illegal ^ character",
+	[gs1_encoder_eSCAN_FAILED]			= "Failed to process scan data",
+	[gs1_encoder_eCACHE_SIZE_INVALID]		= "Cache size must not be negative",
+	[gs1_encoder_eCACHE_ALLOC_FAILED]		= "Failed to allocate the cache",
+	[gs1_encoder_eSTATS_UNAVAILABLE]		= "Performance statistics are not available in this build",
+};
 
-	char *p;
-	char **hri;
-	int i, numhri;
-	int rem = (int)max;
 
-	assert(ctx);
-	reset_error(ctx);
+/*
+ *  Build the error message and linter markup from the error record, which is
+ *  deferred until they are first read since most callers never read them.
+ *
+ */
+static void formatErr(gs1_encoder* const ctx) {
 
-	numhri = gs1_encoder_getHRI(ctx, &hri);
+	const struct gs1_errRecord* const err = &ctx->err;
+	struct gs1_renderer r;
+	const char *f, *s;
+	char num[12];
+	int arg = 0;
 
-	p = buf;
-	*p = '\0';
-	for (i = 0; i < numhri; i++) {
-		rem -= (int)strlen(hri[i]) + 1;
-		if (rem < 0) {
-			*p = '\0';
+	assert(err->code >= gs1_encoder_eNO_ERROR && err->code < gs1_encoder_eNUMERRORS);
+
+	gs1_renderInit(&r, ctx->errMsg, sizeof(ctx->errMsg));
+	for (f = errFormats[err->code]; *f; f++) {
+		if (*f != '%') {
+			gs1_renderChar(&r, *f);
+			continue;
+		}
+		switch (*++f) {
+		case 's':
+			assert(arg < 2);
+			s = err->arg[arg++];
+			break;
+		case 'd':
+			snprintf(num, sizeof(num), "%d", err->num);
+			s = num;
+			break;
+		case 'l':
+			s = gs1_lint_err_str[ctx->linterErr];
+			break;
+		default:
+			assert(false);
 			return;
 		}
-		if (i != 0)
-			strcat(p, "|");
-		strcat(p, hri[i]);
+		gs1_renderN(&r, s, strlen(s));
 	}
+	gs1_renderEnd(&r);
+
+	// The linter markup surrounds the offending data within the AI value
+	gs1_renderInit(&r, ctx->linterErrMarkup, sizeof(ctx->linterErrMarkup));
+	if (err->code == gs1_encoder_eAI_LINT_FAILURE) {
+		s = err->arg[1];
+		gs1_renderChar(&r, '(');
+		gs1_renderN(&r, err->arg[0], strlen(err->arg[0]));
+		gs1_renderChar(&r, ')');
+		gs1_renderN(&r, s, err->offset);
+		gs1_renderChar(&r, '|');
+		gs1_renderN(&r, s + err->offset, err->length);
+		gs1_renderChar(&r, '|');
+		gs1_renderN(&r, s + err->offset + err->length, strlen(s) - err->offset - err->length);
+	}
+	gs1_renderEnd(&r);
 
-	return;
+	ctx->err.formatted = true;
 
 }
 
 
-int gs1_encoder_getDLignoredQueryParams(gs1_encoder* const ctx, char*** const out) {
+char* gs1_encoder_getErrMsg(gs1_encoder* const ctx) {
+	assert(ctx);
+	if (!ctx->err.formatted)
+		formatErr(ctx);
+	return ctx->errMsg;
+}
 
-	int i, j;
-	char *p = ctx->outStr;
 
+char* gs1_encoder_getErrMarkup(gs1_encoder* const ctx) {
 	assert(ctx);
-	assert(ctx->numAIs <= MAX_AIS);
-	reset_error(ctx);
+	if (!ctx->err.formatted)
+		formatErr(ctx);
+	return ctx->linterErrMarkup;
+}
 
-	*p = '\0';
-	for (i = 0, j = 0; i < ctx->numAIs; i++) {
 
-		const struct aiValue* const ai = &ctx->aiData[i];
-		int n;
+static inline gs1_encoder_error_record_t errRecord(const gs1_encoder* const ctx) {
+	return (gs1_encoder_error_record_t) {
+		.error = ctx->err.code,
+		.aiIndex = ctx->err.aiIndex,
+		.offset = ctx->err.offset,
+		.length = ctx->err.length,
+		.linterErr = (int)ctx->linterErr,
+	};
+}
 
-		if (ai->kind != alValue_dlign)
-			continue;
 
-		ctx->outHRI[j] = p;
+gs1_encoder_error_t gs1_encoder_getErrRecord(gs1_encoder* const ctx, gs1_encoder_error_record_t* const record) {
 
-		n = snprintf(p, sizeof(ctx->outStr) - (size_t)(p - ctx->outStr), "%.*s", ai->vallen, ai->value);
-		assert(n >= 0 && n < (int)(sizeof(ctx->outStr) - (size_t)(p - ctx->outStr)));
-		p += n;
+	assert(ctx);
 
-		*p++ = '\0';
+	if (record)
+		*record = errRecord(ctx);
 
-		j++;
+	return ctx->err.code;
+
+}
+
+
+int gs1_encoder_getErrRecords(gs1_encoder* const ctx, const gs1_encoder_error_record_t** const records) {
+
+	assert(ctx);
 
+	// An error that ended processing follows any that were collected
+	if (ctx->err.code != gs1_encoder_eNO_ERROR && !ctx->errCollected && ctx->numErrs < MAX_ERRS) {
+		ctx->errList[ctx->numErrs++] = errRecord(ctx);
+		ctx->errCollected = true;
 	}
 
-	*out = ctx->outHRI;
-	return j;
+	if (records)
+		*records = ctx->errList;
 
-}
+	return ctx->numErrs;
 
+}
 
-size_t gs1_encoder_getDLignoredQueryParamsSize(gs1_encoder* const ctx) {
 
-	size_t sz = 0;
-	int i;
-	char **qp;
-	const int numqp = gs1_encoder_getDLignoredQueryParams(ctx, &qp);
+/*
+ *  Utility functions
+ *
+ */
 
-	for (i = 0; i < numqp; i++)
-		sz += strlen(qp[i]) + 1;  // Includes "&" or NULL terminator
+void gs1_clearErr(gs1_encoder* const ctx) {
+	assert(ctx);
+	ctx->err.code = gs1_encoder_eNO_ERROR;
+	ctx->err.aiIndex = -1;
+	ctx->err.offset = ctx->err.length = 0;
+	ctx->err.formatted = false;
+	ctx->linterErr = GS1_LINTER_OK;
+	ctx->errAI = NULL;
+	ctx->errCollected = false;
+}
 
-	return sz;
 
+/*
+ *  Record a failure, whose message arguments are then given by
+ *  gs1_setErrArg() and whose linter error, if any, is set by the caller.
+ *
+ */
+void gs1_setErr(gs1_encoder* const ctx, const gs1_encoder_error_t code) {
+	assert(ctx);
+	ctx->err.code = code;
+	ctx->err.aiIndex = -1;
+	ctx->err.offset = ctx->err.length = 0;
+	ctx->err.num = 0;
+	*ctx->err.arg[0] = *ctx->err.arg[1] = '\0';
+	ctx->err.formatted = false;
+	ctx->linterErr = GS1_LINTER_OK;
+	ctx->errCollected = false;
 }
 
 
-void gs1_encoder_copyDLignoredQueryParams(gs1_encoder* const ctx, void* const buf, const size_t max) {
+void gs1_setErrArg(gs1_encoder* const ctx, const int n, const char* const arg, size_t len) {
+	assert(ctx);
+	assert(n >= 0 && n < (int)SIZEOF_ARRAY(ctx->err.arg));
+	if (len >= sizeof(ctx->err.arg[n]))
+		len = sizeof(ctx->err.arg[n]) - 1;
+	memcpy(ctx->err.arg[n], arg, len);
+	ctx->err.arg[n][len] = '\0';
+}
 
-	char *p;
-	char **qp;
-	int i, numqp;
-	int rem = (int)max;
+
+/*
+ *  When errors are being collected, add the error that has just been set to
+ *  the list and return true so that the caller carries on past it. Otherwise
+ *  return false for the caller to fail as usual.
+ *
+ */
+bool gs1_collectErr(gs1_encoder* const ctx) {
 
 	assert(ctx);
-	reset_error(ctx);
 
-	numqp = gs1_encoder_getDLignoredQueryParams(ctx, &qp);
+	if (!ctx->collectErrs)
+		return false;
 
-	p = buf;
-	*p = '\0';
-	for (i = 0; i < numqp; i++) {
-		rem -= (int)strlen(qp[i]) + 1;
-		if (rem < 0) {
-			*p = '\0';
-			return;
-		}
-		if (i != 0)
-			strcat(p, "&");
-		strcat(p, qp[i]);
+	if (ctx->numErrs == 0) {
+		ctx->firstErr = ctx->err;
+		ctx->firstLinterErr = ctx->linterErr;
 	}
 
-	return;
+	if (ctx->numErrs < MAX_ERRS)
+		ctx->errList[ctx->numErrs++] = errRecord(ctx);
+	ctx->errCollected = true;
+
+	return true;
 
 }
 
 
-__ATTR_PURE char* gs1_encoder_getErrMsg(gs1_encoder* const ctx) {
+/*
+ *  Once processing is complete, fail if any errors were collected along the
+ *  way, reporting the first of them.
+ *
+ */
+bool gs1_checkCollectedErrs(gs1_encoder* const ctx) {
+
 	assert(ctx);
-	return ctx->errMsg;
-}
 
+	if (ctx->numErrs == 0)
+		return true;
+
+	ctx->err = ctx->firstErr;
+	ctx->err.formatted = false;
+	ctx->linterErr = ctx->firstLinterErr;
+	ctx->errCollected = true;
+
+	return false;
 
-__ATTR_PURE char* gs1_encoder_getErrMarkup(gs1_encoder* const ctx) {
-	assert(ctx);
-	return ctx->linterErrMarkup;
 }
 
 
 /*
- *  Utility functions
+ *  Record a failure concerning the given AI, locating it among the extracted
+ *  AIs or otherwise at the position that it would have been extracted to.
  *
  */
+void gs1_setErrForAI(gs1_encoder* const ctx, const gs1_encoder_error_t code, const char* const ai, const size_t ailen) {
+
+	int i;
+
+	gs1_setErr(ctx, code);
+	gs1_setErrArg(ctx, 0, ai, ailen);
+
+	for (i = 0; i < ctx->numAIs && ctx->aiData[i].ai != ai; i++);
+	ctx->err.aiIndex = i;
+
+}
+
 
 __ATTR_PURE bool gs1_allDigits(const uint8_t* const str, size_t len) {
 
@@ -664,6 +1720,40 @@ void test_api_init(void) {
 }
 
 
+void test_api_sharedSyntaxDictionary(void) {
+
+	gs1_syntax_dictionary *sd;
+	gs1_encoder *ctx1, *ctx2;
+
+	TEST_ASSERT((sd = gs1_encoder_loadSyntaxDictionary(NULL)) != NULL);
+	assert(sd);
+	TEST_CHECK(sd->refCount == 1);
+
+	TEST_ASSERT((ctx1 = gs1_encoder_initWithSyntaxDictionary(NULL, sd)) != NULL);
+	assert(ctx1);
+	TEST_ASSERT((ctx2 = gs1_encoder_initWithSyntaxDictionary(NULL, sd)) != NULL);
+	assert(ctx2);
+	TEST_CHECK(ctx1->sd == sd && ctx2->sd == sd);
+	TEST_CHECK(sd->refCount == 3);
+
+	// The contexts keep the dictionary alive
+	gs1_encoder_freeSyntaxDictionary(sd);
+	TEST_CHECK(sd->refCount == 2);
+
+	// Settings remain private to each context
+	TEST_CHECK(gs1_encoder_setPermitUnknownAIs(ctx1, true));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx1, "(89)ABC"));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx2, "(89)ABC"));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx2, "(01)12345678901231"));
+
+	gs1_encoder_free(ctx1);
+	TEST_CHECK(sd->refCount == 1);
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx2, "(01)12345678901231(10)ABC"));
+	gs1_encoder_free(ctx2);
+
+}
+
+
 void test_api_defaults(void) {
 
 	gs1_encoder* ctx;
@@ -866,6 +1956,105 @@ void test_api_dataStr(void) {
 }
 
 
+void test_api_dataStrN(void) {
+
+	gs1_encoder* ctx;
+	static const char ro[] = "^011231231231233310ABC123" "\x1D" "99XYZ|^98COMPOSITE____";	// Trailing data excluded by length
+	static const char dl[] = "https://example.org/01/12312312312333/10/ABC123?17=201231&x=y#frag____";
+	char *out, *buf;
+	char **hri;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	// Validated in place, with GS as FNC1, and not NUL-terminated
+	TEST_ASSERT(gs1_encoder_setDataStrN(ctx, ro, sizeof(ro) - 5));
+	TEST_CHECK(ctx->numAIs == 5);
+	TEST_CHECK(ctx->aiData[0].value == ro + 3);			// AIs refer to the input
+	TEST_ASSERT((out = gs1_encoder_getAIdataStr(ctx)) != NULL);
+	assert(out);
+	TEST_CHECK(strcmp(out, "(01)12312312312333(10)ABC123(99)XYZ|(98)COMPOSITE") == 0);
+	TEST_CHECK(gs1_encoder_getHRI(ctx, &hri) == 4);
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^011231231231233310ABC123^99XYZ|^98COMPOSITE") == 0);
+
+	TEST_CHECK(!gs1_encoder_setDataStrN(ctx, ro, 1));		// Just FNC1
+	TEST_CHECK(!gs1_encoder_setDataStrN(ctx, "^01123", 3));		// Truncated value
+	TEST_CHECK(*gs1_encoder_getDataStr(ctx) == '\0');
+
+	// Plain data and GS1 DL URI
+	TEST_ASSERT(gs1_encoder_setDataStrN(ctx, "TESTING____", 7));
+	TEST_CHECK(gs1_encoder_getAIdataStr(ctx) == NULL);
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "TESTING") == 0);
+	TEST_ASSERT(gs1_encoder_setDataStrN(ctx, dl, sizeof(dl) - 5));
+	TEST_ASSERT((out = gs1_encoder_getAIdataStr(ctx)) != NULL);
+	assert(out);
+	TEST_CHECK(strcmp(out, "(01)12312312312333(10)ABC123(17)201231") == 0);
+	TEST_CHECK(gs1_encoder_getDLignoredQueryParams(ctx, &hri) == 1);
+	TEST_CHECK(strcmp(hri[0], "x=y") == 0);
+	TEST_CHECK(!gs1_encoder_setDataStrN(ctx, dl, 30));		// No value for path AI
+
+	// Exact-length buffers without a terminator are not read beyond their end
+	TEST_ASSERT((buf = malloc(sizeof(ro) - 5)) != NULL);
+	assert(buf);
+	memcpy(buf, ro, sizeof(ro) - 5);
+	TEST_CHECK(gs1_encoder_setDataStrN(ctx, buf, sizeof(ro) - 5));
+	TEST_CHECK(ctx->numAIs == 5);
+	free(buf);
+	TEST_ASSERT((buf = malloc(sizeof(dl) - 5)) != NULL);
+	assert(buf);
+	memcpy(buf, dl, sizeof(dl) - 5);
+	TEST_CHECK(gs1_encoder_setDataStrN(ctx, buf, sizeof(dl) - 5));
+	TEST_ASSERT((out = gs1_encoder_getAIdataStr(ctx)) != NULL);
+	assert(out);
+	TEST_CHECK(strcmp(out, "(01)12312312312333(10)ABC123(17)201231") == 0);
+	free(buf);
+
+	// Embedded NUL and too long
+	TEST_CHECK(!gs1_encoder_setDataStrN(ctx, "^0112312312312333\0", 18));
+	TEST_CHECK(gs1_encoder_setDataStrN(ctx, "", 0));
+	TEST_CHECK(!gs1_encoder_setDataStrN(ctx, bigbuffer, MAX_DATA + 1));
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_AIdataStrN(void) {
+
+	gs1_encoder* ctx;
+	static const char ro[] = "(01)12312312312333(10)ABC123|(99)XYZ\\(TM)____";
+	char *out, *buf;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	// The composite separator of read-only input is not written to
+	TEST_ASSERT(gs1_encoder_setAIdataStrN(ctx, ro, sizeof(ro) - 5));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^011231231231233310ABC123|^99XYZ(TM)") == 0);
+	TEST_ASSERT((out = gs1_encoder_getAIdataStr(ctx)) != NULL);
+	assert(out);
+	TEST_CHECK(strcmp(out, "(01)12312312312333(10)ABC123|(99)XYZ\\(TM)") == 0);
+
+	TEST_ASSERT(gs1_encoder_setAIdataStrN(ctx, ro, 18));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^0112312312312333") == 0);
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, ro, 17));		// Truncated value
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, ro, 4));		// No value
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, "(10)A\0B", 8));	// Embedded NUL
+	TEST_CHECK(*gs1_encoder_getDataStr(ctx) == '\0');
+
+	// An exact-length buffer without a terminator is not read beyond its end
+	TEST_ASSERT((buf = malloc(sizeof(ro) - 5)) != NULL);
+	assert(buf);
+	memcpy(buf, ro, sizeof(ro) - 5);
+	TEST_CHECK(gs1_encoder_setAIdataStrN(ctx, buf, sizeof(ro) - 5));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^011231231231233310ABC123|^99XYZ(TM)") == 0);
+	free(buf);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
 void test_api_getAIdataStr(void) {
 
 	gs1_encoder* ctx;
@@ -951,6 +2140,177 @@ void test_api_setScanData(void) {
 }
 
 
+#define BATCH_INPUT(s) { s, sizeof(s) - 1 }
+
+void test_api_setDataStrBatch(void) {
+
+	gs1_encoder* ctx;
+	gs1_encoder_batch_input_t inputs[] = {
+		BATCH_INPUT("^011231231231233310ABC123^99XYZ"),
+		{ "^0112312312312333XXXX", 17 },			// Not NUL-terminated
+		BATCH_INPUT("^0112312312312334"),			// Bad check digit
+		BATCH_INPUT("^011231231231233310ABC123^17991301"),	// Bad month
+		BATCH_INPUT("https://example.org/01/12312312312333/10/ABC%2D123?99=XYZ"),
+		BATCH_INPUT("https://example.org/01/12312312312333/10/ABC123?17=991301"),
+		BATCH_INPUT("barcode"),
+		BATCH_INPUT("^011231231231233310ABC|^99XYZ"),
+		BATCH_INPUT("^02123123123123331012"),			// Missing requisite AI
+		{ bigbuffer, MAX_DATA + 1 },
+	};
+	gs1_encoder_batch_result_t results[SIZEOF_ARRAY(inputs)];
+	gs1_encoder_batch_span_t spans[16];
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	memset(bigbuffer, 'A', MAX_DATA + 1);
+
+	TEST_CHECK(gs1_encoder_setDataStrBatch(ctx, inputs, SIZEOF_ARRAY(inputs), results, spans, SIZEOF_ARRAY(spans)) == 5);
+
+	TEST_CHECK(results[0].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[0].firstSpan == 0 && results[0].numSpans == 3);
+	TEST_CHECK(spans[0].aiOffset == 1 && spans[0].aiLength == 2 && spans[0].valueOffset == 3 && spans[0].valueLength == 14);
+	TEST_CHECK(spans[1].aiOffset == 17 && spans[1].valueOffset == 19 && spans[1].valueLength == 6);
+	TEST_CHECK(spans[2].aiOffset == 26 && spans[2].valueOffset == 28 && spans[2].valueLength == 3);
+
+	TEST_CHECK(results[1].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[1].firstSpan == 3 && results[1].numSpans == 1);
+	TEST_CHECK(spans[3].valueOffset == 3 && spans[3].valueLength == 14);
+
+	TEST_CHECK(results[2].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[2].linterErr == GS1_LINTER_INCORRECT_CHECK_DIGIT);
+	TEST_CHECK(results[2].errOffset == 16);
+	TEST_CHECK(results[2].numSpans == 0);
+
+	TEST_CHECK(results[3].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[3].linterErr == GS1_LINTER_ILLEGAL_MONTH);
+	TEST_CHECK(results[3].errOffset == 30);
+
+	// Spans of DL URI values include the percent-encoding
+	TEST_CHECK(results[4].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[4].firstSpan == 4 && results[4].numSpans == 3);
+	TEST_CHECK(spans[4].aiOffset == 20 && spans[4].valueOffset == 23 && spans[4].valueLength == 14);
+	TEST_CHECK(spans[5].aiOffset == 38 && spans[5].valueOffset == 41 && spans[5].valueLength == 9);
+	TEST_CHECK(spans[6].aiOffset == 51 && spans[6].valueOffset == 54 && spans[6].valueLength == 3);
+
+	TEST_CHECK(results[5].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[5].linterErr == GS1_LINTER_ILLEGAL_MONTH);
+	TEST_CHECK(results[5].errOffset == 53);
+
+	TEST_CHECK(results[6].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[6].numSpans == 0);
+
+	TEST_CHECK(results[7].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[7].firstSpan == 7 && results[7].numSpans == 3);
+	TEST_CHECK(spans[9].aiOffset == 24 && spans[9].valueOffset == 26 && spans[9].valueLength == 3);
+
+	TEST_CHECK(results[8].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[8].linterErr == GS1_LINTER_OK);
+	TEST_CHECK(results[8].errOffset == inputs[8].length);		// Not attributable to specific data
+
+	TEST_CHECK(results[9].status == gs1_encoder_bTOO_LONG);
+
+	// Valid messages whose spans do not fit are reported as such
+	TEST_CHECK(gs1_encoder_setDataStrBatch(ctx, inputs, 2, results, spans, 2) == 1);
+	TEST_CHECK(results[0].status == gs1_encoder_bNO_SPANS);
+	TEST_CHECK(results[0].numSpans == 0);
+	TEST_CHECK(results[1].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[1].firstSpan == 0 && results[1].numSpans == 1);
+
+	// The context is left with the last message
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^0112312312312333") == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_setAIdataStrBatch(void) {
+
+	gs1_encoder* ctx;
+	const gs1_encoder_batch_input_t inputs[] = {
+		BATCH_INPUT("(01)12312312312333(10)AB\\(C"),
+		BATCH_INPUT("(01)12312312312333(10)ABC(17)991301"),	// Bad month
+		BATCH_INPUT("(01)12312312312333|(10)ABC"),
+		BATCH_INPUT("(01)12312312312333(10)ABC(99)"),		// Empty value
+		BATCH_INPUT("(01)1231231231233(10)ABC"),		// Too short
+	};
+	gs1_encoder_batch_result_t results[SIZEOF_ARRAY(inputs)];
+	gs1_encoder_batch_span_t spans[16];
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_CHECK(gs1_encoder_setAIdataStrBatch(ctx, inputs, SIZEOF_ARRAY(inputs), results, spans, SIZEOF_ARRAY(spans)) == 2);
+
+	TEST_CHECK(results[0].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[0].firstSpan == 0 && results[0].numSpans == 2);
+	TEST_CHECK(spans[0].aiOffset == 1 && spans[0].aiLength == 2 && spans[0].valueOffset == 4 && spans[0].valueLength == 14);
+	TEST_CHECK(spans[1].aiOffset == 19 && spans[1].valueOffset == 22 && spans[1].valueLength == 5);	// Includes escape
+
+	TEST_CHECK(results[1].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[1].linterErr == GS1_LINTER_ILLEGAL_MONTH);
+	TEST_CHECK(results[1].errOffset == 31);
+
+	TEST_CHECK(results[2].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[2].firstSpan == 2 && results[2].numSpans == 2);
+	TEST_CHECK(spans[3].aiOffset == 20 && spans[3].valueOffset == 23 && spans[3].valueLength == 3);
+
+	TEST_CHECK(results[3].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[3].errOffset == inputs[3].length);
+
+	TEST_CHECK(results[4].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[4].errOffset == 4);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_setScanDataBatch(void) {
+
+	gs1_encoder* ctx;
+	const gs1_encoder_batch_input_t inputs[] = {
+		BATCH_INPUT("]e0011231231231233310ABC123" "\x1D" "99XYZ"),
+		BATCH_INPUT("]Q1https://example.org/01/12312312312333"),
+		BATCH_INPUT("]e0011231231231233410ABC"),			// Bad check digit
+		BATCH_INPUT("]e0011231231231233310ABC" "\x1D" "17991301"),	// Bad month
+		BATCH_INPUT("]X0ABC"),						// Unsupported
+	};
+	gs1_encoder_batch_result_t results[SIZEOF_ARRAY(inputs)];
+	gs1_encoder_batch_span_t spans[16];
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_CHECK(gs1_encoder_setScanDataBatch(ctx, inputs, SIZEOF_ARRAY(inputs), results, spans, SIZEOF_ARRAY(spans)) == 2);
+
+	TEST_CHECK(results[0].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[0].firstSpan == 0 && results[0].numSpans == 3);
+	TEST_CHECK(spans[0].aiOffset == 3 && spans[0].valueOffset == 5 && spans[0].valueLength == 14);
+	TEST_CHECK(spans[1].aiOffset == 19 && spans[1].valueOffset == 21 && spans[1].valueLength == 6);
+	TEST_CHECK(spans[2].aiOffset == 28 && spans[2].valueOffset == 30 && spans[2].valueLength == 3);
+
+	TEST_CHECK(results[1].status == gs1_encoder_bVALID);
+	TEST_CHECK(results[1].firstSpan == 3 && results[1].numSpans == 1);
+	TEST_CHECK(spans[3].aiOffset == 23 && spans[3].valueOffset == 26 && spans[3].valueLength == 14);
+
+	TEST_CHECK(results[2].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[2].linterErr == GS1_LINTER_INCORRECT_CHECK_DIGIT);
+	TEST_CHECK(results[2].errOffset == 18);
+
+	TEST_CHECK(results[3].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[3].linterErr == GS1_LINTER_ILLEGAL_MONTH);
+	TEST_CHECK(results[3].errOffset == 29);
+
+	TEST_CHECK(results[4].status == gs1_encoder_bINVALID);
+	TEST_CHECK(results[4].errOffset == inputs[4].length);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
 void test_api_getHRI(void) {
 
 	gs1_encoder* ctx;
@@ -1110,6 +2470,252 @@ DIAG_POP
 }
 
 
+void test_api_render(void) {
+
+	gs1_encoder* ctx;
+	char buf[128];
+	char small[8];
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	// No AI data renders an empty string
+	TEST_CHECK(gs1_encoder_renderHRI(ctx, buf, sizeof(buf)) == 0);
+	TEST_CHECK(buf[0] == '\0');
+	TEST_CHECK(gs1_encoder_renderAIdataStr(ctx, buf, sizeof(buf)) == 0);
+	TEST_CHECK(buf[0] == '\0');
+
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "https://a/01/12312312312333/22/TESTING?99=ABC%2d123&x=y&98=XYZ&z"));
+	TEST_CHECK(gs1_encoder_renderHRI(ctx, buf, sizeof(buf)) == 54);
+	TEST_CHECK(strcmp(buf, "(01) 12312312312333|(22) TESTING|(99) ABC-123|(98) XYZ") == 0);
+	TEST_CHECK(gs1_encoder_renderAIdataStr(ctx, buf, sizeof(buf)) == 47);
+	TEST_CHECK(strcmp(buf, "(01)12312312312333(22)TESTING(99)ABC-123(98)XYZ") == 0);
+	TEST_CHECK(gs1_encoder_renderDLignoredQueryParams(ctx, buf, sizeof(buf)) == 5);
+	TEST_CHECK(strcmp(buf, "x=y&z") == 0);
+	TEST_CHECK(gs1_encoder_renderDLuri(ctx, "https://example.com/", buf, sizeof(buf)) == 66);
+	TEST_CHECK(strcmp(buf, "https://example.com/01/12312312312333/22/TESTING?99=ABC-123&98=XYZ") == 0);
+
+	// Truncated as by snprintf(), returning the required length
+	TEST_CHECK(gs1_encoder_renderHRI(ctx, small, sizeof(small)) == 54);
+	TEST_CHECK(strcmp(small, "(01) 12") == 0);
+	TEST_CHECK(gs1_encoder_renderAIdataStr(ctx, NULL, 0) == 47);
+	TEST_CHECK(gs1_encoder_renderDLuri(ctx, NULL, small, 1) == 65);
+	TEST_CHECK(small[0] == '\0');
+
+	// Results rendered consecutively into one buffer persist
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333(10)ABC\\(1"));
+	TEST_CHECK(gs1_encoder_renderAIdataStr(ctx, buf, sizeof(buf)) == 28);
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(00)123456789012345675"));
+	TEST_CHECK(gs1_encoder_renderAIdataStr(ctx, buf + 29, sizeof(buf) - 29) == 22);
+	TEST_CHECK(strcmp(buf, "(01)12312312312333(10)ABC\\(1") == 0);
+	TEST_CHECK(strcmp(buf + 29, "(00)123456789012345675") == 0);
+
+	// No primary key
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(99)ABC"));
+	TEST_CHECK(gs1_encoder_renderDLuri(ctx, NULL, buf, sizeof(buf)) == 0);
+	TEST_CHECK(buf[0] == '\0');
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_getNextAI(void) {
+
+	gs1_encoder* ctx;
+	gs1_encoder_ai_t ai;
+	int cursor = 0;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_CHECK(!gs1_encoder_getNextAI(ctx, &cursor, &ai));		// No AIs
+
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "https://a/01/12312312312333/22/TESTING?x=y&17=201231"));
+	TEST_ASSERT(gs1_encoder_getNextAI(ctx, &cursor, &ai));
+	TEST_CHECK(ai.aiLength == 2 && memcmp(ai.ai, "01", 2) == 0);
+	TEST_CHECK(ai.valueLength == 14 && memcmp(ai.value, "12312312312333", 14) == 0);
+	TEST_CHECK(!ai.fnc1);
+	TEST_CHECK(ai.dlPathOrder == 0);
+	TEST_CHECK(strcmp(ai.title, "GTIN") == 0);
+	TEST_ASSERT(gs1_encoder_getNextAI(ctx, &cursor, &ai));
+	TEST_CHECK(ai.aiLength == 2 && memcmp(ai.ai, "22", 2) == 0);
+	TEST_CHECK(ai.fnc1);
+	TEST_CHECK(ai.dlPathOrder == 1);
+	TEST_ASSERT(gs1_encoder_getNextAI(ctx, &cursor, &ai));		// Skips ignored query param
+	TEST_CHECK(ai.aiLength == 2 && memcmp(ai.ai, "17", 2) == 0);
+	TEST_CHECK(ai.valueLength == 6 && memcmp(ai.value, "201231", 6) == 0);
+	TEST_CHECK(ai.dlPathOrder == -1);
+	TEST_CHECK(!gs1_encoder_getNextAI(ctx, &cursor, &ai));
+
+	// Composite separator is skipped
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333|(10)ABC\\(1(21)XYZ"));
+	cursor = 0;
+	TEST_ASSERT(gs1_encoder_getNextAI(ctx, &cursor, &ai));
+	TEST_ASSERT(gs1_encoder_getNextAI(ctx, &cursor, &ai));
+	TEST_CHECK(ai.aiLength == 2 && memcmp(ai.ai, "10", 2) == 0);
+	TEST_CHECK(ai.valueLength == 5 && memcmp(ai.value, "ABC(1", 5) == 0);
+	TEST_CHECK(ai.dlPathOrder == -1);
+	TEST_ASSERT(gs1_encoder_getNextAI(ctx, &cursor, &ai));
+	TEST_CHECK(!gs1_encoder_getNextAI(ctx, &cursor, &ai));
+
+	TEST_ASSERT(gs1_encoder_findAI(ctx, "21", &ai));
+	TEST_CHECK(ai.valueLength == 3 && memcmp(ai.value, "XYZ", 3) == 0);
+	TEST_CHECK(strcmp(ai.title, "SERIAL") == 0);
+	TEST_CHECK(!gs1_encoder_findAI(ctx, "17", &ai));
+	TEST_CHECK(!gs1_encoder_findAI(ctx, "2", &ai));
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_getErrRecord(void) {
+
+	gs1_encoder* ctx;
+	gs1_encoder_error_record_t rec;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, &rec) == gs1_encoder_eNO_ERROR);
+	TEST_CHECK(rec.aiIndex == -1);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "") == 0);
+
+	// Messages are only formatted once they are read
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901234"));
+	TEST_CHECK(!ctx->err.formatted);
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, &rec) == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(rec.error == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(rec.aiIndex == 0);
+	TEST_CHECK(rec.offset == 13 && rec.length == 1);
+	TEST_CHECK(rec.linterErr == GS1_LINTER_INCORRECT_CHECK_DIGIT);
+	TEST_CHECK(!ctx->err.formatted);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "AI (01): The numeric check digit is incorrect.") == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getErrMsg(ctx));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMarkup(ctx), "(01)1234567890123|4|") == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getErrMarkup(ctx));
+
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(10)ABC(11)991332"));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, &rec) == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(rec.aiIndex == 1);
+	TEST_CHECK(rec.offset == 2 && rec.length == 2);
+	TEST_CHECK(rec.linterErr == GS1_LINTER_ILLEGAL_MONTH);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMarkup(ctx), "(11)99|13|32") == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getErrMarkup(ctx));
+
+	// Associations are attributed to the offending instance
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(10)ABC(01)12312312312333(02)12312312312333"));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, &rec) == gs1_encoder_eAI_INVALID_PAIRING);
+	TEST_CHECK(rec.linterErr == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "It is invalid to pair AI (02) with AI (01)") == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getErrMsg(ctx));
+	TEST_CHECK(rec.aiIndex == 2);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMarkup(ctx), "") == 0);
+
+	TEST_CHECK(!gs1_encoder_setDataStr(ctx, "https://a/01/12312312312333?99=ABC&99=DEF"));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, NULL) == gs1_encoder_eDL_AI_DUPLICATED);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "AI (99) is duplicated") == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getErrMsg(ctx));
+
+	TEST_CHECK(!gs1_encoder_setSym(ctx, gs1_encoder_sNUMSYMS));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, &rec) == gs1_encoder_eUNKNOWN_SYMBOLOGY);
+	TEST_CHECK(rec.aiIndex == -1);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Unknown symbology") == 0);
+
+	// Success clears the error, including the location of the last failure
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(10)ABC(11)991332"));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, &rec) == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(rec.aiIndex == 1 && rec.offset == 2 && rec.length == 2);
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333"));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, &rec) == gs1_encoder_eNO_ERROR);
+	TEST_CHECK(rec.aiIndex == -1 && rec.offset == 0 && rec.length == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "") == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMarkup(ctx), "") == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_collectErrors(void) {
+
+	gs1_encoder* ctx;
+	const gs1_encoder_error_record_t *recs;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_CHECK(!gs1_encoder_getCollectErrors(ctx));			// Default
+
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901234(11)991332"));
+	TEST_ASSERT(gs1_encoder_getErrRecords(ctx, &recs) == 1);
+	TEST_CHECK(recs[0].error == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(recs[0].linterErr == GS1_LINTER_INCORRECT_CHECK_DIGIT);
+
+	TEST_CHECK(gs1_encoder_setCollectErrors(ctx, true));
+	TEST_CHECK(gs1_encoder_getCollectErrors(ctx));
+
+	// Linter failures in each AI, reporting the first
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901234(11)991332"));
+	TEST_ASSERT(gs1_encoder_getErrRecords(ctx, &recs) == 2);
+	TEST_CHECK(recs[0].error == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(recs[0].linterErr == GS1_LINTER_INCORRECT_CHECK_DIGIT);
+	TEST_CHECK(recs[0].aiIndex == 0);
+	TEST_CHECK(recs[1].error == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(recs[1].linterErr == GS1_LINTER_ILLEGAL_MONTH);
+	TEST_CHECK(recs[1].aiIndex == 1);
+	TEST_CHECK(recs[1].offset == 2 && recs[1].length == 2);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMarkup(ctx), "(01)1234567890123|4|") == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getErrMarkup(ctx));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, NULL) == gs1_encoder_eAI_LINT_FAILURE);
+
+	// The linters of a component with bad characters are skipped
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)1234567890123A"));
+	TEST_ASSERT(gs1_encoder_getErrRecords(ctx, &recs) == 1);
+	TEST_CHECK(recs[0].linterErr == GS1_LINTER_NON_DIGIT_CHARACTER);
+
+	// Association failures alongside linter failures
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(21)ABC(11)991332"));
+	TEST_ASSERT(gs1_encoder_getErrRecords(ctx, &recs) == 3);
+	TEST_CHECK(recs[0].error == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(recs[0].aiIndex == 1);
+	TEST_CHECK(recs[1].error == gs1_encoder_eAI_REQUISITES_UNSATISFIED);
+	TEST_CHECK(recs[1].aiIndex == 0);
+	TEST_CHECK(recs[2].error == gs1_encoder_eAI_REQUISITES_UNSATISFIED);
+	TEST_CHECK(recs[2].aiIndex == 1);
+	TEST_CHECK(strncmp(gs1_encoder_getErrMsg(ctx), "AI (11): ", 9) == 0);
+	TEST_MSG("Got: %s", gs1_encoder_getErrMsg(ctx));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, NULL) == gs1_encoder_eAI_LINT_FAILURE);
+
+	// Failures following a linter failure carry no linter error
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(10)ABC(17)991399"));
+	TEST_ASSERT(gs1_encoder_getErrRecords(ctx, &recs) == 3);
+	TEST_CHECK(recs[0].error == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(recs[0].linterErr == GS1_LINTER_ILLEGAL_MONTH);
+	TEST_CHECK(recs[1].error == gs1_encoder_eAI_REQUISITES_UNSATISFIED);
+	TEST_CHECK(recs[1].linterErr == GS1_LINTER_OK);
+	TEST_CHECK(recs[2].error == gs1_encoder_eAI_REQUISITES_UNSATISFIED);
+	TEST_CHECK(recs[2].linterErr == GS1_LINTER_OK);
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, NULL) == gs1_encoder_eAI_LINT_FAILURE);
+
+	// An error that is not recoverable ends processing and is listed last
+	TEST_CHECK(!gs1_encoder_setDataStr(ctx, "^01123456789012341"));
+	TEST_ASSERT(gs1_encoder_getErrRecords(ctx, &recs) == 2);
+	TEST_CHECK(recs[0].error == gs1_encoder_eAI_LINT_FAILURE);
+	TEST_CHECK(recs[1].error == gs1_encoder_eAI_NO_KNOWN_PREFIX);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "No known AI is a prefix of: 1...") == 0);
+	TEST_CHECK(gs1_encoder_getErrRecords(ctx, NULL) == 2);
+
+	// Success
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333(11)991231"));
+	TEST_CHECK(gs1_encoder_getErrRecords(ctx, &recs) == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
 void test_api_getDLignoredQueryParams(void) {
 
 	gs1_encoder* ctx;
@@ -331,12 +331,301 @@ typedef enum gs1_encoder_validations gs1_encoder_validations_t;
  *
  * \note
  * The library is thread-safe provided that each thread operates on its own
- * instance of the library.
+ * instance of the library. Instances operating in different threads may share
+ * a single ::gs1_syntax_dictionary.
  *
  */
 typedef struct gs1_encoder gs1_encoder;
 
 
+/**
+ * @brief A loaded Syntax Dictionary that can be shared by ::gs1_encoder contexts.
+ *
+ * This is an opaque, reference-counted struct holding the AI table and the
+ * lookup structures that are derived from it. Its content never changes once
+ * it has been loaded so any number of contexts, including those operating in
+ * different threads, may be attached to a single instance. This avoids the
+ * cost of parsing the Syntax Dictionary and the memory required to hold it
+ * being incurred for each context.
+ *
+ * A dictionary is created by calling gs1_encoder_loadSyntaxDictionary(),
+ * attached to new contexts with gs1_encoder_initWithSyntaxDictionary(), and
+ * the caller's reference is dropped with gs1_encoder_freeSyntaxDictionary().
+ * The storage is released once the caller's reference and all of the attached
+ * contexts have been freed, in any order.
+ *
+ */
+typedef struct gs1_syntax_dictionary gs1_syntax_dictionary;
+
+
+/**
+ * @brief A pool of threads that validates batches of messages.
+ *
+ * This is an opaque struct created by calling gs1_engine_init() and destroyed
+ * by calling gs1_engine_free().
+ *
+ * Each batch is divided into chunks of messages that are claimed in turn by
+ * whichever thread is idle. The results are committed in the order of the
+ * messages, so they do not depend upon the number of threads or how the
+ * chunks were shared out.
+ *
+ * \note
+ * Regarding the thread-safety of the library state: a ::gs1_encoder context
+ * must only be used by one thread at a time, whereas a ::gs1_syntax_dictionary
+ * is never modified once loaded and may be shared by contexts in any number of
+ * threads. An engine owns a context for each of its threads. Its batch
+ * functions must not be called concurrently for the same engine, but separate
+ * engines may be used concurrently.
+ *
+ */
+typedef struct gs1_engine gs1_engine;
+
+
+/// Outcome of processing a message with gs1_encoder_setDataStrBatch(), gs1_encoder_setAIdataStrBatch() or gs1_encoder_setScanDataBatch().
+enum gs1_encoder_batch_status {
+	// Exported as API. Not to be re-ordered.
+	gs1_encoder_bVALID = 0,			///< The message is valid and the spans of its AIs have been recorded
+	gs1_encoder_bINVALID,			///< The message was rejected by the same checks as the corresponding setter
+	gs1_encoder_bTOO_LONG,			///< The message is longer than can be processed
+	gs1_encoder_bNO_SPANS,			///< The message is valid but too little space remained for the spans of its AIs
+};
+
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_batch_status` type.
+ *
+ */
+typedef enum gs1_encoder_batch_status gs1_encoder_batch_status_t;
+
+
+/**
+ * @brief A message given to the batch functions.
+ *
+ * The data need not be NUL-terminated and it is never modified.
+ *
+ */
+typedef struct gs1_encoder_batch_input {
+	const char *data;			///< Start of the message
+	size_t length;				///< Length of the message in bytes
+} gs1_encoder_batch_input_t;
+
+
+/**
+ * @brief The location of an extracted AI within its message.
+ *
+ * The value length is that of the value as it appears in the message,
+ * including any "\(" escapes or percent-encoding. An AI that cannot be
+ * matched against the message has its offsets set to the length of the
+ * message and its lengths set to zero.
+ *
+ */
+typedef struct gs1_encoder_batch_span {
+	size_t aiOffset;			///< Offset of the AI within the message
+	size_t aiLength;			///< Length of the AI
+	size_t valueOffset;			///< Offset of the AI value within the message
+	size_t valueLength;			///< Length of the AI value within the message
+} gs1_encoder_batch_span_t;
+
+
+/**
+ * @brief The outcome of processing a message given to the batch functions.
+ *
+ */
+typedef struct gs1_encoder_batch_result {
+	gs1_encoder_batch_status_t status;	///< Whether the message is valid, one of ::gs1_encoder_batch_status
+	int linterErr;				///< The `gs1_lint_err_t` of a Syntax Dictionary linter that rejected an AI component, otherwise zero
+	size_t errOffset;			///< Offset within the message of the offending data, or the length of the message when it cannot be attributed to specific data
+	size_t firstSpan;			///< Position of the first of the message's AI spans in the span array
+	size_t numSpans;			///< Number of AI spans recorded for the message
+} gs1_encoder_batch_result_t;
+
+
+/**
+ * @brief An extracted AI, as returned by gs1_encoder_getNextAI() and
+ * gs1_encoder_findAI().
+ *
+ * The AI and value are not NUL-terminated. They refer to data held by the
+ * context, or to the caller's buffer when given to gs1_encoder_setDataStrN(),
+ * so they remain valid only until new data is set. The data title and
+ * attributes refer to the Syntax Dictionary and remain valid for as long as
+ * the context.
+ *
+ */
+typedef struct gs1_encoder_ai {
+	const char *ai;				///< Start of the AI
+	size_t aiLength;			///< Length of the AI
+	const char *value;			///< Start of the AI value, with any escaping or percent-encoding removed
+	size_t valueLength;			///< Length of the AI value
+	bool fnc1;				///< Whether an FNC1 separator is required when the AI is followed by another
+	int dlPathOrder;			///< Position of the AI within the path info of a GS1 Digital Link URI, otherwise -1
+	const char *title;			///< Data title of the AI, or an empty string
+	const char *attrs;			///< Syntax Dictionary attributes of the AI, such as "req=" and "ex=", or an empty string
+} gs1_encoder_ai_t;
+
+
+/// Entry point by which a message was given, as counted by gs1_encoder_getStats().
+enum gs1_encoder_message_entry {
+	gs1_encoder_mDATA_STR = 0,		///< gs1_encoder_setDataStr(), gs1_encoder_setDataStrN() and gs1_encoder_setDataStrBatch()
+	gs1_encoder_mAI_DATA_STR,		///< gs1_encoder_setAIdataStr(), gs1_encoder_setAIdataStrN() and gs1_encoder_setAIdataStrBatch()
+	gs1_encoder_mSCAN_DATA,			///< gs1_encoder_setScanData() and gs1_encoder_setScanDataBatch()
+	gs1_encoder_mNUMENTRIES,
+};
+
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_message_entry` type.
+ *
+ */
+typedef enum gs1_encoder_message_entry gs1_encoder_message_entry_t;
+
+
+/// Phase of processing, as timed by gs1_encoder_getStats() and reported to a gs1_encoder_phase_callback_t.
+enum gs1_encoder_phase {
+	gs1_encoder_pPARSE = 0,			///< Extraction of the AIs from a message
+	gs1_encoder_pLINT,			///< Validation of the components of an AI value by the character set checks and linters
+	gs1_encoder_pVALIDATE,			///< Validation of the extracted AIs as a whole, such as their mandatory associations
+	gs1_encoder_pRENDER,			///< Generation of AI data, HRI, DL URI or scan data output
+	gs1_encoder_pNUMPHASES,
+};
+
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_phase` type.
+ *
+ */
+typedef enum gs1_encoder_phase gs1_encoder_phase_t;
+
+
+#define GS1_ENCODER_STATS_MAX_LINTERS		64	///< Capacity of gs1_encoder_stats_t.linterCalls
+#define GS1_ENCODER_STATS_MAX_LINT_ERRS		256	///< Capacity of gs1_encoder_stats_t.lintFailures
+
+
+/**
+ * @brief Performance counters and phase timings, as returned by
+ * gs1_encoder_getStats().
+ *
+ * Time spent in a phase excludes any time spent in other phases that are
+ * nested within it, so that the phase times do not overlap.
+ *
+ */
+typedef struct gs1_encoder_stats {
+	size_t messages[gs1_encoder_mNUMENTRIES];	///< Messages given by each ::gs1_encoder_message_entry
+	size_t failures[gs1_encoder_mNUMENTRIES];	///< Messages rejected for each ::gs1_encoder_message_entry
+	size_t aisProcessed;				///< AIs extracted from the messages that were accepted
+	size_t linterCalls[GS1_ENCODER_STATS_MAX_LINTERS];	///< Invocations of each linter, as named by gs1_encoder_getStatsLinterName()
+	size_t lintFailures[GS1_ENCODER_STATS_MAX_LINT_ERRS];	///< Linter failures by `gs1_lint_err_t`
+	size_t validationFailures[gs1_encoder_vNUMVALIDATIONS];	///< Failures of each ::gs1_encoder_validations procedure
+	unsigned long long phaseNs[gs1_encoder_pNUMPHASES];	///< Nanoseconds spent in each ::gs1_encoder_phase
+} gs1_encoder_stats_t;
+
+
+/**
+ * @brief The start or end of a phase of processing, as reported to a
+ * gs1_encoder_phase_callback_t.
+ *
+ */
+typedef struct gs1_encoder_phase_event {
+	gs1_encoder_phase_t phase;		///< The phase, one of ::gs1_encoder_phase
+	bool end;				///< False at the start of the phase; true at its end
+	unsigned long long ns;			///< At the end of the phase, the nanoseconds elapsed since its start, including any nested phases, otherwise zero
+	const char *ai;				///< For the lint phase, the AI whose value is being validated, which is not NUL-terminated, otherwise NULL
+	size_t aiLength;			///< Length of the AI, otherwise zero
+} gs1_encoder_phase_event_t;
+
+
+/**
+ * @brief A function that is called at the start and end of each phase of
+ * processing, as registered using gs1_encoder_setPhaseCallback().
+ *
+ * The callback must not call the library functions for the same context.
+ *
+ */
+typedef void (*gs1_encoder_phase_callback_t)(gs1_encoder *ctx, const gs1_encoder_phase_event_t *event, void *userData);
+
+
+/// Reason that the most recent call to a setter function failed, as returned by gs1_encoder_getErrRecord().
+enum gs1_encoder_error {
+	// Exported as API. Not to be re-ordered.
+	gs1_encoder_eNO_ERROR = 0,		///< No error has occurred
+	gs1_encoder_eUNKNOWN_SYMBOLOGY,		///< "Unknown symbology"
+	gs1_encoder_eUNKNOWN_VALIDATION,	///< "Unknown validation"
+	gs1_encoder_eLOCKED_VALIDATION,		///< "This validation cannont be amended"
+	gs1_encoder_eTOO_MANY_AIS,		///< "Too many AIs"
+	gs1_encoder_eDATA_TOO_LONG,		///< "Maximum data length is ... characters"
+	gs1_encoder_eDATA_ILLEGAL_NUL,		///< "Data contains an illegal null character"
+	gs1_encoder_eAI_DATA_ILLEGAL_NUL,	///< "AI data contains an illegal null character"
+	gs1_encoder_eAI_INCORRECT_LENGTH,	///< "AI (...) data has incorrect length"
+	gs1_encoder_eAI_LINT_FAILURE,		///< "AI (...): ...", the text of the linter error
+	gs1_encoder_eAI_VALUE_EMPTY,		///< "AI (...) data is empty"
+	gs1_encoder_eAI_VALUE_TOO_SHORT,	///< "AI (...) value is too short"
+	gs1_encoder_eAI_VALUE_TOO_LONG,		///< "AI (...) value is too long"
+	gs1_encoder_eAI_VALUE_ILLEGAL_CARET,	///< "AI (...) contains illegal ^ character"
+	gs1_encoder_eAI_UNRECOGNISED,		///< "Unrecognised AI: ..."
+	gs1_encoder_eAI_PARSE_FAILED,		///< "Failed to parse AI data"
+	gs1_encoder_eMISSING_FNC1_IN_FIRST,	///< "Missing FNC1 in first position"
+	gs1_encoder_eAI_DATA_EMPTY,		///< "The AI data is empty"
+	gs1_encoder_eAI_NO_KNOWN_PREFIX,	///< "No known AI is a prefix of: ..."
+	gs1_encoder_eAI_DATA_TOO_LONG,		///< "AI (...) data is too long"
+	gs1_encoder_eAI_INVALID_PAIRING,	///< "It is invalid to pair AI (...) with AI (...)"
+	gs1_encoder_eAI_REQUISITES_UNSATISFIED,	///< "Required AIs for AI (...) are not satisfied: ..."
+	gs1_encoder_eAI_INSTANCES_DIFFER,	///< "Multiple instances of AI (...) have different values"
+	gs1_encoder_eAI_SERIAL_REQUIRED,	///< "Serial component must be present for AI (...) when used with AI (8030)"
+	gs1_encoder_eDL_ILLEGAL_CHARACTERS,	///< "URI contains illegal characters"
+	gs1_encoder_eDL_BAD_SCHEME,		///< "Scheme must be http:// or HTTP:// or https:// or HTTPS://"
+	gs1_encoder_eDL_NO_PATH_INFO,		///< "URI must contain a domain and path info"
+	gs1_encoder_eDL_NO_KEYS,		///< "No GS1 DL keys found in path info"
+	gs1_encoder_eDL_PATH_VALUE_EMPTY,	///< "AI (...) value path element is empty"
+	gs1_encoder_eDL_PATH_VALUE_ILLEGAL_NUL,	///< "Decoded AI (...) from DL path info contains illegal null character"
+	gs1_encoder_eDL_QUERY_AI_UNKNOWN,	///< "Unknown AI (...) in query parameters"
+	gs1_encoder_eDL_QUERY_VALUE_EMPTY,	///< "AI (...) value query element is empty"
+	gs1_encoder_eDL_QUERY_VALUE_ILLEGAL_NUL,///< "Decoded AI (...) value from DL query params contains illegal null character"
+	gs1_encoder_eDL_INVALID_KEY_QUALIFIERS,	///< "The AIs in the path are not a valid key-qualifier sequence for the key"
+	gs1_encoder_eDL_AI_DUPLICATED,		///< "AI (...) is duplicated"
+	gs1_encoder_eDL_INVALID_ATTRIBUTE,	///< "AI (...) is not a valid DL URI data attribute"
+	gs1_encoder_eDL_ATTRIBUTE_IN_PATH,	///< "AI (...) from query params should be in the path info"
+	gs1_encoder_eDL_PARSE_FAILED,		///< "Failed to parse DL data"
+	gs1_encoder_eDL_NO_PRIMARY_KEY,		///< "Cannot create a DL URI without a primary key AI"
+	gs1_encoder_ePRIMARY_WRONG_LENGTH_NO_CD,///< "Primary data must be ... digits without check digit"
+	gs1_encoder_ePRIMARY_WRONG_LENGTH,	///< "Primary data must be ... digits"
+	gs1_encoder_ePRIMARY_NOT_DIGITS,	///< "Primary data must be all digits"
+	gs1_encoder_ePRIMARY_INCORRECT_CD,	///< "Primary data check digit is incorrect"
+	gs1_encoder_ePRIMARY_VALUE_TOO_LARGE,	///< "Primary data item value is too large"
+	gs1_encoder_eSCAN_MISSING_SYMID,	///< "Missing symbology identifier"
+	gs1_encoder_eSCAN_UNSUPPORTED_SYMID,	///< "Unsupported symbology identifier"
+	gs1_encoder_eSCAN_PRIMARY_TOO_SHORT,	///< "Primary scan data is too short"
+	gs1_encoder_eSCAN_PRIMARY_TOO_LONG,	///< "Primary message is too long"
+	gs1_encoder_eSCAN_PRIMARY_NOT_DIGITS,	///< "Primary message number only contain digits"
+	gs1_encoder_eSCAN_PRIMARY_INCORRECT_CD,	///< "Primary message check digit is incorrect"
+	gs1_encoder_eSCAN_ILLEGAL_CARET,	///< "Scan data contains illegal ^ character"
+	gs1_encoder_eSCAN_FAILED,		///< "Failed to process scan data"
+	gs1_encoder_eCACHE_SIZE_INVALID,	///< "Cache size must not be negative"
+	gs1_encoder_eCACHE_ALLOC_FAILED,	///< "Failed to allocate the cache"
+	gs1_encoder_eSTATS_UNAVAILABLE,		///< "Performance statistics are not available in this build"
+	gs1_encoder_eNUMERRORS,
+};
+
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_error` type.
+ *
+ */
+typedef enum gs1_encoder_error gs1_encoder_error_t;
+
+
+/**
+ * @brief The reason that the most recent call to a setter function failed,
+ * as returned by gs1_encoder_getErrRecord().
+ *
+ */
+typedef struct gs1_encoder_error_record {
+	gs1_encoder_error_t error;		///< The reason for the failure, one of ::gs1_encoder_error
+	int aiIndex;				///< Position of the offending AI as given by gs1_encoder_getNextAI(), which may be the number of AIs extracted when the AI was rejected before it could be extracted, otherwise -1
+	size_t offset;				///< Offset of the offending data within the AI value
+	size_t length;				///< Length of the offending data within the AI value, or zero when the error is not attributed to specific data
+	int linterErr;				///< The `gs1_lint_err_t` of a Syntax Dictionary linter that rejected an AI component, otherwise zero
+} gs1_encoder_error_record_t;
+
+
 /**
  * @brief Get the version string of the library.
  *
@@ -429,6 +718,91 @@ GS1_ENCODERS_API int gs1_encoder_getMaxDataStrLength(void);
 GS1_ENCODERS_API gs1_encoder* gs1_encoder_init(void *mem);
 
 
+/**
+ * @brief Load a Syntax Dictionary that can be shared by multiple ::gs1_encoder contexts.
+ *
+ * The file may either be in the Syntax Dictionary text format or be an image
+ * created by gs1_encoder_compileSyntaxDictionary(). An image is mapped into
+ * memory read-only and used in place, so loading it is much faster than
+ * parsing the text format and the pages holding it are shared by all
+ * processes that load the same image.
+ *
+ * If the given file cannot be processed then a diagnostic is emitted and the
+ * embedded AI table is used instead, which is the same behaviour as
+ * gs1_encoder_init().
+ *
+ * The caller holds a reference to the returned dictionary which must be
+ * released with gs1_encoder_freeSyntaxDictionary().
+ *
+ * @see gs1_encoder_initWithSyntaxDictionary()
+ *
+ * @param [in] fname filename of the Syntax Dictionary, or NULL for the default
+ * @return ::gs1_syntax_dictionary on success, else NULL.
+ */
+GS1_ENCODERS_API gs1_syntax_dictionary* gs1_encoder_loadSyntaxDictionary(const char *fname);
+
+
+/**
+ * @brief Initialise a new ::gs1_encoder context that uses an existing Syntax Dictionary.
+ *
+ * This is equivalent to gs1_encoder_init() except that rather than loading a
+ * Syntax Dictionary of its own the context is attached to the given
+ * dictionary, which is a constant-time operation.
+ *
+ * The context holds its own reference to the dictionary until it is freed by
+ * gs1_encoder_free().
+ *
+ * Example of a number of contexts sharing a single dictionary:
+ *
+ * \code{.c}
+ * gs1_syntax_dictionary *sd = gs1_encoder_loadSyntaxDictionary(NULL);
+ * gs1_encoder *ctx1 = gs1_encoder_initWithSyntaxDictionary(NULL, sd);
+ * gs1_encoder *ctx2 = gs1_encoder_initWithSyntaxDictionary(NULL, sd);
+ * gs1_encoder_freeSyntaxDictionary(sd);  // The contexts keep the dictionary alive
+ * ...
+ * gs1_encoder_free(ctx1);
+ * gs1_encoder_free(ctx2);                // Dictionary is released here
+ * \endcode
+ *
+ * @see gs1_encoder_init()
+ * @see gs1_encoder_loadSyntaxDictionary()
+ *
+ * @param [in,out] mem buffer to use for storage, or NULL for automatic allocation
+ * @param [in,out] sd ::gs1_syntax_dictionary to attach, or NULL to load the default
+ * @return ::gs1_encoder context on success, else NULL.
+ */
+GS1_ENCODERS_API gs1_encoder* gs1_encoder_initWithSyntaxDictionary(void *mem, gs1_syntax_dictionary *sd);
+
+
+/**
+ * @brief Release a reference to a ::gs1_syntax_dictionary.
+ *
+ * The dictionary is destroyed once there are no remaining references to it,
+ * including those held by attached contexts.
+ *
+ * @param [in,out] sd ::gs1_syntax_dictionary to release
+ */
+GS1_ENCODERS_API void gs1_encoder_freeSyntaxDictionary(gs1_syntax_dictionary *sd);
+
+
+/**
+ * @brief Compile a Syntax Dictionary into a binary image.
+ *
+ * The resulting image can be passed to gs1_encoder_loadSyntaxDictionary()
+ * which will then avoid the cost of parsing the text format.
+ *
+ * The image is specific to the byte order of the host that created it. It
+ * should be regenerated whenever the Syntax Dictionary is updated.
+ *
+ * If the Syntax Dictionary cannot be processed then a diagnostic is emitted.
+ *
+ * @param [in] infile filename of the Syntax Dictionary, or NULL for the default
+ * @param [in] outfile filename to which the compiled image is written
+ * @return true on success, otherwise false
+ */
+GS1_ENCODERS_API bool gs1_encoder_compileSyntaxDictionary(const char *infile, const char *outfile);
+
+
 /**
  * @brief Read an error message generated by the library.
  *
@@ -515,6 +889,48 @@ GS1_ENCODERS_API char* gs1_encoder_getErrMsg(gs1_encoder *ctx);
 GS1_ENCODERS_API char* gs1_encoder_getErrMarkup(gs1_encoder *ctx);
 
 
+/**
+ * @brief Read the reason that the most recent call to a setter function
+ * failed, as a structured record.
+ *
+ * This is cheaper than gs1_encoder_getErrMsg() and gs1_encoder_getErrMarkup(),
+ * which format their text from this record only when they are called, and is
+ * suitable for processing large volumes of data programmatically.
+ *
+ * @see ::gs1_encoder_error_record_t
+ *
+ * @param [in] ctx ::gs1_encoder context
+ * @param [out] record the error record, or NULL if only the error code is required
+ * @return the error code, which is ::gs1_encoder_eNO_ERROR if the most recent call succeeded
+ */
+GS1_ENCODERS_API gs1_encoder_error_t gs1_encoder_getErrRecord(gs1_encoder *ctx, gs1_encoder_error_record_t *record);
+
+
+/**
+ * @brief Read every error found by the most recent call to a setter
+ * function.
+ *
+ * When errors are collected, as enabled by gs1_encoder_setCollectErrors(),
+ * the list holds each recoverable error in the order that it was found,
+ * followed by any error that ended processing. Otherwise it holds the single
+ * error that is returned by gs1_encoder_getErrRecord(). The list is bounded,
+ * with any further errors being discarded.
+ *
+ * \note
+ * The returned array does not need to be free()ed and its content should be
+ * copied if it must persist in user code after any subsequent library
+ * function calls.
+ *
+ * @see gs1_encoder_setCollectErrors()
+ * @see ::gs1_encoder_error_record_t
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] records pointer to the array of error records, or NULL if only the count is required
+ * @return the number of error records, which is zero if the most recent call succeeded
+ */
+GS1_ENCODERS_API int gs1_encoder_getErrRecords(gs1_encoder *ctx, const gs1_encoder_error_record_t **records);
+
+
 /**
  * @brief Get the current symbology type.
  *
@@ -684,6 +1100,157 @@ GS1_ENCODERS_API bool gs1_encoder_getIncludeDataTitlesInHRI(gs1_encoder *ctx);
 GS1_ENCODERS_API bool gs1_encoder_setIncludeDataTitlesInHRI(gs1_encoder *ctx, bool includeDataTitles);
 
 
+/**
+ * @brief Get the current status of the "collect errors" flag.
+ *
+ * @see gs1_encoder_setCollectErrors()
+ * @see gs1_encoder_getErrRecords()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @return current status of the collect errors flag
+ */
+GS1_ENCODERS_API bool gs1_encoder_getCollectErrors(gs1_encoder *ctx);
+
+
+/**
+ * @brief Enable or disable the "collect errors" flag.
+ *
+ *   * If false (default), then processing of AI-based data stops at the first error.
+ *   * If true, then processing continues past recoverable errors, namely the failure of an AI component's character set or linter checks and the failure of an AI association check such as a "req" or "ex" rule, so that every such error in the data is found in a single pass. The setter still fails when any error is found.
+ *
+ * The errors are read using gs1_encoder_getErrRecords(), and gs1_encoder_getErrMsg() reports the first of them unless processing was ended by an error that is not recoverable.
+ *
+ * @see gs1_encoder_getCollectErrors()
+ * @see gs1_encoder_getErrRecords()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] collectErrors enabled if true; disabled if false
+ * @return true on success, otherwise false and an error message is set that can be read using gs1_encoder_getErrMsg()
+ */
+GS1_ENCODERS_API bool gs1_encoder_setCollectErrors(gs1_encoder *ctx, bool collectErrors);
+
+
+/**
+ * @brief Get the number of entries in the cache of processed inputs.
+ *
+ * @see gs1_encoder_setCacheSize()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @return number of cache entries, or zero if the cache is disabled
+ */
+GS1_ENCODERS_API int gs1_encoder_getCacheSize(gs1_encoder *ctx);
+
+
+/**
+ * @brief Set the number of entries in the cache of processed inputs.
+ *
+ * When enabled, the outcome of processing each input given to
+ * gs1_encoder_setDataStr(), gs1_encoder_setAIdataStr() and
+ * gs1_encoder_setScanData() is remembered, keyed by the input together with
+ * the options and enabled validations that affect its processing. When the
+ * same input is given again under the same settings the extracted AIs and
+ * any error are restored without the input being processed again, which
+ * benefits applications that see the same data repeatedly.
+ *
+ * Each entry holds a single input, and an input replaces whatever entry it
+ * maps to. Inputs longer than 255 characters are not cached, and nothing is
+ * cached while errors are being collected.
+ *
+ * Setting the size discards any existing entries and resets the counters
+ * reported by gs1_encoder_getCacheStats(). A size of zero (default) disables
+ * the cache.
+ *
+ * \note
+ * The cache is allocated on the heap, so it is unavailable when the library
+ * is built with NOMALLOC.
+ *
+ * @see gs1_encoder_getCacheSize()
+ * @see gs1_encoder_getCacheStats()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] entries number of cache entries, or zero to disable the cache
+ * @return true on success, otherwise false and an error message is set that can be read using gs1_encoder_getErrMsg()
+ */
+GS1_ENCODERS_API bool gs1_encoder_setCacheSize(gs1_encoder *ctx, int entries);
+
+
+/**
+ * @brief Get the number of cache hits and misses since the cache was sized.
+ *
+ * @see gs1_encoder_setCacheSize()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] hits number of inputs whose outcome was restored from the cache, or NULL
+ * @param [out] misses number of eligible inputs that had to be processed, or NULL
+ */
+GS1_ENCODERS_API void gs1_encoder_getCacheStats(gs1_encoder *ctx, size_t *hits, size_t *misses);
+
+
+/**
+ * @brief Get the performance counters and phase timings of the context.
+ *
+ * The counters accumulate from the creation of the context, or from the
+ * most recent call to gs1_encoder_resetStats().
+ *
+ * \note
+ * The statistics are only gathered when the library is built with
+ * PERF_STATS, which adds a small cost to processing. Otherwise this
+ * function fails.
+ *
+ * @see gs1_encoder_resetStats()
+ * @see gs1_encoder_setPhaseCallback()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] stats snapshot of the statistics
+ * @return true on success, otherwise false and an error message is set that can be read using gs1_encoder_getErrMsg()
+ */
+GS1_ENCODERS_API bool gs1_encoder_getStats(gs1_encoder *ctx, gs1_encoder_stats_t *stats);
+
+
+/**
+ * @brief Reset the performance counters and phase timings of the context to
+ * zero.
+ *
+ * @see gs1_encoder_getStats()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @return true on success, otherwise false and an error message is set that can be read using gs1_encoder_getErrMsg()
+ */
+GS1_ENCODERS_API bool gs1_encoder_resetStats(gs1_encoder *ctx);
+
+
+/**
+ * @brief Register a function to be called at the start and end of each phase
+ * of processing.
+ *
+ * This allows the time spent on individual messages, and on individual AIs
+ * within the lint phase, to be traced. Only a single callback is registered
+ * at a time.
+ *
+ * \note
+ * As for gs1_encoder_getStats(), this requires the library to be built with
+ * PERF_STATS.
+ *
+ * @see gs1_encoder_phase_callback_t
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] callback function to call, or NULL to remove any callback
+ * @param [in] userData passed to the callback
+ * @return true on success, otherwise false and an error message is set that can be read using gs1_encoder_getErrMsg()
+ */
+GS1_ENCODERS_API bool gs1_encoder_setPhaseCallback(gs1_encoder *ctx, gs1_encoder_phase_callback_t callback, void *userData);
+
+
+/**
+ * @brief Get the name of the linter whose invocations are counted at the given
+ * position of gs1_encoder_stats_t.linterCalls.
+ *
+ * @param [in] index position within gs1_encoder_stats_t.linterCalls
+ * @return name of the linter, such as "csum", or NULL beyond the last linter
+ */
+GS1_ENCODERS_API const char* gs1_encoder_getStatsLinterName(int index);
+
+
 /**
  * @brief Get the current enabled status of the provided AI validation procedure
  *
@@ -839,6 +1406,35 @@ GS1_ENCODERS_API char* gs1_encoder_getDataStr(gs1_encoder *ctx);
 GS1_ENCODERS_API bool gs1_encoder_setDataStr(gs1_encoder *ctx, const char *dataStr);
 
 
+/**
+ * @brief Sets the raw barcode message from a length-delimited buffer that is
+ * validated where it lies.
+ *
+ * As gs1_encoder_setDataStr(), except that the input need not be
+ * NUL-terminated and is neither modified nor copied during validation. ASCII
+ * GS characters are accepted as FNC1 in place of "^", so that a message read
+ * from scan data without its symbology identifier can be given directly.
+ *
+ * The extracted AI data refers to the caller's buffer, which must therefore
+ * remain valid and unchanged until the results have been retrieved or new
+ * data is set. The buffer is only copied, with GS converted to "^", when the
+ * message is requested by gs1_encoder_getDataStr() or
+ * gs1_encoder_getScanData().
+ *
+ * This is suited to validating messages directly within read-only memory
+ * mapped files and network buffers.
+ *
+ * @see gs1_encoder_setDataStr()
+ * @see gs1_encoder_setAIdataStrN()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] dataStr pointer to the raw barcode data
+ * @param [in] len length of the data in bytes
+ * @return true on success, otherwise false and an error message is set that can be read using gs1_encoder_getErrMsg()
+ */
+GS1_ENCODERS_API bool gs1_encoder_setDataStrN(gs1_encoder *ctx, const char *dataStr, size_t len);
+
+
 /**
  * @brief Sets the data in the buffer that is used when buffer input is
  * selected by parsing input provided in GS1 Application Identifier syntax into
@@ -891,6 +1487,25 @@ GS1_ENCODERS_API bool gs1_encoder_setDataStr(gs1_encoder *ctx, const char *dataS
 GS1_ENCODERS_API bool gs1_encoder_setAIdataStr(gs1_encoder *ctx, const char *dataStr);
 
 
+/**
+ * @brief Sets the barcode message by parsing a length-delimited buffer of
+ * input in GS1 Application Identifier syntax.
+ *
+ * As gs1_encoder_setAIdataStr(), except that the input need not be
+ * NUL-terminated and is never modified. The input is parsed directly into the
+ * buffer returned by gs1_encoder_getDataStr(), which is the only copy made.
+ *
+ * @see gs1_encoder_setAIdataStr()
+ * @see gs1_encoder_setDataStrN()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] dataStr pointer to the barcode input data in GS1 Application Identifier syntax
+ * @param [in] len length of the data in bytes
+ * @return true on success, otherwise false and an error message is set
+ */
+GS1_ENCODERS_API bool gs1_encoder_setAIdataStrN(gs1_encoder *ctx, const char *dataStr, size_t len);
+
+
 /**
  * @brief Return the barcode input data buffer in human-friendly AI syntax
  *
@@ -920,6 +1535,74 @@ GS1_ENCODERS_API bool gs1_encoder_setAIdataStr(gs1_encoder *ctx, const char *dat
 GS1_ENCODERS_API char* gs1_encoder_getAIdataStr(gs1_encoder *ctx);
 
 
+/**
+ * @brief Render the barcode input data in human-friendly AI syntax into a
+ * caller-provided buffer.
+ *
+ * As gs1_encoder_getAIdataStr(), except that the output is written to the
+ * given buffer rather than to a buffer within the context, so it persists
+ * across subsequent calls and several results can be rendered consecutively
+ * into one allocation.
+ *
+ * As with snprintf(), the output is truncated to fit the buffer, is always
+ * null-terminated when size is non-zero, and the full length is returned.
+ * Therefore the output is complete if the return value is less than size, and
+ * a size of zero may be given to determine the length that is required. An
+ * empty string is rendered for non-AI input data.
+ *
+ * @see gs1_encoder_getAIdataStr()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] buf a buffer into which the AI data is rendered, or NULL if size is zero
+ * @param [in] size the size of the buffer in bytes, including space for the null terminator
+ * @return the length of the AI data, excluding the null terminator
+ */
+GS1_ENCODERS_API size_t gs1_encoder_renderAIdataStr(gs1_encoder *ctx, char *buf, size_t size);
+
+
+/**
+ * @brief Iterate over the AIs extracted from the input data, without
+ * formatting them.
+ *
+ * The cursor should be initialised to zero. Each call describes the next AI
+ * and advances the cursor, until no AIs remain:
+ *
+ * \code
+ * int cursor = 0;
+ * gs1_encoder_ai_t ai;
+ *
+ * while (gs1_encoder_getNextAI(ctx, &cursor, &ai))
+ *     printf("(%.*s) %.*s\n", (int)ai.aiLength, ai.ai, (int)ai.valueLength, ai.value);
+ * \endcode
+ *
+ * Ignored query parameters of a GS1 Digital Link URI and the separator of a
+ * composite component are skipped.
+ *
+ * @see gs1_encoder_findAI()
+ * @see ::gs1_encoder_ai_t
+ *
+ * @param [in] ctx ::gs1_encoder context
+ * @param [in,out] cursor position of the iteration, initially zero
+ * @param [out] ai the next AI
+ * @return true if an AI was returned, otherwise false when no AIs remain
+ */
+GS1_ENCODERS_API bool gs1_encoder_getNextAI(gs1_encoder *ctx, int *cursor, gs1_encoder_ai_t *ai);
+
+
+/**
+ * @brief Find the first instance of a given AI that was extracted from the
+ * input data.
+ *
+ * @see gs1_encoder_getNextAI()
+ *
+ * @param [in] ctx ::gs1_encoder context
+ * @param [in] ai the AI to find, e.g. "01"
+ * @param [out] out the AI, if found
+ * @return true if the AI was found, otherwise false
+ */
+GS1_ENCODERS_API bool gs1_encoder_findAI(gs1_encoder *ctx, const char *ai, gs1_encoder_ai_t *out);
+
+
 /**
  * @brief Returns a GS1 Digital Link URI representing AI-based input data.
  *
@@ -960,6 +1643,25 @@ GS1_ENCODERS_API char* gs1_encoder_getAIdataStr(gs1_encoder *ctx);
 GS1_ENCODERS_API char* gs1_encoder_getDLuri(gs1_encoder *ctx, const char *stem);
 
 
+/**
+ * @brief Render a GS1 Digital Link URI representing AI-based input data into
+ * a caller-provided buffer.
+ *
+ * As gs1_encoder_getDLuri(), with the output written to the given buffer
+ * under the same truncation rules as gs1_encoder_renderAIdataStr().
+ *
+ * @see gs1_encoder_getDLuri()
+ * @see gs1_encoder_renderAIdataStr()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] stem a URI "stem" used as a prefix for the URI. If NULL, the GS1 canonical stem (`https://id.gs1.org/`) will be used.
+ * @param [out] buf a buffer into which the URI is rendered, or NULL if size is zero
+ * @param [in] size the size of the buffer in bytes, including space for the null terminator
+ * @return the length of the URI, excluding the null terminator, or 0 if the URI cannot be created in which case an error message is set that can be read using gs1_encoder_getErrMsg()
+ */
+GS1_ENCODERS_API size_t gs1_encoder_renderDLuri(gs1_encoder *ctx, const char *stem, char *buf, size_t size);
+
+
 /**
  * @brief Process normalised scan data received from a barcode reader with
  * reporting of AIM symbology identifiers enabled to extract the message data
@@ -1079,6 +1781,180 @@ GS1_ENCODERS_API bool gs1_encoder_setScanData(gs1_encoder* ctx, const char *scan
 GS1_ENCODERS_API char* gs1_encoder_getScanData(gs1_encoder* ctx);
 
 
+/**
+ * @brief Validate an array of messages in the format accepted by
+ * gs1_encoder_setDataStr(), reporting the outcome for each.
+ *
+ * Each message is processed exactly as by gs1_encoder_setDataStr(), but
+ * rather than setting an error message the outcome is written to the
+ * corresponding element of the results array. For valid messages the location
+ * of each extracted AI and its value within the message is appended to the
+ * spans array, so that the AI data can be read directly from the input.
+ *
+ * This avoids the overheads of calling gs1_encoder_setDataStr() once for each
+ * message when large numbers of messages are to be validated.
+ *
+ * \note
+ * The context is left as it would be by the processing of the last message,
+ * so for example its extracted AI data can be read when it is valid. The error
+ * message is not set.
+ *
+ * @see gs1_encoder_setDataStr()
+ * @see gs1_encoder_setAIdataStrBatch()
+ * @see gs1_encoder_setScanDataBatch()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] inputs array of messages, which need not be NUL-terminated
+ * @param [in] count number of messages
+ * @param [out] results array of at least `count` results
+ * @param [out] spans array to receive the AI spans of the valid messages
+ * @param [in] maxSpans capacity of the spans array
+ * @return the number of messages that are valid
+ */
+GS1_ENCODERS_API size_t gs1_encoder_setDataStrBatch(gs1_encoder *ctx, const gs1_encoder_batch_input_t *inputs, size_t count, gs1_encoder_batch_result_t *results, gs1_encoder_batch_span_t *spans, size_t maxSpans);
+
+
+/**
+ * @brief Validate an array of messages in the format accepted by
+ * gs1_encoder_setAIdataStr(), reporting the outcome for each.
+ *
+ * As gs1_encoder_setDataStrBatch(), for bracketed AI element strings. The
+ * value spans include any "\(" escapes.
+ *
+ * @see gs1_encoder_setAIdataStr()
+ * @see gs1_encoder_setDataStrBatch()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] inputs array of messages, which need not be NUL-terminated
+ * @param [in] count number of messages
+ * @param [out] results array of at least `count` results
+ * @param [out] spans array to receive the AI spans of the valid messages
+ * @param [in] maxSpans capacity of the spans array
+ * @return the number of messages that are valid
+ */
+GS1_ENCODERS_API size_t gs1_encoder_setAIdataStrBatch(gs1_encoder *ctx, const gs1_encoder_batch_input_t *inputs, size_t count, gs1_encoder_batch_result_t *results, gs1_encoder_batch_span_t *spans, size_t maxSpans);
+
+
+/**
+ * @brief Validate an array of messages in the format accepted by
+ * gs1_encoder_setScanData(), reporting the outcome for each.
+ *
+ * As gs1_encoder_setDataStrBatch(), for scan data including the AIM
+ * symbology identifier.
+ *
+ * @see gs1_encoder_setScanData()
+ * @see gs1_encoder_setDataStrBatch()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] inputs array of messages, which need not be NUL-terminated
+ * @param [in] count number of messages
+ * @param [out] results array of at least `count` results
+ * @param [out] spans array to receive the AI spans of the valid messages
+ * @param [in] maxSpans capacity of the spans array
+ * @return the number of messages that are valid
+ */
+GS1_ENCODERS_API size_t gs1_encoder_setScanDataBatch(gs1_encoder *ctx, const gs1_encoder_batch_input_t *inputs, size_t count, gs1_encoder_batch_result_t *results, gs1_encoder_batch_span_t *spans, size_t maxSpans);
+
+
+/**
+ * @brief Create a ::gs1_engine for validating batches of messages using a
+ * pool of threads.
+ *
+ * Each thread of the engine has its own context that is configured with the
+ * options of the given context at the time that the engine is created, such
+ * as gs1_encoder_setPermitUnknownAIs() and gs1_encoder_setValidationEnabled(),
+ * and is attached to the same ::gs1_syntax_dictionary. Later changes to the
+ * given context do not affect the engine, and the given context may be freed
+ * whilst the engine is in use.
+ *
+ * The thread that calls the engine's batch functions participates in the
+ * work, so an engine with a single thread does not start any others.
+ *
+ * @see gs1_engine_free()
+ * @see gs1_engine_setDataStrBatch()
+ *
+ * @param [in] ctx ::gs1_encoder context whose options and Syntax Dictionary are used by the engine
+ * @param [in] numThreads number of threads, including the caller, or 0 for one per processor
+ * @return a new engine, or NULL on failure
+ */
+GS1_ENCODERS_API gs1_engine* gs1_engine_init(gs1_encoder *ctx, int numThreads);
+
+
+/**
+ * @brief Get the number of threads used by a ::gs1_engine, including the
+ * calling thread.
+ *
+ * @param [in] engine ::gs1_engine instance
+ * @return the number of threads
+ */
+GS1_ENCODERS_API int gs1_engine_getNumThreads(gs1_engine *engine);
+
+
+/**
+ * @brief Validate an array of messages in the format accepted by
+ * gs1_encoder_setDataStr() using the threads of a ::gs1_engine.
+ *
+ * The results, the allocation of AI spans and the return value are identical
+ * to those of gs1_encoder_setDataStrBatch() for a context with the engine's
+ * options, whatever the number of threads.
+ *
+ * @see gs1_encoder_setDataStrBatch()
+ *
+ * @param [in,out] engine ::gs1_engine instance
+ * @param [in] inputs array of messages, which need not be NUL-terminated
+ * @param [in] count number of messages
+ * @param [out] results array of at least `count` results
+ * @param [out] spans array to receive the AI spans of the valid messages
+ * @param [in] maxSpans capacity of the spans array
+ * @return the number of messages that are valid
+ */
+GS1_ENCODERS_API size_t gs1_engine_setDataStrBatch(gs1_engine *engine, const gs1_encoder_batch_input_t *inputs, size_t count, gs1_encoder_batch_result_t *results, gs1_encoder_batch_span_t *spans, size_t maxSpans);
+
+
+/**
+ * @brief Validate an array of messages in the format accepted by
+ * gs1_encoder_setAIdataStr() using the threads of a ::gs1_engine.
+ *
+ * @see gs1_encoder_setAIdataStrBatch()
+ * @see gs1_engine_setDataStrBatch()
+ *
+ * @param [in,out] engine ::gs1_engine instance
+ * @param [in] inputs array of messages, which need not be NUL-terminated
+ * @param [in] count number of messages
+ * @param [out] results array of at least `count` results
+ * @param [out] spans array to receive the AI spans of the valid messages
+ * @param [in] maxSpans capacity of the spans array
+ * @return the number of messages that are valid
+ */
+GS1_ENCODERS_API size_t gs1_engine_setAIdataStrBatch(gs1_engine *engine, const gs1_encoder_batch_input_t *inputs, size_t count, gs1_encoder_batch_result_t *results, gs1_encoder_batch_span_t *spans, size_t maxSpans);
+
+
+/**
+ * @brief Validate an array of messages in the format accepted by
+ * gs1_encoder_setScanData() using the threads of a ::gs1_engine.
+ *
+ * @see gs1_encoder_setScanDataBatch()
+ * @see gs1_engine_setDataStrBatch()
+ *
+ * @param [in,out] engine ::gs1_engine instance
+ * @param [in] inputs array of messages, which need not be NUL-terminated
+ * @param [in] count number of messages
+ * @param [out] results array of at least `count` results
+ * @param [out] spans array to receive the AI spans of the valid messages
+ * @param [in] maxSpans capacity of the spans array
+ * @return the number of messages that are valid
+ */
+GS1_ENCODERS_API size_t gs1_engine_setScanDataBatch(gs1_engine *engine, const gs1_encoder_batch_input_t *inputs, size_t count, gs1_encoder_batch_result_t *results, gs1_encoder_batch_span_t *spans, size_t maxSpans);
+
+
+/**
+ * @brief Stop the threads of a ::gs1_engine and release its resources.
+ *
+ * @param [in,out] engine ::gs1_engine instance, or NULL
+ */
+GS1_ENCODERS_API void gs1_engine_free(gs1_engine *engine);
+
+
 /**
  * @brief Update a given pointer towards an array of strings containing
  * Human-Readable Interpretation ("HRI") text.
@@ -1110,6 +1986,29 @@ GS1_ENCODERS_API char* gs1_encoder_getScanData(gs1_encoder* ctx);
 GS1_ENCODERS_API int gs1_encoder_getHRI(gs1_encoder* ctx, char ***hri);
 
 
+/**
+ * @brief Render the Human-Readable Interpretation ("HRI") text into a
+ * caller-provided buffer as a "|"-separated string.
+ *
+ * For the example given for gs1_encoder_getHRI() the following would be
+ * rendered:
+ *
+ *     (01) 12312312312333|(10) ABC123|(99) XYZ(TM) CORP
+ *
+ * The output is written under the same truncation rules as
+ * gs1_encoder_renderAIdataStr().
+ *
+ * @see gs1_encoder_getHRI()
+ * @see gs1_encoder_renderAIdataStr()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] buf a buffer into which the HRI text is rendered, or NULL if size is zero
+ * @param [in] size the size of the buffer in bytes, including space for the null terminator
+ * @return the length of the HRI text, excluding the null terminator
+ */
+GS1_ENCODERS_API size_t gs1_encoder_renderHRI(gs1_encoder *ctx, char *buf, size_t size);
+
+
 /**
  * @brief Get the require HRI buffer size.
  *
@@ -1184,6 +2083,24 @@ GS1_ENCODERS_API DEPRECATED void gs1_encoder_copyHRI(gs1_encoder *ctx, void *buf
 GS1_ENCODERS_API int gs1_encoder_getDLignoredQueryParams(gs1_encoder* ctx, char ***qp);
 
 
+/**
+ * @brief Render the non-numeric (ignored) query parameters of a GS1 Digital
+ * Link URI into a caller-provided buffer as an "&"-separated string.
+ *
+ * The output is written under the same truncation rules as
+ * gs1_encoder_renderAIdataStr().
+ *
+ * @see gs1_encoder_getDLignoredQueryParams()
+ * @see gs1_encoder_renderAIdataStr()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] buf a buffer into which the query parameters are rendered, or NULL if size is zero
+ * @param [in] size the size of the buffer in bytes, including space for the null terminator
+ * @return the length of the query parameters, excluding the null terminator
+ */
+GS1_ENCODERS_API size_t gs1_encoder_renderDLignoredQueryParams(gs1_encoder *ctx, char *buf, size_t size);
+
+
 /**
  * @brief Get the require buffer size for ignored GS1 Digital Link query
  * parameters.
@@ -127,13 +127,10 @@ static void lookupSymAndModeBySymId(const char* const symId, gs1_encoder_symbolo
 }
 
 
-static void scancat(char* const out, const char* const in) {
+static void scancat(struct gs1_writer* const out, const char* const in) {
 
 	const char *p = in;
-	char *q = out;
-
-	while (*q)
-		q++;						// Got to end of output
+	char *q = out->cur;				// Continue from end of output
 
 	if (*p == '^') {					// GS1 mode
 
@@ -156,6 +153,9 @@ static void scancat(char* const out, const char* const in) {
 	}
 	*q = '\0';
 
+	assert(q <= out->end);				// Output is sized for the longest message
+	out->cur = q;
+
 }
 
 
@@ -184,15 +184,18 @@ static bool validateParity(uint8_t *str) {
 static bool checkAndNormalisePrimaryData(gs1_encoder* const ctx, const char *dataStr, char* const primaryStr, int length) {
 
 	if (strlen(dataStr) != (size_t)(ctx->addCheckDigit ? length-1 : length)) {
-		if (ctx->addCheckDigit)
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Primary data must be %d digits without check digit", length - 1);
-		else
-			snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Primary data must be %d digits", length);
+		if (ctx->addCheckDigit) {
+			gs1_setErr(ctx, gs1_encoder_ePRIMARY_WRONG_LENGTH_NO_CD);
+			ctx->err.num = length - 1;
+		} else {
+			gs1_setErr(ctx, gs1_encoder_ePRIMARY_WRONG_LENGTH);
+			ctx->err.num = length;
+		}
 		return false;
 	}
 
 	if (!gs1_allDigits((uint8_t*)dataStr, 0)) {
-		strcpy(ctx->errMsg, "Primary data must be all digits");
+		gs1_setErr(ctx, gs1_encoder_ePRIMARY_NOT_DIGITS);
 		return false;
 	}
 
@@ -202,7 +205,7 @@ static bool checkAndNormalisePrimaryData(gs1_encoder* const ctx, const char *dat
 		strcat(primaryStr, "-");
 
 	if (!validateParity((uint8_t*)primaryStr) && !ctx->addCheckDigit) {
-		strcpy(ctx->errMsg, "Primary data check digit is incorrect");
+		gs1_setErr(ctx, gs1_encoder_ePRIMARY_INCORRECT_CD);
 		return false;
 	}
 
@@ -219,10 +222,11 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 	const char *dataStr;
 	int length, aizeros;
 	char* ret;
+	struct gs1_writer out;
 
 	assert(ctx);
 
-	*ctx->outStr = '\0';
+	gs1_writerInit(&out, ctx->outStr, sizeof(ctx->outStr) - 1);
 
 	if ((cc = strchr(ctx->dataStr, '|')) != NULL)		// Delimit end of linear data
 		*cc++ = '\0';
@@ -241,9 +245,9 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 			cc = NULL;
 		}
 
-		strcat(ctx->outStr, "]");
-		strncat(ctx->outStr, lookupSymId(ctx), 2);
-		scancat(ctx->outStr, ctx->dataStr);
+		gs1_writeChar(&out, ']');
+		gs1_writeN(&out, lookupSymId(ctx), 2);
+		scancat(&out, ctx->dataStr);
 		break;
 
 	case gs1_encoder_sGS1_128_CCA:
@@ -253,9 +257,9 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 			// "]C1" for linear-only GS1-128
 			if (*ctx->dataStr != '^')
 				goto fail;
-			strcat(ctx->outStr, "]");
-			strncat(ctx->outStr, lookupSymId(ctx), 2);
-			scancat(ctx->outStr, ctx->dataStr);
+			gs1_writeChar(&out, ']');
+			gs1_writeN(&out, lookupSymId(ctx), 2);
+			scancat(&out, ctx->dataStr);
 			break;
 		}
 
@@ -266,8 +270,8 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 		// "]e0" followed by concatenated AI data from linear and CC
 		if (*ctx->dataStr != '^')
 			goto fail;
-		strcat(ctx->outStr, CC_SYM_ID);
-		scancat(ctx->outStr, ctx->dataStr);
+		gs1_writeStr(&out, CC_SYM_ID);
+		scancat(&out, ctx->dataStr);
 
 		if (cc) {
 
@@ -281,9 +285,9 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 			for (i = 0; i < ctx->numAIs && ctx->aiData[i].aiEntry; i++)
 				lastAIfnc1 = ctx->aiData[i].aiEntry->fnc1;
 			if (lastAIfnc1)
-				strcat(ctx->outStr, "\x1D");
+				gs1_writeChar(&out, '\x1D');
 
-			scancat(ctx->outStr, cc);
+			scancat(&out, cc);
 
 		}
 
@@ -307,20 +311,20 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 		// GS1 DataBar Limited is restricted to low-valued inputs
 		if (ctx->sym == gs1_encoder_sDataBarLimited) {
 			if (atof((char*)primaryStr) > 19999999999999.) {
-				strcpy(ctx->errMsg, "Primary data item value is too large");
+				gs1_setErr(ctx, gs1_encoder_ePRIMARY_VALUE_TOO_LARGE);
 				goto fail;
 			}
 		}
 
-		strcat(ctx->outStr, "]");
-		strncat(ctx->outStr, lookupSymId(ctx), 2);
-		strcat(ctx->outStr, "01");		// Convert to AI (01)
-		scancat(ctx->outStr, primaryStr);
+		gs1_writeChar(&out, ']');
+		gs1_writeN(&out, lookupSymId(ctx), 2);
+		gs1_writeStr(&out, "01");		// Convert to AI (01)
+		scancat(&out, primaryStr);
 
 		if (cc) {
 			if (*cc != '^')
 				goto fail;
-			scancat(ctx->outStr, cc);
+			scancat(&out, cc);
 		}
 
 		break;
@@ -355,15 +359,15 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 		if (!checkAndNormalisePrimaryData(ctx, dataStr, primaryStr, length))
 			goto fail;
 
-		strcat(ctx->outStr, "]");
-		strncat(ctx->outStr, lookupSymId(ctx), 2);
-		strcat(ctx->outStr, pad);
-		scancat(ctx->outStr, primaryStr);
+		gs1_writeChar(&out, ']');
+		gs1_writeN(&out, lookupSymId(ctx), 2);
+		gs1_writeStr(&out, pad);
+		scancat(&out, primaryStr);
 		if (cc) {
 			if (*cc != '^')
 				goto fail;
-			strcat(ctx->outStr, "|" CC_SYM_ID);		// "|" means start of new message
-			scancat(ctx->outStr, cc);
+			gs1_writeStr(&out, "|" CC_SYM_ID);		// "|" means start of new message
+			scancat(&out, cc);
 		}
 		break;
 
@@ -405,19 +409,17 @@ bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
 	*ctx->dataStr = '\0';
 	ctx->numAIs = 0;
 
-	*ctx->errMsg = '\0';
-	ctx->linterErr = GS1_LINTER_OK;
-	*ctx->linterErrMarkup = '\0';
+	gs1_clearErr(ctx);
 
 	if (*scanData != ']' || strlen(scanData) < 3) {
-		strcpy(ctx->errMsg, "Missing symbology identifier");
+		gs1_setErr(ctx, gs1_encoder_eSCAN_MISSING_SYMID);
 		goto fail;
 	}
 
 	lookupSymAndModeBySymId(scanData + 1, &sym, &aiMode);
 
 	if (sym == gs1_encoder_sNONE) {
-		strcpy(ctx->errMsg, "Unsupported symbology identifier");
+		gs1_setErr(ctx, gs1_encoder_eSCAN_UNSUPPORTED_SYMID);
 		goto fail;
 	}
 
@@ -431,7 +433,7 @@ bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
 		const char *cc = NULL;
 
 		if (strlen(scanData) < primaryLen) {
-			strcpy(ctx->errMsg, "Primary scan data is too short");
+			gs1_setErr(ctx, gs1_encoder_eSCAN_PRIMARY_TOO_SHORT);
 			goto fail;
 		}
 
@@ -439,7 +441,7 @@ bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
 		    strncmp(scanData + primaryLen, "|" CC_SYM_ID, sizeof(CC_SYM_ID)) == 0) {
 			cc = scanData + primaryLen + sizeof(CC_SYM_ID);
 		} else if (strlen(scanData) > primaryLen) {
-			strcpy(ctx->errMsg, "Primary message is too long");
+			gs1_setErr(ctx, gs1_encoder_eSCAN_PRIMARY_TOO_LONG);
 			goto fail;
 		}
 
@@ -447,12 +449,12 @@ bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
 		strncat(p, scanData, primaryLen);
 
 		if (!gs1_allDigits((uint8_t*)p, 0)) {
-			strcpy(ctx->errMsg, "Primary message number only contain digits");
+			gs1_setErr(ctx, gs1_encoder_eSCAN_PRIMARY_NOT_DIGITS);
 			goto fail;
 		}
 
 		if (!validateParity((uint8_t*)p)) {
-			strcpy(ctx->errMsg, "Primary message check digit is incorrect");
+			gs1_setErr(ctx, gs1_encoder_eSCAN_PRIMARY_INCORRECT_CD);
 			goto fail;
 		}
 
@@ -474,7 +476,7 @@ bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
 
 		// Forbid data "^" characters at this stage so we don't conflate with FNC1
 		if (strchr(scanData, '^') != NULL) {
-			strcpy(ctx->errMsg, "Scan data contains illegal ^ character");
+			gs1_setErr(ctx, gs1_encoder_eSCAN_ILLEGAL_CARET);
 			goto fail;
 		}
 
@@ -517,8 +519,8 @@ fail:
 
 	*ctx->dataStr = '\0';
 	ctx->sym = gs1_encoder_sNONE;
-	if (*ctx->errMsg == '\0')
-		strcpy(ctx->errMsg, "Failed to process scan data");
+	if (ctx->err.code == gs1_encoder_eNO_ERROR)
+		gs1_setErr(ctx, gs1_encoder_eSCAN_FAILED);
 
 	return false;
 
@@ -686,7 +688,7 @@ static void do_test_testProcessScanData(gs1_encoder* const ctx, const char* cons
 	TEST_CASE(casename);
 
 	TEST_CHECK(gs1_processScanData(ctx, scanData) ^ (!should_succeed));
-	TEST_MSG("Error message: %s", ctx->errMsg);
+	TEST_MSG("Error message: %s", gs1_encoder_getErrMsg(ctx));
 	TEST_CHECK(ctx->sym == expectSym);
 	TEST_MSG("Got: %d; Expected: %d (%s)", ctx->sym, expectSym, expectSymName);
 	TEST_CHECK(strcmp(ctx->dataStr, expectDataStr) == 0);
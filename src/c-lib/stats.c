@@ -0,0 +1,405 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef PERF_STATS
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+#include "syntax/gs1syntaxdictionary.h"
+#include "syntax/gs1syntaxdictionary-utils.h"
+#include "enc-private.h"
+#include "gs1encoders.h"
+#include "stats.h"
+
+
+/*
+ *  Linter invocations are counted by aiLinterId, less the unused id zero
+ *
+ */
+#define AI_LINTER_NAME(n) #n,
+static const char* const linterNames[AI_NUM_LINTERS - 1] = {
+	AI_LINTERS(AI_LINTER_NAME)
+};
+#undef AI_LINTER_NAME
+
+typedef char statsLintersFit[AI_NUM_LINTERS - 1 <= GS1_ENCODER_STATS_MAX_LINTERS ? 1 : -1];
+typedef char statsLintErrsFit[__GS1_LINTER_NUM_ERRS <= GS1_ENCODER_STATS_MAX_LINT_ERRS ? 1 : -1];
+
+
+const char* gs1_statsLinterName(const int index) {
+	if (index < 0 || index >= AI_NUM_LINTERS - 1)
+		return NULL;
+	return linterNames[index];
+}
+
+
+#ifdef PERF_STATS
+
+static uint64_t nowNs(void) {
+#ifdef _WIN32
+	LARGE_INTEGER freq, t;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (uint64_t)(t.QuadPart / freq.QuadPart) * 1000000000u +
+	       (uint64_t)(t.QuadPart % freq.QuadPart) * 1000000000u / (uint64_t)freq.QuadPart;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+#endif
+}
+
+
+/*
+ *  Each phase is charged for the time until the next phase boundary, so that
+ *  time within a nested phase is charged to that phase alone. Time spent in
+ *  the callback is not charged to any phase.
+ *
+ */
+static void notify(gs1_encoder* const ctx, const struct gs1_statsFrame* const f, const bool end, const uint64_t ns) {
+
+	const gs1_encoder_phase_event_t event = {
+		.phase = f->phase,
+		.end = end,
+		.ns = ns,
+		.ai = f->ai,
+		.aiLength = f->ailen,
+	};
+
+	ctx->phaseCallback(ctx, &event, ctx->phaseUserData);
+	ctx->statsMark = nowNs();
+
+}
+
+
+void gs1_statsEnter(gs1_encoder* const ctx, const gs1_encoder_phase_t phase, const char* const ai, const size_t ailen) {
+
+	const uint64_t t = nowNs();
+	struct gs1_statsFrame *f;
+
+	assert(ctx->statsDepth < STATS_MAX_DEPTH);
+
+	if (ctx->statsDepth > 0)
+		ctx->stats.phaseNs[ctx->statsFrames[ctx->statsDepth - 1].phase] += t - ctx->statsMark;
+	ctx->statsMark = t;
+
+	f = &ctx->statsFrames[ctx->statsDepth++];
+	f->phase = phase;
+	f->start = t;
+	f->ai = ai;
+	f->ailen = ailen;
+
+	if (ctx->phaseCallback)
+		notify(ctx, f, false, 0);
+
+}
+
+
+void gs1_statsLeave(gs1_encoder* const ctx) {
+
+	const uint64_t t = nowNs();
+	const struct gs1_statsFrame *f;
+
+	assert(ctx->statsDepth > 0);
+
+	f = &ctx->statsFrames[--ctx->statsDepth];
+	ctx->stats.phaseNs[f->phase] += t - ctx->statsMark;
+	ctx->statsMark = t;
+
+	if (ctx->phaseCallback)
+		notify(ctx, f, true, t - f->start);
+
+}
+
+
+void gs1_statsMessage(gs1_encoder* const ctx, const gs1_encoder_message_entry_t entry, const bool ok) {
+
+	int i;
+
+	ctx->stats.messages[entry]++;
+
+	if (!ok) {
+		ctx->stats.failures[entry]++;
+		return;
+	}
+
+	for (i = 0; i < ctx->numAIs; i++)
+		if (ctx->aiData[i].kind == aiValue_aival)
+			ctx->stats.aisProcessed++;
+
+}
+
+
+void gs1_statsLinterCall(gs1_encoder* const ctx, const int linter) {
+	assert(linter > AI_LINTER_NONE && linter < AI_NUM_LINTERS);
+	ctx->stats.linterCalls[linter - 1]++;
+}
+
+
+/*
+ *  Character set checks that are fused with the length check are counted as
+ *  invocations of the corresponding linter.
+ *
+ */
+void gs1_statsCsetCheck(gs1_encoder* const ctx, const int cset) {
+	switch (cset) {
+		case GS1_CSET_NUMERIC: gs1_statsLinterCall(ctx, AI_LINTER_csetnumeric); break;
+		case GS1_CSET_39:      gs1_statsLinterCall(ctx, AI_LINTER_cset39); break;
+		case GS1_CSET_82:      gs1_statsLinterCall(ctx, AI_LINTER_cset82); break;
+		default: break;
+	}
+}
+
+
+void gs1_statsLintFailure(gs1_encoder* const ctx, const int err) {
+	assert(err > GS1_LINTER_OK && err < __GS1_LINTER_NUM_ERRS);
+	ctx->stats.lintFailures[err]++;
+}
+
+
+void gs1_statsValidationFailure(gs1_encoder* const ctx, const int validation) {
+	assert(validation >= 0 && validation < gs1_encoder_vNUMVALIDATIONS);
+	ctx->stats.validationFailures[validation]++;
+}
+
+#endif  /* PERF_STATS */
+
+
+
+#ifdef UNIT_TESTS
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+
+
+static int linterIndex(const char* const name) {
+
+	int i;
+	const char *n;
+
+	for (i = 0; (n = gs1_encoder_getStatsLinterName(i)) != NULL; i++)
+		if (strcmp(n, name) == 0)
+			return i;
+
+	return -1;
+
+}
+
+
+void test_stats_counters(void) {
+
+	gs1_encoder* ctx;
+	gs1_encoder_stats_t stats;
+	int i;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	TEST_CHECK(gs1_encoder_getStatsLinterName(-1) == NULL);
+	TEST_CHECK(gs1_encoder_getStatsLinterName(AI_NUM_LINTERS - 1) == NULL);
+	TEST_CHECK(linterIndex("couponcode") == 0);
+	TEST_CHECK(linterIndex("csum") >= 0);
+	TEST_CHECK(linterIndex("zero") == AI_NUM_LINTERS - 2);
+
+#ifndef PERF_STATS
+
+	TEST_CHECK(!gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(gs1_encoder_getErrRecord(ctx, NULL) == gs1_encoder_eSTATS_UNAVAILABLE);
+	TEST_CHECK(!gs1_encoder_resetStats(ctx));
+	TEST_CHECK(!gs1_encoder_setPhaseCallback(ctx, NULL, NULL));
+	(void)i;
+
+#else
+
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	for (i = 0; i < gs1_encoder_mNUMENTRIES; i++)
+		TEST_CHECK(stats.messages[i] == 0 && stats.failures[i] == 0);
+	TEST_CHECK(stats.aisProcessed == 0);
+
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12345678901231(10)ABC123"));
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "^0112345678901231"));
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "https://id.gs1.org/01/12345678901231/10/ABC"));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901234"));			// Bad check digit
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)1234567890123A"));			// Non-digit
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901231(02)12345678901231"));	// Mutually exclusive
+	TEST_CHECK(gs1_encoder_setScanData(ctx, "]C1011234567890123110ABC"));
+	TEST_CHECK(!gs1_encoder_setScanData(ctx, "]C1"));
+
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.messages[gs1_encoder_mAI_DATA_STR] == 4);
+	TEST_CHECK(stats.failures[gs1_encoder_mAI_DATA_STR] == 3);
+	TEST_CHECK(stats.messages[gs1_encoder_mDATA_STR] == 2);
+	TEST_CHECK(stats.failures[gs1_encoder_mDATA_STR] == 0);
+	TEST_CHECK(stats.messages[gs1_encoder_mSCAN_DATA] == 2);
+	TEST_CHECK(stats.failures[gs1_encoder_mSCAN_DATA] == 1);
+	TEST_CHECK(stats.aisProcessed == 2 + 1 + 2 + 2);
+	TEST_CHECK(stats.linterCalls[linterIndex("csum")] == 7);
+	TEST_MSG("Got: %d", (int)stats.linterCalls[linterIndex("csum")]);
+	TEST_CHECK(stats.linterCalls[linterIndex("csetnumeric")] == 8);
+	TEST_MSG("Got: %d", (int)stats.linterCalls[linterIndex("csetnumeric")]);
+	TEST_CHECK(stats.linterCalls[linterIndex("cset82")] == 3);
+	TEST_CHECK(stats.lintFailures[GS1_LINTER_INCORRECT_CHECK_DIGIT] == 1);
+	TEST_CHECK(stats.lintFailures[GS1_LINTER_NON_DIGIT_CHARACTER] == 1);
+	TEST_CHECK(stats.validationFailures[gs1_encoder_vMUTEX_AIS] == 1);
+
+	// Errors collected by a validation procedure are counted against it
+	TEST_CHECK(gs1_encoder_setCollectErrors(ctx, true));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(10)ABC(21)XYZ"));				// Requisites of (10) and (21) unmet
+	TEST_CHECK(gs1_encoder_setCollectErrors(ctx, false));
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.validationFailures[gs1_encoder_vREQUISITE_AIS] == 1);
+
+	// Unknown AIs as DL URI data attributes
+	TEST_CHECK(gs1_encoder_setPermitUnknownAIs(ctx, true));
+	TEST_CHECK(!gs1_encoder_setDataStr(ctx, "https://id.gs1.org/01/12345678901231?89=ABC"));
+	TEST_CHECK(gs1_encoder_setPermitUnknownAIs(ctx, false));
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.validationFailures[gs1_encoder_vUNKNOWN_AI_NOT_DL_ATTR] == 1);
+
+	// Cache hits count as messages
+	TEST_CHECK(gs1_encoder_setCacheSize(ctx, 16));
+	TEST_CHECK(gs1_encoder_resetStats(ctx));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12345678901231"));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12345678901231"));
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.messages[gs1_encoder_mAI_DATA_STR] == 2);
+	TEST_CHECK(stats.aisProcessed == 2);
+	TEST_CHECK(stats.linterCalls[linterIndex("csum")] == 1);
+
+	TEST_CHECK(gs1_encoder_resetStats(ctx));
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.messages[gs1_encoder_mAI_DATA_STR] == 0);
+	TEST_CHECK(stats.aisProcessed == 0);
+	for (i = 0; i < gs1_encoder_pNUMPHASES; i++)
+		TEST_CHECK(stats.phaseNs[i] == 0);
+
+#endif
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+#ifdef PERF_STATS
+
+struct phaseTrace {
+	int starts[gs1_encoder_pNUMPHASES];
+	int ends[gs1_encoder_pNUMPHASES];
+	int depth;
+	int maxDepth;
+	char lintedAIs[64];
+	bool mismatched;
+};
+
+static void tracePhase(gs1_encoder* const ctx, const gs1_encoder_phase_event_t* const event, void* const userData) {
+
+	struct phaseTrace* const t = userData;
+
+	(void)ctx;
+
+	if (!event->end) {
+		t->starts[event->phase]++;
+		if (++t->depth > t->maxDepth)
+			t->maxDepth = t->depth;
+		if (event->ns != 0)
+			t->mismatched = true;
+		if (event->phase == gs1_encoder_pLINT) {
+			if (!event->ai || strlen(t->lintedAIs) + event->aiLength + 2 > sizeof(t->lintedAIs))
+				t->mismatched = true;
+			else {
+				strncat(t->lintedAIs, event->ai, event->aiLength);
+				strcat(t->lintedAIs, ",");
+			}
+		} else if (event->ai)
+			t->mismatched = true;
+	} else {
+		t->ends[event->phase]++;
+		t->depth--;
+	}
+
+}
+
+#endif
+
+
+void test_stats_phases(void) {
+
+#ifdef PERF_STATS
+
+	gs1_encoder* ctx;
+	gs1_encoder_stats_t stats;
+	struct phaseTrace trace;
+	char **hri;
+	unsigned long long total = 0;
+	int i;
+
+	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
+	assert(ctx);
+
+	memset(&trace, 0, sizeof(trace));
+	TEST_CHECK(gs1_encoder_setPhaseCallback(ctx, tracePhase, &trace));
+
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12345678901231(10)ABC123"));
+	TEST_CHECK(trace.starts[gs1_encoder_pPARSE] == 1 && trace.ends[gs1_encoder_pPARSE] == 1);
+	TEST_CHECK(trace.starts[gs1_encoder_pLINT] == 2 && trace.ends[gs1_encoder_pLINT] == 2);
+	TEST_CHECK(trace.starts[gs1_encoder_pVALIDATE] == 1 && trace.ends[gs1_encoder_pVALIDATE] == 1);
+	TEST_CHECK(trace.maxDepth == 2);
+	TEST_CHECK(trace.depth == 0);
+	TEST_CHECK(strcmp(trace.lintedAIs, "01,10,") == 0);
+	TEST_MSG("Got: %s", trace.lintedAIs);
+
+	TEST_CHECK(gs1_encoder_getAIdataStr(ctx) != NULL);
+	TEST_CHECK(gs1_encoder_getHRI(ctx, &hri) == 2);
+	TEST_CHECK(gs1_encoder_getDLuri(ctx, NULL) != NULL);
+	TEST_CHECK(gs1_encoder_setSym(ctx, gs1_encoder_sDM));
+	TEST_CHECK(gs1_encoder_getScanData(ctx) != NULL);
+	TEST_CHECK(trace.starts[gs1_encoder_pRENDER] == 4 && trace.ends[gs1_encoder_pRENDER] == 4);
+	TEST_CHECK(trace.depth == 0);
+	TEST_CHECK(!trace.mismatched);
+
+	TEST_CHECK(gs1_encoder_setPhaseCallback(ctx, NULL, NULL));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12345678901231"));
+	TEST_CHECK(trace.starts[gs1_encoder_pPARSE] == 1);
+
+	for (i = 0; i < 100; i++)
+		TEST_CHECK(gs1_encoder_setDataStr(ctx, "https://id.gs1.org/01/12345678901231/10/ABC123?17=201231"));
+
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	for (i = 0; i < gs1_encoder_pNUMPHASES; i++)
+		total += stats.phaseNs[i];
+	TEST_CHECK(total > 0);
+	TEST_CHECK(stats.phaseNs[gs1_encoder_pPARSE] > 0);
+
+	gs1_encoder_free(ctx);
+
+#endif
+
+}
+
+#endif  /* UNIT_TESTS */
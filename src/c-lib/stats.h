@@ -0,0 +1,87 @@
+/**
+ * GS1 Syntax Engine
+ *
+ * @author Copyright (c) 2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gs1encoders.h"
+
+
+const char* gs1_statsLinterName(int index);
+
+
+/*
+ *  Performance counters and phase timing are only compiled in when building
+ *  with PERF_STATS, otherwise the hooks expand to nothing.
+ *
+ */
+#ifdef PERF_STATS
+
+#define STATS_MAX_DEPTH		8	// Deepest nesting of phases
+
+struct gs1_statsFrame {
+	gs1_encoder_phase_t phase;
+	uint64_t start;
+	const char *ai;
+	size_t ailen;
+};
+
+void gs1_statsEnter(gs1_encoder *ctx, gs1_encoder_phase_t phase, const char *ai, size_t ailen);
+void gs1_statsLeave(gs1_encoder *ctx);
+void gs1_statsMessage(gs1_encoder *ctx, gs1_encoder_message_entry_t entry, bool ok);
+void gs1_statsLinterCall(gs1_encoder *ctx, int linter);
+void gs1_statsCsetCheck(gs1_encoder *ctx, int cset);
+void gs1_statsLintFailure(gs1_encoder *ctx, int err);
+void gs1_statsValidationFailure(gs1_encoder *ctx, int validation);
+
+#define STATS_ENTER(ctx, phase, ai, ailen)	gs1_statsEnter(ctx, phase, ai, ailen)
+#define STATS_LEAVE(ctx)			gs1_statsLeave(ctx)
+#define STATS_MESSAGE(ctx, entry, ok)		gs1_statsMessage(ctx, entry, ok)
+#define STATS_LINTER_CALL(ctx, linter)		gs1_statsLinterCall(ctx, linter)
+#define STATS_CSET_CHECK(ctx, cset)		gs1_statsCsetCheck(ctx, cset)
+#define STATS_LINT_FAILURE(ctx, err)		gs1_statsLintFailure(ctx, (int)(err))
+#define STATS_VALIDATION_FAILURE(ctx, v)	gs1_statsValidationFailure(ctx, (int)(v))
+
+#else
+
+#define STATS_ENTER(ctx, phase, ai, ailen)	do {} while (0)
+#define STATS_LEAVE(ctx)			do {} while (0)
+#define STATS_MESSAGE(ctx, entry, ok)		do {} while (0)
+#define STATS_LINTER_CALL(ctx, linter)		do {} while (0)
+#define STATS_CSET_CHECK(ctx, cset)		do {} while (0)
+#define STATS_LINT_FAILURE(ctx, err)		do {} while (0)
+#define STATS_VALIDATION_FAILURE(ctx, v)	do {} while (0)
+
+#endif  /* PERF_STATS */
+
+
+#ifdef UNIT_TESTS
+
+void test_stats_counters(void);
+void test_stats_phases(void);
+
+#endif
+
+
+#endif  /* STATS_H */
@@ -25,9 +25,18 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#define HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "gs1encoders.h"
 #include "enc-private.h"
 #include "syn.h"
+#include "dl.h"
 #include "syntax/gs1syntaxdictionary.h"
 
 
@@ -36,13 +45,67 @@
 #define MAX_SD_ENTRY_LEN 150
 
 
+/*
+ *  Compiled Syntax Dictionary image
+ *
+ *  A flat serialisation of a processed Syntax Dictionary consisting of a
+ *  header (which includes the AI length by prefix table), the AI table
+ *  entries, the sorted list of DL key-qualifier sequences and a pool of
+ *  NUL-terminated strings. Strings are referenced by their offset within the
+ *  pool so the image is position independent: it is mapped read-only and the
+ *  attrs, titles and key-qualifier strings are used in place.
+ *
+ *  Linters are referenced by name and resolved when the image is loaded so
+ *  that an image does not depend upon the layout of a particular build.
+ *
+ *  Fields are in the byte order of the host that compiled the image. This is
+ *  recorded so that an image compiled for a foreign host is rejected.
+ *
+ */
+#define SD_IMAGE_MAGIC		"GS1SDIMG"
+#define SD_IMAGE_VERSION	1
+#define SD_IMAGE_BYTE_ORDER	0x01020304
+
+struct sdImageHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint32_t imageSize;
+	uint32_t numEntries;
+	uint32_t entriesOffset;
+	uint32_t numDLkeyQualifiers;
+	uint32_t dlKeyQualifiersOffset;
+	uint32_t stringsOffset;
+	uint32_t stringsSize;
+	uint8_t aiLengthByPrefix[100];
+};
+
+struct sdImageComponent {
+	uint8_t cset;
+	uint8_t min;
+	uint8_t max;
+	uint8_t opt;
+	uint32_t linters[MAX_LINTERS - 1];	// Offsets of linter names; 0 (empty string) if unused
+};
+
+struct sdImageEntry {
+	char ai[MAX_AI_LEN+1];
+	uint8_t fnc1;
+	uint8_t dlDataAttr;
+	uint8_t reserved;
+	struct sdImageComponent parts[MAX_PARTS];
+	uint32_t attrs;
+	uint32_t title;
+};
+
+
 #define error(...) do {							\
-	snprintf(ctx->errMsg, sizeof(ctx->errMsg), __VA_ARGS__);	\
+	snprintf(sd->errMsg, sizeof(sd->errMsg), __VA_ARGS__);		\
 	goto fail;							\
 } while(0)
 
 
-static int processComponent(gs1_encoder* const ctx, char* const component, struct aiComponent* const part) {
+static int processComponent(gs1_syntax_dictionary* const sd, char* const component, struct aiComponent* const part) {
 
 	const char *token, *p;
 	char *saveptr = NULL;
@@ -114,7 +177,7 @@ static int processComponent(gs1_encoder* const ctx, char* const component, struc
 		if (numlinters >= MAX_LINTERS - 1)
 			error("Number of linters for component exceeds implementation: %s", component);
 
-		if ((part->linters[numlinters] = gs1_linter_from_name(token)) == NULL)
+		if ((part->linters[numlinters] = gs1_lintn_from_name(token)) == NULL)
 			error("Unknown linter '%s'", token);
 
 		numlinters++;
@@ -130,7 +193,7 @@ fail:
 
 }
 
-int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, const struct aiEntry* const sd, struct aiEntry** const entry, const uint16_t cap) {
+int parseSyntaxDictionaryEntry(gs1_syntax_dictionary* const sd, const char* const line, const struct aiEntry* const table, struct aiEntry** const entry, const uint16_t cap) {
 
 	const struct aiEntry *lastEntry;
 	const char *token, *flags = "";
@@ -151,7 +214,7 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 	if (!token || *token == '#')
 		return 0;
 
-	if ((uint16_t)(*entry - sd) >= cap - 1)
+	if ((uint16_t)(*entry - table) >= cap - 1)
 		error("Syntax Dictionary capacity is too small");
 
 	*(*entry)->ai = '\0';
@@ -221,7 +284,7 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 		if (numparts >= MAX_PARTS - 1)
 			error("Number of AI components exceeds implementation");
 
-		if (processComponent(ctx, (char*)token, &(*entry)->parts[numparts]) < 0)
+		if (processComponent(sd, (char*)token, &(*entry)->parts[numparts]) < 0)
 			goto fail;
 
 		numparts++;
@@ -234,7 +297,7 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 	for (part = 0; part < MAX_PARTS; part++) {
 		struct aiComponent* const c = &(*entry)->parts[part];
 		if (part >= numparts) {		// Fillers for parts
-			processComponent(ctx, "_0", c);
+			processComponent(sd, "_0", c);
 			continue;
 		}
 		if (part < numparts-1 && c->min != c->max)
@@ -308,7 +371,7 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 	lastEntry = (*entry)++;
 	while (lastEntry->ai[len-1] != rangeEnd) {
 
-		if ((uint16_t)(*entry - sd) >= cap - 1)
+		if ((uint16_t)(*entry - table) >= cap - 1)
 			error("Syntax Dictionary capacity is too small");
 
 		strcpy((*entry)->ai, lastEntry->ai);
@@ -319,6 +382,7 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 			(*entry)->parts[part].cset = lastEntry->parts[part].cset;
 			(*entry)->parts[part].min  = lastEntry->parts[part].min;
 			(*entry)->parts[part].max  = lastEntry->parts[part].max;
+			(*entry)->parts[part].opt  = lastEntry->parts[part].opt;
 			for (linter = 0; linter < MAX_LINTERS; linter++)
 				(*entry)->parts[part].linters[linter] = lastEntry->parts[part].linters[linter];
 		}
@@ -337,7 +401,7 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 	// Prepare the next entry
 	*(*entry)->ai = '\0';
 
-	return (int16_t)( (*entry) - sd);
+	return (int16_t)( (*entry) - table);
 
 fail:
 	*(*entry)->ai = '\0';
@@ -352,38 +416,38 @@ fail:
 #undef error
 
 
-static struct aiEntry* parseSyntaxDictionaryFile(gs1_encoder* const ctx, const char* const fname) {
+static struct aiEntry* parseSyntaxDictionaryFile(gs1_syntax_dictionary* const sd, const char* const fname) {
 
 	const uint16_t cap = AI_TABLE_CAPACITY;
 	FILE *fp = NULL;
 	char buf[MAX_SD_ENTRY_LEN];
-	char errbuf[sizeof(ctx->errMsg)];
+	char errbuf[sizeof(sd->errMsg)];
 	size_t linenum;
 
-	struct aiEntry *sd;
+	struct aiEntry *table;
 	struct aiEntry *pos;
 
-	sd = (struct aiEntry*)malloc(cap * sizeof(struct aiEntry));
-	if (!sd) {
-		strcpy(ctx->errMsg, "Failed to allocate AI table");
+	table = (struct aiEntry*)malloc(cap * sizeof(struct aiEntry));
+	if (!table) {
+		strcpy(sd->errMsg, "Failed to allocate AI table");
 		goto fail;
 	}
-	sd[0].ai[0] = '\0';
+	table[0].ai[0] = '\0';
 
 	fp = fopen(fname, "r");
 	if (fp == NULL) {
-		snprintf(ctx->errMsg, sizeof(ctx->errMsg), "Cannot read file %s", fname);
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Cannot read file %s", fname);
 		goto fail;
 	}
 
-	pos = sd;
+	pos = table;
 	linenum = 1;
 	while (fgets(buf, sizeof(buf), fp)) {
 		buf[strcspn(buf, "\n")] = 0;		/* Chop newline */
-		if (parseSyntaxDictionaryEntry(ctx, buf, sd, &pos, cap) < 0) {
-			int s = snprintf(errbuf, sizeof(errbuf), "Syntax Dictionary line %d: %s", (int)linenum, ctx->errMsg);
+		if (parseSyntaxDictionaryEntry(sd, buf, table, &pos, cap) < 0) {
+			int s = snprintf(errbuf, sizeof(errbuf), "Syntax Dictionary line %d: %s", (int)linenum, sd->errMsg);
 			if (s < (int)sizeof(errbuf))
-				memcpy(ctx->errMsg, errbuf, sizeof(errbuf));
+				memcpy(sd->errMsg, errbuf, sizeof(errbuf));
 			goto fail;
 		}
 		linenum++;
@@ -391,30 +455,498 @@ static struct aiEntry* parseSyntaxDictionaryFile(gs1_encoder* const ctx, const c
 
 	fclose(fp);
 
-	return sd;
+	return table;
 
 fail:
 	if (fp) fclose(fp);
-	gs1_freeSyntaxDictionaryEntries(ctx, sd);
-	free(sd);
+	if (table) {
+		gs1_freeSyntaxDictionaryEntries(table);
+		free(table);
+	}
 	return NULL;
 
 }
 
 
-bool gs1_loadSyntaxDictionary(gs1_encoder* const ctx, const char *fname) {
+/*
+ *  Make the content of a file available in memory, mapping it read-only
+ *  where possible so that the pages are shared by all processes using the
+ *  same image.
+ *
+ */
+static const uint8_t* mapImage(gs1_syntax_dictionary* const sd, const char* const fname, size_t* const size) {
+
+#ifdef HAVE_MMAP
+
+	int fd;
+	struct stat st;
+	void *image;
+
+	if ((fd = open(fname, O_RDONLY)) < 0) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Cannot read file %s", fname);
+		return NULL;
+	}
+
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Cannot determine size of file %s", fname);
+		close(fd);
+		return NULL;
+	}
+	*size = (size_t)st.st_size;
+
+	image = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (image == MAP_FAILED) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Cannot map file %s", fname);
+		return NULL;
+	}
+
+	return image;
+
+#else
+
+	FILE *fp;
+	long len;
+	uint8_t *image = NULL;
+
+	if ((fp = fopen(fname, "rb")) == NULL) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Cannot read file %s", fname);
+		return NULL;
+	}
+
+	if (fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) <= 0 || fseek(fp, 0, SEEK_SET) != 0) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Cannot determine size of file %s", fname);
+		goto fail;
+	}
+	*size = (size_t)len;
+
+	if ((image = malloc(*size)) == NULL) {
+		strcpy(sd->errMsg, "Failed to allocate memory for image");
+		goto fail;
+	}
+
+	if (fread(image, 1, *size, fp) != *size) {
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Cannot read file %s", fname);
+		goto fail;
+	}
+
+	fclose(fp);
+
+	return image;
+
+fail:
+	free(image);
+	fclose(fp);
+	return NULL;
+
+#endif
+
+}
+
+
+static void unmapImage(const uint8_t* const image, const size_t size) {
+
+#ifdef HAVE_MMAP
+	munmap((void*)image, size);
+#else
+	(void)size;
+	free((void*)image);
+#endif
+
+}
+
+
+static bool isSyntaxDictionaryImage(const char* const fname) {
+
+	FILE *fp;
+	char magic[sizeof(((struct sdImageHeader*)0)->magic)];
+	bool ret;
+
+	if ((fp = fopen(fname, "rb")) == NULL)
+		return false;
+
+	ret = fread(magic, 1, sizeof(magic), fp) == sizeof(magic) &&
+	      memcmp(magic, SD_IMAGE_MAGIC, sizeof(magic)) == 0;
+
+	fclose(fp);
+
+	return ret;
+
+}
+
+
+#define error(...) do {							\
+	snprintf(sd->errMsg, sizeof(sd->errMsg), __VA_ARGS__);		\
+	goto fail;							\
+} while(0)
+
+
+/*
+ *  Populate a dictionary from a compiled image. The image may originate
+ *  from anywhere so everything is bounds checked before it is used.
+ *
+ */
+static bool loadSyntaxDictionaryImage(gs1_syntax_dictionary* const sd, const char* const fname) {
+
+	const struct sdImageHeader *hdr;
+	const struct sdImageEntry *entries;
+	const uint32_t *qualifiers;
+	const char *strings;
+	const uint8_t *image;
+	size_t size = 0;
+	uint32_t i;
+	int part, linter;
+
+	if ((image = mapImage(sd, fname, &size)) == NULL)
+		return false;
+
+	sd->image = image;
+	sd->imageSize = size;
+
+	hdr = (const struct sdImageHeader*)image;
+	if (size < sizeof(struct sdImageHeader) || memcmp(hdr->magic, SD_IMAGE_MAGIC, sizeof(hdr->magic)) != 0)
+		error("Not a compiled Syntax Dictionary image");
+	if (hdr->byteOrder != SD_IMAGE_BYTE_ORDER)
+		error("Image was compiled for a host with a different byte order");
+	if (hdr->version != SD_IMAGE_VERSION)
+		error("Unsupported image version %u", (unsigned int)hdr->version);
+	if (hdr->imageSize != size)
+		error("Image is truncated");
+
+	if (hdr->numEntries == 0 || hdr->numEntries >= AI_TABLE_CAPACITY ||
+	    hdr->entriesOffset % 4 != 0 || hdr->entriesOffset < sizeof(struct sdImageHeader) ||
+	    hdr->entriesOffset > size || (size - hdr->entriesOffset) / sizeof(struct sdImageEntry) < hdr->numEntries)
+		error("Image has a corrupt AI table");
+
+	if (hdr->dlKeyQualifiersOffset % 4 != 0 || hdr->dlKeyQualifiersOffset < sizeof(struct sdImageHeader) ||
+	    hdr->dlKeyQualifiersOffset > size || (size - hdr->dlKeyQualifiersOffset) / sizeof(uint32_t) < hdr->numDLkeyQualifiers)
+		error("Image has a corrupt key-qualifier list");
+
+	if (hdr->stringsSize == 0 || hdr->stringsOffset > size || size - hdr->stringsOffset < hdr->stringsSize ||
+	    image[hdr->stringsOffset + hdr->stringsSize - 1] != '\0')
+		error("Image has a corrupt string pool");
+
+	entries = (const struct sdImageEntry*)(image + hdr->entriesOffset);
+	qualifiers = (const uint32_t*)(image + hdr->dlKeyQualifiersOffset);
+	strings = (const char*)(image + hdr->stringsOffset);
+
+#define string(off) ((off) < hdr->stringsSize ? &strings[off] : NULL)
+
+	/*
+	 *  The AI table entries are rebuilt with native pointers, referencing
+	 *  the strings within the image.
+	 *
+	 */
+	sd->aiTable = malloc((hdr->numEntries + 1) * sizeof(struct aiEntry));
+	if (!sd->aiTable)
+		error("Failed to allocate AI table");
+	sd->aiTableIsDynamic = true;
+
+	for (i = 0; i < hdr->numEntries; i++) {
+
+		const struct sdImageEntry* const in = &entries[i];
+		struct aiEntry* const out = &sd->aiTable[i];
+		const size_t ailen = strnlen(in->ai, sizeof(in->ai));
+
+		if (ailen < MIN_AI_LEN || ailen > MAX_AI_LEN || !gs1_allDigits((const uint8_t*)in->ai, ailen))
+			error("Image has an invalid AI at entry %u", (unsigned int)i);
+		if (i > 0 && strcmp(sd->aiTable[i-1].ai, in->ai) >= 0)
+			error("Image has an unsorted AI table at AI (%s)", in->ai);
+
+		strcpy(out->ai, in->ai);
+		out->fnc1 = in->fnc1 ? DO_FNC1 : NO_FNC1;
+		out->dlDataAttr = in->dlDataAttr;
+
+		if ((out->attrs = (char*)string(in->attrs)) == NULL ||
+		    (out->title = (char*)string(in->title)) == NULL)
+			error("Image has a corrupt string reference for AI (%s)", out->ai);
+
+		for (part = 0; part < MAX_PARTS; part++) {
+
+			const struct sdImageComponent* const c = &in->parts[part];
+
+			if (c->cset > cset_Z || c->min > c->max || c->max > MAX_AI_VALUE_LEN)
+				error("Image has an invalid component for AI (%s)", out->ai);
+
+			/*
+			 *  Components are terminated by a cset_none entry, which
+			 *  the final slot is reserved for, and after which all
+			 *  entries must be empty
+			 *
+			 */
+			if (c->cset != cset_none &&
+			    (part == MAX_PARTS - 1 || (part > 0 && in->parts[part - 1].cset == cset_none)))
+				error("Image has unterminated components for AI (%s)", out->ai);
+
+			out->parts[part].cset = (cset_t)c->cset;
+			out->parts[part].min = c->min;
+			out->parts[part].max = c->max;
+			out->parts[part].opt = c->opt ? OPT : MAN;
+
+			for (linter = 0; linter < MAX_LINTERS - 1; linter++) {
+				const char* const name = string(c->linters[linter]);
+				if (!name)
+					error("Image has a corrupt linter reference for AI (%s)", out->ai);
+				if (!*name) {
+					out->parts[part].linters[linter] = NULL;
+					continue;
+				}
+				if ((out->parts[part].linters[linter] = gs1_lintn_from_name(name)) == NULL)
+					error("Unknown linter '%s' for AI (%s)", name, out->ai);
+			}
+			out->parts[part].linters[MAX_LINTERS - 1] = NULL;
+
+		}
+
+		sd->aiTableEntries++;
+
+	}
+	*sd->aiTable[i].ai = '\0';
+	sd->aiTable[i].attrs = NULL;
+	sd->aiTable[i].title = NULL;
+
+	/*
+	 *  The lengths are derived from the AI table rather than trusted, and
+	 *  an image whose own copy disagrees is corrupt
+	 *
+	 */
+	if (!gs1_populateAIlengthByPrefix(sd))
+		goto fail;
+	if (memcmp(sd->aiLengthByPrefix, hdr->aiLengthByPrefix, sizeof(sd->aiLengthByPrefix)) != 0)
+		error("Image has a corrupt AI length table");
+
+	if (!gs1_populateAIindex(sd))
+		goto fail;
+
+	if (!gs1_compileAIrules(sd))
+		goto fail;
+
+	if (!gs1_compileAIprograms(sd))
+		goto fail;
+
+	sd->dlKeyQualifiers = malloc((hdr->numDLkeyQualifiers + 1) * sizeof(char*));
+	if (!sd->dlKeyQualifiers)
+		error("Failed to allocate memory for key-qualifiers");
+
+	for (i = 0; i < hdr->numDLkeyQualifiers; i++) {
+		if ((sd->dlKeyQualifiers[i] = (char*)string(qualifiers[i])) == NULL)
+			error("Image has a corrupt key-qualifier list");
+		if (i > 0 && strcmp(sd->dlKeyQualifiers[i-1], sd->dlKeyQualifiers[i]) > 0)
+			error("Image has an unsorted key-qualifier list");
+		sd->numDLkeyQualifiers++;
+	}
+
+	if (!gs1_compileDLkeyQualifiers(sd))
+		goto fail;
+
+#undef string
+
+	return true;
+
+fail:
+
+	gs1_freeDLkeyQualifiers(sd);		// The strings belong to the image
+
+	gs1_freeAIprograms(sd);
+	gs1_freeAIrules(sd);
+	gs1_freeAIindex(sd);
+
+	free(sd->aiTable);
+	sd->aiTable = NULL;
+	sd->aiTableEntries = 0;
+	sd->aiTableIsDynamic = false;
+
+	unmapImage(sd->image, sd->imageSize);
+	sd->image = NULL;
+	sd->imageSize = 0;
+
+	return false;
+
+}
+
+
+/*
+ *  Add a string to the image string pool, reusing an identical string if one
+ *  is present
+ *
+ */
+struct stringPool {
+	char *buf;
+	size_t size;
+	size_t cap;
+};
+
+static bool poolString(gs1_syntax_dictionary* const sd, struct stringPool* const pool, const char* const str, uint32_t* const offset) {
+
+	const size_t len = strlen(str);
+	size_t pos;
+
+	for (pos = 0; pos < pool->size; pos += strlen(&pool->buf[pos]) + 1) {
+		if (strcmp(&pool->buf[pos], str) == 0) {
+			*offset = (uint32_t)pos;
+			return true;
+		}
+	}
+
+	if (pool->size + len + 1 > pool->cap) {
+		size_t cap = pool->cap ? pool->cap : 4096;
+		char *buf;
+		while (pool->size + len + 1 > cap)
+			cap *= 2;
+		if ((buf = realloc(pool->buf, cap)) == NULL)
+			error("Failed to allocate memory for string pool");
+		pool->buf = buf;
+		pool->cap = cap;
+	}
+
+	memcpy(&pool->buf[pool->size], str, len + 1);
+	*offset = (uint32_t)pool->size;
+	pool->size += len + 1;
+
+	return true;
+
+fail:
+	return false;
+
+}
+
+
+static bool writeSyntaxDictionaryImage(gs1_syntax_dictionary* const sd, const char* const fname) {
+
+	struct sdImageHeader hdr;
+	struct sdImageEntry *entries = NULL;
+	uint32_t *qualifiers = NULL;
+	struct stringPool pool = { NULL, 0, 0 };
+	FILE *fp = NULL;
+	uint32_t empty;
+	size_t i, total;
+	int part, linter;
+	bool ret = false;
+
+	if (!poolString(sd, &pool, "", &empty))		// Offset 0 is the empty string
+		goto fail;
+
+	entries = calloc(sd->aiTableEntries, sizeof(struct sdImageEntry));
+	qualifiers = calloc((size_t)sd->numDLkeyQualifiers + 1, sizeof(uint32_t));
+	if (!entries || !qualifiers)
+		error("Failed to allocate memory for image");
+
+	for (i = 0; i < sd->aiTableEntries; i++) {
+
+		const struct aiEntry* const in = &sd->aiTable[i];
+		struct sdImageEntry* const out = &entries[i];
+
+		strcpy(out->ai, in->ai);
+		out->fnc1 = (uint8_t)in->fnc1;
+		out->dlDataAttr = in->dlDataAttr;
+
+		for (part = 0; part < MAX_PARTS; part++) {
+
+			const struct aiComponent* const c = &in->parts[part];
+
+			out->parts[part].cset = (uint8_t)c->cset;
+			out->parts[part].min = c->min;
+			out->parts[part].max = c->max;
+			out->parts[part].opt = (uint8_t)c->opt;
+
+			for (linter = 0; linter < MAX_LINTERS - 1 && c->linters[linter]; linter++) {
+				const char* const name = gs1_lintn_name(c->linters[linter]);
+				if (!name)
+					error("Unnamed linter for AI (%s)", in->ai);
+				if (!poolString(sd, &pool, name, &out->parts[part].linters[linter]))
+					goto fail;
+			}
+
+		}
+
+		if (!poolString(sd, &pool, in->attrs, &out->attrs) ||
+		    !poolString(sd, &pool, in->title, &out->title))
+			goto fail;
+
+	}
+
+	for (i = 0; i < (size_t)sd->numDLkeyQualifiers; i++)
+		if (!poolString(sd, &pool, sd->dlKeyQualifiers[i], &qualifiers[i]))
+			goto fail;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, SD_IMAGE_MAGIC, sizeof(hdr.magic));
+	hdr.version = SD_IMAGE_VERSION;
+	hdr.byteOrder = SD_IMAGE_BYTE_ORDER;
+	hdr.numEntries = (uint32_t)sd->aiTableEntries;
+	hdr.entriesOffset = sizeof(hdr);
+	hdr.numDLkeyQualifiers = (uint32_t)sd->numDLkeyQualifiers;
+	hdr.dlKeyQualifiersOffset = hdr.entriesOffset + hdr.numEntries * (uint32_t)sizeof(struct sdImageEntry);
+	hdr.stringsOffset = hdr.dlKeyQualifiersOffset + hdr.numDLkeyQualifiers * (uint32_t)sizeof(uint32_t);
+	hdr.stringsSize = (uint32_t)pool.size;
+	memcpy(hdr.aiLengthByPrefix, sd->aiLengthByPrefix, sizeof(hdr.aiLengthByPrefix));
+
+	total = (size_t)hdr.stringsOffset + pool.size;
+	if (total > UINT32_MAX)
+		error("Image is too large");
+	hdr.imageSize = (uint32_t)total;
+
+	if ((fp = fopen(fname, "wb")) == NULL)
+		error("Cannot write file %s", fname);
+
+	if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1 ||
+	    fwrite(entries, sizeof(struct sdImageEntry), sd->aiTableEntries, fp) != sd->aiTableEntries ||
+	    fwrite(qualifiers, sizeof(uint32_t), (size_t)sd->numDLkeyQualifiers, fp) != (size_t)sd->numDLkeyQualifiers ||
+	    fwrite(pool.buf, 1, pool.size, fp) != pool.size)
+		error("Failed writing file %s", fname);
+
+	if (fclose(fp) != 0) {
+		fp = NULL;
+		error("Failed writing file %s", fname);
+	}
+	fp = NULL;
+
+	ret = true;
+
+fail:
+	if (fp) fclose(fp);
+	free(pool.buf);
+	free(qualifiers);
+	free(entries);
+	return ret;
+
+}
+
+#undef error
+
+
+gs1_syntax_dictionary* gs1_loadSyntaxDictionary(const char *fname) {
 
-	struct aiEntry *sd;
+	gs1_syntax_dictionary *sd;
+	struct aiEntry *table;
 
 	const char* const filename = fname ? fname : DEFAULT_SYNTAX_FILENAME;
 
+	sd = calloc(1, sizeof(gs1_syntax_dictionary));
+	if (!sd)
+		return NULL;
+	sd->refCount = 1;
+
+	/*
+	 *  A compiled image is used directly, otherwise we parse the text
+	 *  format.
+	 *
+	 */
+	if (isSyntaxDictionaryImage(filename)) {
+		if (loadSyntaxDictionaryImage(sd, filename))
+			return sd;
+		printf("\n*** Failed to load compiled Syntax Dictionary: %s\n", filename);
+		printf("*** %s\n", sd->errMsg);
+		table = NULL;
+	}
+
 	/*
 	 * If a name isn't provided then attempt to load the default Syntax Dictionary file.
 	 *
 	 */
-	if ((sd = parseSyntaxDictionaryFile(ctx, filename)) == NULL) {
+	else if ((table = parseSyntaxDictionaryFile(sd, filename)) == NULL) {
 		printf("\n*** Failed to parse Syntax Dictionary file: %s\n", filename);
-		printf("*** %s\n", ctx->errMsg);
+		printf("*** %s\n", sd->errMsg);
 	}
 
 	/*
@@ -422,25 +954,119 @@ bool gs1_loadSyntaxDictionary(gs1_encoder* const ctx, const char *fname) {
 	 *  which will load the embedded AI table.
 	 *
 	 */
-	gs1_setAItable(ctx, sd);
+	gs1_setAItable(sd, table);
 
-	return true;
+	return sd;
 
 }
 
-void gs1_freeSyntaxDictionaryEntries(const gs1_encoder* const ctx, struct aiEntry *sd) {
 
-	(void)ctx;
+/*
+ *  Dictionaries are shared between contexts, possibly operating in different
+ *  threads, so the reference count is maintained atomically. Nothing else
+ *  within the dictionary is modified once it has been built.
+ *
+ */
+gs1_syntax_dictionary* gs1_retainSyntaxDictionary(gs1_syntax_dictionary* const sd) {
 
 	assert(sd);
+	assert(sd->refCount > 0);
+
+	ATOMIC_INCREMENT(&sd->refCount);
+
+	return sd;
+
+}
+
+
+void gs1_releaseSyntaxDictionary(gs1_syntax_dictionary* const sd) {
+
+	if (!sd)
+		return;
+
+	assert(sd->refCount > 0);
+
+	if (ATOMIC_DECREMENT(&sd->refCount) != 0)
+		return;
+
+	if (sd->aiTable && sd->aiTableIsDynamic) {
+		if (!sd->image)		// Otherwise the strings belong to the image
+			gs1_freeSyntaxDictionaryEntries(sd->aiTable);
+		free(sd->aiTable);
+	}
+
+	gs1_freeAIprograms(sd);
+	gs1_freeAIrules(sd);
+	gs1_freeAIindex(sd);
+	gs1_freeDLkeyQualifiers(sd);
+
+	if (sd->image)
+		unmapImage(sd->image, sd->imageSize);
+
+	free(sd);
+
+}
+
+
+/*
+ *  Compile a Syntax Dictionary into an image that can later be loaded by
+ *  gs1_loadSyntaxDictionary.
+ *
+ *  Unlike loading, there is no fallback to the embedded AI table when the
+ *  Syntax Dictionary cannot be processed.
+ *
+ */
+bool gs1_compileSyntaxDictionary(const char *infile, const char* const outfile) {
+
+	gs1_syntax_dictionary *sd;
+	struct aiEntry *table;
+	bool ret = false;
 
-	while (*sd->ai) {
-		*sd->ai = '\0';
-		free(sd->attrs);
-		sd->attrs = NULL;
-		free(sd->title);
-		sd->title = NULL;
-		sd++;
+	assert(outfile);
+
+	if (!infile)
+		infile = DEFAULT_SYNTAX_FILENAME;
+
+	sd = calloc(1, sizeof(gs1_syntax_dictionary));
+	if (!sd)
+		return false;
+	sd->refCount = 1;
+
+	if ((table = parseSyntaxDictionaryFile(sd, infile)) == NULL)
+		goto out;
+
+	gs1_setAItable(sd, table);
+	if (!sd->aiTableIsDynamic) {		// Replaced by the embedded AI table
+		snprintf(sd->errMsg, sizeof(sd->errMsg), "Failed to process the AI table from %s", infile);
+		goto out;
+	}
+
+	ret = writeSyntaxDictionaryImage(sd, outfile);
+
+out:
+	if (!ret) {
+		printf("\n*** Failed to compile Syntax Dictionary file: %s\n", infile);
+		printf("*** %s\n", sd->errMsg);
+	}
+
+	gs1_releaseSyntaxDictionary(sd);
+
+	return ret;
+
+}
+
+
+void gs1_freeSyntaxDictionaryEntries(struct aiEntry *table) {
+
+	assert(table);
+
+	while (*table->ai) {
+		*table->ai = '\0';
+		free(table->attrs);
+		table->attrs = NULL;
+		free(table->title);
+		table->title = NULL;
+		table++;
 	}
 
 }
@@ -451,7 +1077,7 @@ void gs1_freeSyntaxDictionaryEntries(const gs1_encoder* const ctx, struct aiEntr
 #define TEST_NO_MAIN
 #include "acutest.h"
 
-static void test_parseSyntaxDictionaryEntry(gs1_encoder* const ctx, char* const sdEntry, const struct aiEntry expectedAIentries[], bool expectSuccess) {
+static void test_parseSyntaxDictionaryEntry(gs1_syntax_dictionary* const sd, char* const sdEntry, const struct aiEntry expectedAIentries[], bool expectSuccess) {
 
 	const uint16_t cap = 600;
 	int16_t numOut, expectOut = 0;
@@ -468,7 +1094,7 @@ static void test_parseSyntaxDictionaryEntry(gs1_encoder* const ctx, char* const
 	tmp = out;
 	strcpy(buf, sdEntry);
 
-	numOut = (int16_t)parseSyntaxDictionaryEntry(ctx, buf, out, &tmp, cap);
+	numOut = (int16_t)parseSyntaxDictionaryEntry(sd, buf, out, &tmp, cap);
 
 	if (!expectSuccess) {
 		TEST_CHECK(numOut == -1);
@@ -477,7 +1103,7 @@ static void test_parseSyntaxDictionaryEntry(gs1_encoder* const ctx, char* const
 	}
 
 	TEST_CHECK(numOut >= 0);
-	TEST_MSG("Expected success. Got error: %s", ctx->errMsg);
+	TEST_MSG("Expected success. Got error: %s", sd->errMsg);
 	if (numOut == -1)
 		goto out;
 
@@ -508,7 +1134,7 @@ static void test_parseSyntaxDictionaryEntry(gs1_encoder* const ctx, char* const
 	}
 
 out:
-	gs1_freeSyntaxDictionaryEntries(ctx, out);
+	gs1_freeSyntaxDictionaryEntries(out);
 	free(out);
 
 }
@@ -589,14 +1215,156 @@ void test_syn_parseSyntaxDictionaryEntry(void) {
 
 	size_t i;
 
-	gs1_encoder* ctx;
-	TEST_ASSERT((ctx = gs1_encoder_init(NULL)) != NULL);
-	assert(ctx);
+	gs1_syntax_dictionary sd = { 0 };
 
 	for (i = 0; i < SIZEOF_ARRAY(tests_parse_sd_entry); i++)
-		test_parseSyntaxDictionaryEntry(ctx, tests_parse_sd_entry[i].sdEntry, tests_parse_sd_entry[i].aiEntries, tests_parse_sd_entry[i].expectSuccess);
+		test_parseSyntaxDictionaryEntry(&sd, tests_parse_sd_entry[i].sdEntry, tests_parse_sd_entry[i].aiEntries, tests_parse_sd_entry[i].expectSuccess);
+
+}
+
+
+/*
+ *  Write out an image that has been corrupted and check that it is rejected
+ *  in favour of the embedded AI table
+ *
+ */
+static void test_rejectImage(const char* const imageFile, const uint8_t* const buf, const size_t len) {
+
+	gs1_syntax_dictionary *sd;
+	FILE *fp;
+
+	TEST_ASSERT((fp = fopen(imageFile, "wb")) != NULL);
+	assert(fp);
+	TEST_CHECK(fwrite(buf, 1, len, fp) == len);
+	fclose(fp);
+
+	TEST_ASSERT((sd = gs1_loadSyntaxDictionary(imageFile)) != NULL);
+	assert(sd);
+	TEST_CHECK(sd->image == NULL);
+	TEST_CHECK(!sd->aiTableIsDynamic);
+	gs1_releaseSyntaxDictionary(sd);
+
+}
+
+
+void test_syn_compileSyntaxDictionary(void) {
+
+	const char* const imageFile = "gs1-syntax-dictionary-test.bin";
+
+	gs1_syntax_dictionary *text, *image;
+	const struct sdImageHeader *hdr;
+	size_t i, j, k, len, off, entry;
+	uint8_t buf[4096], *full, orig;
+	FILE *fp;
+
+	TEST_ASSERT(gs1_compileSyntaxDictionary(NULL, imageFile));
+
+	TEST_ASSERT((text = gs1_loadSyntaxDictionary(NULL)) != NULL);
+	assert(text);
+	TEST_ASSERT((image = gs1_loadSyntaxDictionary(imageFile)) != NULL);
+	assert(image);
+
+	TEST_CHECK(text->image == NULL);
+	TEST_CHECK(image->image != NULL);
+
+	/*
+	 *  The dictionary loaded from the image must be identical to the one
+	 *  parsed from the text format
+	 *
+	 */
+	TEST_ASSERT(image->aiTableEntries == text->aiTableEntries);
+	for (i = 0; i < text->aiTableEntries; i++) {
+		const struct aiEntry* const a = &text->aiTable[i];
+		const struct aiEntry* const b = &image->aiTable[i];
+		TEST_CASE(a->ai);
+		TEST_CHECK(strcmp(a->ai, b->ai) == 0);
+		TEST_CHECK(a->fnc1 == b->fnc1);
+		TEST_CHECK(a->dlDataAttr == b->dlDataAttr);
+		for (j = 0; j < MAX_PARTS; j++) {
+			TEST_CHECK(a->parts[j].cset == b->parts[j].cset);
+			TEST_CHECK(a->parts[j].min == b->parts[j].min);
+			TEST_CHECK(a->parts[j].max == b->parts[j].max);
+			TEST_CHECK(a->parts[j].opt == b->parts[j].opt);
+			for (k = 0; k < MAX_LINTERS; k++)
+				TEST_CHECK(a->parts[j].linters[k] == b->parts[j].linters[k]);
+		}
+		TEST_CHECK(strcmp(a->attrs, b->attrs) == 0);
+		TEST_CHECK(strcmp(a->title, b->title) == 0);
+	}
+	TEST_CHECK(*image->aiTable[i].ai == '\0');
+
+	TEST_CHECK(memcmp(text->aiLengthByPrefix, image->aiLengthByPrefix, sizeof(text->aiLengthByPrefix)) == 0);
+
+	TEST_ASSERT(image->numDLkeyQualifiers == text->numDLkeyQualifiers);
+	for (i = 0; i < (size_t)text->numDLkeyQualifiers; i++)
+		TEST_CHECK(strcmp(text->dlKeyQualifiers[i], image->dlKeyQualifiers[i]) == 0);
+	TEST_CHECK(text->dlTrie != NULL);
+	TEST_CHECK(image->dlTrie != NULL);
+
+	gs1_releaseSyntaxDictionary(image);
+	gs1_releaseSyntaxDictionary(text);
+
+	/*
+	 *  Images with fields that are individually in range but that are
+	 *  inconsistent are rejected
+	 *
+	 */
+	TEST_ASSERT((fp = fopen(imageFile, "rb")) != NULL);
+	assert(fp);
+	TEST_ASSERT(fseek(fp, 0, SEEK_END) == 0);
+	len = (size_t)ftell(fp);
+	TEST_ASSERT(fseek(fp, 0, SEEK_SET) == 0);
+	TEST_ASSERT((full = malloc(len)) != NULL);
+	assert(full);
+	TEST_ASSERT(fread(full, 1, len, fp) == len);
+	fclose(fp);
+	hdr = (const struct sdImageHeader*)full;
+
+	// AIs beginning "01" are not three digits long
+	off = offsetof(struct sdImageHeader, aiLengthByPrefix) + 1;
+	orig = full[off];
+	full[off] = 3;
+	test_rejectImage(imageFile, full, len);
+	full[off] = orig;
+
+	/*
+	 *  Components of the first AI, which has just one, that are not
+	 *  terminated, including by the reserved final slot
+	 *
+	 */
+	entry = hdr->entriesOffset + offsetof(struct sdImageEntry, parts) + offsetof(struct sdImageComponent, cset);
+	for (j = 2; j < MAX_PARTS; j++) {
+		off = entry + j * sizeof(struct sdImageComponent);
+		full[off] = cset_N;
+		test_rejectImage(imageFile, full, len);			// Component j follows the terminator
+		full[off] = cset_none;
+	}
+	for (j = 0; j < MAX_PARTS; j++)
+		full[entry + j * sizeof(struct sdImageComponent)] = cset_N;
+	test_rejectImage(imageFile, full, len);				// No terminator at all
+
+	free(full);
+
+	/*
+	 *  A truncated image is rejected in favour of the embedded AI table
+	 *
+	 */
+	TEST_ASSERT((fp = fopen(imageFile, "rb")) != NULL);
+	assert(fp);
+	len = fread(buf, 1, sizeof(buf), fp);
+	fclose(fp);
+	TEST_ASSERT((fp = fopen(imageFile, "wb")) != NULL);
+	assert(fp);
+	TEST_CHECK(fwrite(buf, 1, len / 2, fp) == len / 2);
+	fclose(fp);
+
+	TEST_ASSERT((image = gs1_loadSyntaxDictionary(imageFile)) != NULL);
+	assert(image);
+	TEST_CHECK(image->image == NULL);
+	TEST_CHECK(!image->aiTableIsDynamic);
+	gs1_releaseSyntaxDictionary(image);
 
-	gs1_encoder_free(ctx);
+	remove(imageFile);
 
 }
 
@@ -30,16 +30,20 @@
 struct aiEntry;
 
 
-bool gs1_loadSyntaxDictionary(gs1_encoder *ctx, const char *fname);
-void gs1_freeSyntaxDictionaryEntries(const gs1_encoder *ctx, struct aiEntry *sd);
+gs1_syntax_dictionary* gs1_loadSyntaxDictionary(const char *fname);
+gs1_syntax_dictionary* gs1_retainSyntaxDictionary(gs1_syntax_dictionary *sd);
+void gs1_releaseSyntaxDictionary(gs1_syntax_dictionary *sd);
+bool gs1_compileSyntaxDictionary(const char *infile, const char *outfile);
+void gs1_freeSyntaxDictionaryEntries(struct aiEntry *table);
 
 // Exposed for fuzzing
-int parseSyntaxDictionaryEntry(gs1_encoder *ctx, const char* line, const struct aiEntry *sd, struct aiEntry **entry, uint16_t cap);
+int parseSyntaxDictionaryEntry(gs1_syntax_dictionary *sd, const char* line, const struct aiEntry *table, struct aiEntry **entry, uint16_t cap);
 
 
 #ifdef UNIT_TESTS
 
 void test_syn_parseSyntaxDictionaryEntry(void);
+void test_syn_compileSyntaxDictionary(void);
 
 #endif
 
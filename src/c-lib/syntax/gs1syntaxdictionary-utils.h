@@ -0,0 +1,207 @@
+/**
+ * GS1 Syntax Dictionary
+ *
+ * @author Copyright (c) 2022-2024 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef GS1_SYNTAXDICTIONARY_UTILS_H
+#define GS1_SYNTAXDICTIONARY_UTILS_H
+
+#include <stddef.h>
+#include <string.h>
+
+
+/*
+ * Length-bounded counterpart to strspn() since the data given to a linter is
+ * not necessarily null-terminated.
+ *
+ */
+static inline size_t gs1_strnspn(const char* const s, const size_t len, const char* const accept)
+{
+	size_t i = 0;
+
+	while (i < len && s[i] != '\0' && strchr(accept, s[i]))
+		i++;
+
+	return i;
+}
+
+
+/*
+ * Character set classes for gs1_cset_span(). A character may belong to
+ * several classes.
+ *
+ */
+#define GS1_CSET_NUMERIC	0x01
+#define GS1_CSET_39		0x02
+#define GS1_CSET_64		0x04
+#define GS1_CSET_82		0x08
+#define GS1_CSET_32		0x10
+
+
+/*
+ * Bitmap of the character set classes to which a character belongs, by table
+ * lookup rather than by searching a string of the set's members.
+ *
+ */
+static inline unsigned char gs1_cset_class(const char c)
+{
+	static const unsigned char classes[256] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	/* 0x00 */
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	/* 0x10 */
+		0x00, 0x08, 0x08, 0x02, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0e, 0x08, 0x0a,	/* 0x20 */
+		0x0f, 0x0f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,	/* 0x30 */
+		0x00, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x0e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x0e,	/* 0x40 */
+		0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x0c,	/* 0x50 */
+		0x00, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c,	/* 0x60 */
+		0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00,	/* 0x70 */
+		/* 0x80 - 0xff are in no class */
+	};
+
+	return classes[(unsigned char)c];
+}
+
+
+/*
+ * Where available, whole 16-byte blocks are first classified with vector
+ * range comparisons. SSE2 is part of the x86-64 baseline and NEON of AArch64,
+ * so neither requires runtime detection.
+ *
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+#define GS1_CSET_SIMD
+
+typedef __m128i gs1_cset_vec_t;
+
+/*
+ * Lanes of v that lie within [lo, hi], tested as (v - lo) <= (hi - lo)
+ * unsigned.
+ *
+ */
+static inline __m128i gs1_cset_range(const __m128i v, const char lo, const char hi)
+{
+	const __m128i d = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+	return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8((char)(hi - lo))), d);
+}
+
+#define GS1_CSET_LOAD(s) _mm_loadu_si128((const __m128i *)(const void *)(s))
+#define GS1_CSET_OR(a, b) _mm_or_si128(a, b)
+#define GS1_CSET_ALL(m) (_mm_movemask_epi8(m) == 0xFFFF)
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#define GS1_CSET_SIMD
+
+typedef uint8x16_t gs1_cset_vec_t;
+
+static inline uint8x16_t gs1_cset_range(const uint8x16_t v, const char lo, const char hi)
+{
+	const uint8x16_t d = vsubq_u8(v, vdupq_n_u8((uint8_t)lo));
+	return vcleq_u8(d, vdupq_n_u8((uint8_t)(hi - lo)));
+}
+
+#define GS1_CSET_LOAD(s) vld1q_u8((const uint8_t *)(s))
+#define GS1_CSET_OR(a, b) vorrq_u8(a, b)
+#define GS1_CSET_ALL(m) (vminvq_u8(m) == 0xFF)
+
+#endif
+
+
+#ifdef GS1_CSET_SIMD
+
+/*
+ * Whether all 16 characters starting at s are within the character set class.
+ *
+ */
+static inline int gs1_cset_block(const char* const s, const unsigned char cset)
+{
+	const gs1_cset_vec_t v = GS1_CSET_LOAD(s);
+	gs1_cset_vec_t m;
+
+	switch (cset) {
+	case GS1_CSET_NUMERIC:
+		m = gs1_cset_range(v, '0', '9');
+		break;
+	case GS1_CSET_39:
+		m = GS1_CSET_OR(GS1_CSET_OR(gs1_cset_range(v, '#', '#'),
+					    gs1_cset_range(v, '-', '-')),
+				GS1_CSET_OR(gs1_cset_range(v, '/', '9'),
+					    gs1_cset_range(v, 'A', 'Z')));
+		break;
+	case GS1_CSET_64:
+		m = GS1_CSET_OR(GS1_CSET_OR(gs1_cset_range(v, '-', '-'),
+					    gs1_cset_range(v, '0', '9')),
+				GS1_CSET_OR(GS1_CSET_OR(gs1_cset_range(v, 'A', 'Z'),
+							gs1_cset_range(v, '_', '_')),
+					    gs1_cset_range(v, 'a', 'z')));
+		break;
+	case GS1_CSET_82:
+		m = GS1_CSET_OR(GS1_CSET_OR(gs1_cset_range(v, '!', '"'),
+					    gs1_cset_range(v, '%', '?')),
+				GS1_CSET_OR(GS1_CSET_OR(gs1_cset_range(v, 'A', 'Z'),
+							gs1_cset_range(v, '_', '_')),
+					    gs1_cset_range(v, 'a', 'z')));
+		break;
+	default:
+		return 0;	/* No vector kernel; classify bytewise */
+	}
+
+	return GS1_CSET_ALL(m);
+
+}
+
+#endif  /* GS1_CSET_SIMD */
+
+
+/*
+ * Length of the initial segment of s, up to len characters, that consists of
+ * characters in the given character set class. Any vector kernel only skips
+ * whole blocks that match, so the exact position of the first non-matching
+ * character is always found bytewise.
+ *
+ */
+static inline size_t gs1_cset_span(const char* const s, const size_t len, const unsigned char cset)
+{
+	size_t i = 0;
+
+#ifdef GS1_CSET_SIMD
+	while (len - i >= 16 && gs1_cset_block(s + i, cset))
+		i += 16;
+#endif
+
+	while (i < len && (gs1_cset_class(s[i]) & cset))
+		i++;
+
+	return i;
+}
+
+
+/*
+ * Custom lookup hooks are given a null-terminated copy of the data, which for
+ * an AI component is at most 90 characters.
+ *
+ */
+#define GS1_LINTER_CUSTOM_LOOKUP_BUF_SIZE 91
+
+
+#endif  /* GS1_SYNTAXDICTIONARY_UTILS_H */
@@ -24,49 +24,50 @@
 struct name_function_s {
 	char *name;
 	gs1_linter_t fn;
+	gs1_lintn_t fnn;
 };
 
 const struct name_function_s name_function_map[] = {
-	{ .name = "couponcode",		.fn = gs1_lint_couponcode },
-	{ .name = "couponposoffer",	.fn = gs1_lint_couponposoffer },
-	{ .name = "cset39",		.fn = gs1_lint_cset39 },
-	{ .name = "cset64",		.fn = gs1_lint_cset64 },
-	{ .name = "cset82",		.fn = gs1_lint_cset82 },
-	{ .name = "csetnumeric",	.fn = gs1_lint_csetnumeric },
-	{ .name = "csum",		.fn = gs1_lint_csum },
-	{ .name = "csumalpha",		.fn = gs1_lint_csumalpha },
-	{ .name = "hasnondigit",	.fn = gs1_lint_hasnondigit },
-	{ .name = "hh",			.fn = gs1_lint_hh },
-	{ .name = "hhmm",		.fn = gs1_lint_hhmm },
-	{ .name = "hyphen",		.fn = gs1_lint_hyphen },
-	{ .name = "iban",		.fn = gs1_lint_iban },
-	{ .name = "importeridx",	.fn = gs1_lint_importeridx },
-	{ .name = "iso3166",		.fn = gs1_lint_iso3166 },
-	{ .name = "iso3166999",		.fn = gs1_lint_iso3166999 },
-	{ .name = "iso3166alpha2",	.fn = gs1_lint_iso3166alpha2 },
-	{ .name = "iso3166list",	.fn = gs1_lint_iso3166list },
-	{ .name = "iso4217",		.fn = gs1_lint_iso4217 },
-	{ .name = "iso5218",		.fn = gs1_lint_iso5218 },
-	{ .name = "key",		.fn = gs1_lint_key },
-	{ .name = "latitude",		.fn = gs1_lint_latitude },
-	{ .name = "longitude",		.fn = gs1_lint_longitude },
-	{ .name = "mediatype",		.fn = gs1_lint_mediatype },
-	{ .name = "mm",			.fn = gs1_lint_mm },
-	{ .name = "mmoptss",		.fn = gs1_lint_mmoptss },
-	{ .name = "nonzero",		.fn = gs1_lint_nonzero },
-	{ .name = "nozeroprefix",	.fn = gs1_lint_nozeroprefix },
-	{ .name = "pcenc",		.fn = gs1_lint_pcenc },
-	{ .name = "pieceoftotal",	.fn = gs1_lint_pieceoftotal },
-	{ .name = "posinseqslash",	.fn = gs1_lint_posinseqslash },
-	{ .name = "ss",			.fn = gs1_lint_ss },
-	{ .name = "winding",		.fn = gs1_lint_winding },
-	{ .name = "yesno",		.fn = gs1_lint_yesno },
-	{ .name = "yymmd0",		.fn = gs1_lint_yymmd0 },
-	{ .name = "yymmdd",		.fn = gs1_lint_yymmdd },
-	{ .name = "yymmddhh",		.fn = gs1_lint_yymmddhh },
-	{ .name = "yyyymmd0",		.fn = gs1_lint_yyyymmd0 },
-	{ .name = "yyyymmdd",		.fn = gs1_lint_yyyymmdd },
-	{ .name = "zero",		.fn = gs1_lint_zero },
+	{ .name = "couponcode",		.fn = gs1_lint_couponcode,	.fnn = gs1_lintn_couponcode },
+	{ .name = "couponposoffer",	.fn = gs1_lint_couponposoffer,	.fnn = gs1_lintn_couponposoffer },
+	{ .name = "cset39",		.fn = gs1_lint_cset39,		.fnn = gs1_lintn_cset39 },
+	{ .name = "cset64",		.fn = gs1_lint_cset64,		.fnn = gs1_lintn_cset64 },
+	{ .name = "cset82",		.fn = gs1_lint_cset82,		.fnn = gs1_lintn_cset82 },
+	{ .name = "csetnumeric",	.fn = gs1_lint_csetnumeric,	.fnn = gs1_lintn_csetnumeric },
+	{ .name = "csum",		.fn = gs1_lint_csum,		.fnn = gs1_lintn_csum },
+	{ .name = "csumalpha",		.fn = gs1_lint_csumalpha,	.fnn = gs1_lintn_csumalpha },
+	{ .name = "hasnondigit",	.fn = gs1_lint_hasnondigit,	.fnn = gs1_lintn_hasnondigit },
+	{ .name = "hh",			.fn = gs1_lint_hh,		.fnn = gs1_lintn_hh },
+	{ .name = "hhmm",		.fn = gs1_lint_hhmm,		.fnn = gs1_lintn_hhmm },
+	{ .name = "hyphen",		.fn = gs1_lint_hyphen,		.fnn = gs1_lintn_hyphen },
+	{ .name = "iban",		.fn = gs1_lint_iban,		.fnn = gs1_lintn_iban },
+	{ .name = "importeridx",	.fn = gs1_lint_importeridx,	.fnn = gs1_lintn_importeridx },
+	{ .name = "iso3166",		.fn = gs1_lint_iso3166,		.fnn = gs1_lintn_iso3166 },
+	{ .name = "iso3166999",		.fn = gs1_lint_iso3166999,	.fnn = gs1_lintn_iso3166999 },
+	{ .name = "iso3166alpha2",	.fn = gs1_lint_iso3166alpha2,	.fnn = gs1_lintn_iso3166alpha2 },
+	{ .name = "iso3166list",	.fn = gs1_lint_iso3166list,	.fnn = gs1_lintn_iso3166list },
+	{ .name = "iso4217",		.fn = gs1_lint_iso4217,		.fnn = gs1_lintn_iso4217 },
+	{ .name = "iso5218",		.fn = gs1_lint_iso5218,		.fnn = gs1_lintn_iso5218 },
+	{ .name = "key",		.fn = gs1_lint_key,		.fnn = gs1_lintn_key },
+	{ .name = "latitude",		.fn = gs1_lint_latitude,	.fnn = gs1_lintn_latitude },
+	{ .name = "longitude",		.fn = gs1_lint_longitude,	.fnn = gs1_lintn_longitude },
+	{ .name = "mediatype",		.fn = gs1_lint_mediatype,	.fnn = gs1_lintn_mediatype },
+	{ .name = "mm",			.fn = gs1_lint_mm,		.fnn = gs1_lintn_mm },
+	{ .name = "mmoptss",		.fn = gs1_lint_mmoptss,		.fnn = gs1_lintn_mmoptss },
+	{ .name = "nonzero",		.fn = gs1_lint_nonzero,		.fnn = gs1_lintn_nonzero },
+	{ .name = "nozeroprefix",	.fn = gs1_lint_nozeroprefix,	.fnn = gs1_lintn_nozeroprefix },
+	{ .name = "pcenc",		.fn = gs1_lint_pcenc,		.fnn = gs1_lintn_pcenc },
+	{ .name = "pieceoftotal",	.fn = gs1_lint_pieceoftotal,	.fnn = gs1_lintn_pieceoftotal },
+	{ .name = "posinseqslash",	.fn = gs1_lint_posinseqslash,	.fnn = gs1_lintn_posinseqslash },
+	{ .name = "ss",			.fn = gs1_lint_ss,		.fnn = gs1_lintn_ss },
+	{ .name = "winding",		.fn = gs1_lint_winding,		.fnn = gs1_lintn_winding },
+	{ .name = "yesno",		.fn = gs1_lint_yesno,		.fnn = gs1_lintn_yesno },
+	{ .name = "yymmd0",		.fn = gs1_lint_yymmd0,		.fnn = gs1_lintn_yymmd0 },
+	{ .name = "yymmdd",		.fn = gs1_lint_yymmdd,		.fnn = gs1_lintn_yymmdd },
+	{ .name = "yymmddhh",		.fn = gs1_lint_yymmddhh,	.fnn = gs1_lintn_yymmddhh },
+	{ .name = "yyyymmd0",		.fn = gs1_lint_yyyymmd0,	.fnn = gs1_lintn_yyyymmd0 },
+	{ .name = "yyyymmdd",		.fn = gs1_lint_yyyymmdd,	.fnn = gs1_lintn_yyyymmdd },
+	{ .name = "zero",		.fn = gs1_lint_zero,		.fnn = gs1_lintn_zero },
 };
 
 
@@ -98,6 +99,68 @@ gs1_linter_t gs1_linter_from_name(const char* const name) {
 }
 
 
+/*
+ * Return the name of a linter function, the reverse of gs1_linter_from_name.
+ *
+ */
+const char* gs1_linter_name(const gs1_linter_t linter) {
+
+	size_t i;
+
+	for (i = 0; i < sizeof(name_function_map) / sizeof(name_function_map[0]); i++)
+		if (name_function_map[i].fn == linter)
+			return name_function_map[i].name;
+
+	return NULL;
+
+}
+
+
+/*
+ * Return the length-aware linter function corresponding to a linter name.
+ *
+ */
+gs1_lintn_t gs1_lintn_from_name(const char* const name) {
+
+	size_t s = 0, e = sizeof(name_function_map) / sizeof(name_function_map[0]);
+
+	while (s < e) {
+
+		const size_t m = s + (e - s) / 2;
+		const int cmp = strcmp(name_function_map[m].name, name);
+
+		if (cmp == 0)
+			return name_function_map[m].fnn;
+		if (cmp < 0)
+			s = m + 1;
+		else
+			e = m;
+
+	}
+
+	return NULL;
+
+}
+
+
+/*
+ * Return the name of a length-aware linter function, the reverse of
+ * gs1_lintn_from_name.
+ *
+ */
+const char* gs1_lintn_name(const gs1_lintn_t linter) {
+
+	size_t i;
+
+	for (i = 0; i < sizeof(name_function_map) / sizeof(name_function_map[0]); i++)
+		if (name_function_map[i].fnn == linter)
+			return name_function_map[i].name;
+
+	return NULL;
+
+}
+
+
 /*
  * Example mapping of gs1_lint_err_t entries to friendly strings in the English
  * language.
@@ -254,6 +317,9 @@ void test_gs1_linter_from_name(void)
 {
 	TEST_CHECK(gs1_linter_from_name("key") == gs1_lint_key);
 	TEST_CHECK(gs1_linter_from_name("dummy") == NULL);
+	TEST_CHECK(gs1_lintn_from_name("key") == gs1_lintn_key);
+	TEST_CHECK(gs1_lintn_from_name("dummy") == NULL);
+	TEST_CHECK(strcmp(gs1_lintn_name(gs1_lintn_key), "key") == 0);
 }
 
 #endif  /* UNIT_TESTS */
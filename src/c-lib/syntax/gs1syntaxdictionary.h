@@ -218,6 +218,18 @@ GS1_SYNTAX_DICTIONARY_API extern const char *gs1_lint_err_str[];
 typedef gs1_lint_err_t (*gs1_linter_t)(const char *data, size_t *err_pos, size_t *err_len);
 
 
+/**
+ * @brief Type specification for the length-aware variants of the linter
+ * functions.
+ *
+ * These validate exactly `data_len` bytes starting at `data`, which need not be
+ * null-terminated, so an AI component can be linted in place within a larger
+ * buffer.
+ *
+ */
+typedef gs1_lint_err_t (*gs1_lintn_t)(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -263,7 +275,51 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_yyyymmd0(const char *data, siz
 GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_yyyymmdd(const char *data, size_t *err_pos, size_t *err_len);
 GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_zero(const char *data, size_t *err_pos, size_t *err_len);
 
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_couponcode(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_couponposoffer(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_cset39(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_cset64(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_cset82(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_csetnumeric(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_csum(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_csumalpha(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_hasnondigit(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_hh(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_hhmm(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_hyphen(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iban(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_importeridx(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso3166(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso3166999(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso3166alpha2(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso3166list(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso4217(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso5218(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_key(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_latitude(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_longitude(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_mediatype(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_mm(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_mmoptss(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_nonzero(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_nozeroprefix(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_pieceoftotal(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_posinseqslash(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_pcenc(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_ss(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_winding(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_yesno(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_yymmd0(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_yymmdd(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_yymmddhh(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_yyyymmd0(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_yyyymmdd(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_zero(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
+
 GS1_SYNTAX_DICTIONARY_API gs1_linter_t gs1_linter_from_name(const char *name);
+GS1_SYNTAX_DICTIONARY_API const char* gs1_linter_name(gs1_linter_t linter);
+GS1_SYNTAX_DICTIONARY_API gs1_lintn_t gs1_lintn_from_name(const char *name);
+GS1_SYNTAX_DICTIONARY_API const char* gs1_lintn_name(gs1_lintn_t linter);
 
 #ifdef __cplusplus
 }
@@ -35,14 +35,16 @@
 #include <stdio.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
  * Used to ensure that an AI component conforms to the North American Coupon
  * Code (NACC) specification, as carried in AI (8110).
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -180,7 +182,7 @@
  *         contains an optional field 9 whose Don't Multiply Flag is invalid.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_couponcode(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	gs1_lint_err_t ret;
@@ -189,7 +191,6 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 	const char *p, *q;
 	char expiry_date[7] = {0};
 	int expiry_set = 0;
-	char gcp[14] = {0};
 
 	assert(data);
 
@@ -197,14 +198,14 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 	 * Data must consist of all digits.
 	 *
 	 */
-	if ((pos = strspn(data, "0123456789")) != strlen(data)) {
+	if ((pos = gs1_strnspn(data, data_len, "0123456789")) != data_len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_NON_DIGIT_CHARACTER;
 	}
 
 	p = data;
-	q = data + strlen(data);
+	q = data + data_len;
 
 
 	/*
@@ -236,8 +237,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 	 * Validate the GCP with the "key" linter.
 	 *
 	 */
-	strncpy(gcp, p, (size_t)vli);
-	ret = gs1_lint_key(gcp, err_pos, err_len);
+	ret = gs1_lintn_key(p, (size_t)vli, err_pos, err_len);
 
 	assert (ret == GS1_LINTER_OK ||
 		ret == GS1_LINTER_INVALID_GCP_PREFIX ||
@@ -473,11 +473,11 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 		}
 
 		/*
-		 * Validate the GCP with the "key" linter.
+		 * Validate the GCP with the "key" linter, unless VLI "9"
+		 * indicates that the GCP is absent.
 		 *
 		 */
-		strncpy(gcp, p, (size_t)vli);
-		ret = gs1_lint_key(gcp, err_pos, err_len);
+		ret = vli ? gs1_lintn_key(p, (size_t)vli, err_pos, err_len) : GS1_LINTER_OK;
 
 		assert (ret == GS1_LINTER_OK ||
 			ret == GS1_LINTER_INVALID_GCP_PREFIX ||
@@ -593,11 +593,11 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 		}
 
 		/*
-		 * Validate the GCP with the "key" linter.
+		 * Validate the GCP with the "key" linter, unless VLI "9"
+		 * indicates that the GCP is absent.
 		 *
 		 */
-		strncpy(gcp, p, (size_t)vli);
-		ret = gs1_lint_key(gcp, err_pos, err_len);
+		ret = vli ? gs1_lintn_key(p, (size_t)vli, err_pos, err_len) : GS1_LINTER_OK;
 
 		assert (ret == GS1_LINTER_OK ||
 			ret == GS1_LINTER_INVALID_GCP_PREFIX ||
@@ -634,7 +634,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 		}
 
 		memcpy(expiry_date, p, 6);
-		ret = gs1_lint_yymmdd(expiry_date, err_pos, err_len);
+		ret = gs1_lintn_yymmdd(p, 6, err_pos, err_len);
 
 		assert(ret == GS1_LINTER_OK ||
 		       ret == GS1_LINTER_DATE_TOO_SHORT ||
@@ -678,7 +678,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 		}
 
 		memcpy(start_date, p, 6);
-		ret = gs1_lint_yymmdd(start_date, err_pos, err_len);
+		ret = gs1_lintn_yymmdd(p, 6, err_pos, err_len);
 
 		assert(ret == GS1_LINTER_OK ||
 		       ret == GS1_LINTER_DATE_TOO_SHORT ||
@@ -779,8 +779,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 		 * Validate the GCP/GLN with the "key" linter.
 		 *
 		 */
-		strncpy(gcp, p, (size_t)vli);
-		ret = gs1_lint_key(gcp, err_pos, err_len);
+		ret = gs1_lintn_key(p, (size_t)vli, err_pos, err_len);
 
 		assert (ret == GS1_LINTER_OK ||
 			ret == GS1_LINTER_INVALID_GCP_PREFIX ||
@@ -891,6 +890,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const d
 }
 
 
+/**
+ * As gs1_lintn_couponcode(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_couponcode().
+ * @param [out] err_len As for gs1_lintn_couponcode().
+ *
+ * @return As for gs1_lintn_couponcode().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponcode(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_couponcode(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -34,14 +34,16 @@
 #include <stdio.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
  * Used to ensure that an AI component conforms to the modernised North
  * American positive offer file coupon code standard, as carried in AI (8112).
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -68,7 +70,7 @@
  *         following the Serial Number.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponposoffer(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_couponposoffer(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	size_t pos;
@@ -82,14 +84,14 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponposoffer(const char* con
 	 * Data must consist of all digits.
 	 *
 	 */
-	if ((pos = strspn(data, "0123456789")) != strlen(data)) {
+	if ((pos = gs1_strnspn(data, data_len, "0123456789")) != data_len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_NON_DIGIT_CHARACTER;
 	}
 
 	p = data;
-	q = data + strlen(data);
+	q = data + data_len;
 
 
 	/*
@@ -186,6 +188,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponposoffer(const char* con
 }
 
 
+/**
+ * As gs1_lintn_couponposoffer(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_couponposoffer().
+ * @param [out] err_len As for gs1_lintn_couponposoffer().
+ *
+ * @return As for gs1_lintn_couponposoffer().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_couponposoffer(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_couponposoffer(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -32,6 +32,7 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
@@ -40,8 +41,9 @@
  * Note: The length of the component is validated by the framework that calls
  * this function.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -52,16 +54,9 @@
  *         non-CSET 39 character.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset39(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_cset39(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
-	/*
-	 * All characters in "CSET 39", the 39 character alphabet.
-	 *
-	 */
-	static const char* const cset39 =
-		"#-/0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-
 	size_t pos;
 
 	assert(data);
@@ -70,7 +65,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset39(const char* const data,
 	 * Any character outside of CSET 39 is illegal.
 	 *
 	 */
-	if ((pos = strspn(data, cset39)) != strlen(data)) {
+	if ((pos = gs1_cset_span(data, data_len, GS1_CSET_39)) != data_len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_INVALID_CSET39_CHARACTER;
@@ -81,6 +76,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset39(const char* const data,
 }
 
 
+/**
+ * As gs1_lintn_cset39(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_cset39().
+ * @param [out] err_len As for gs1_lintn_cset39().
+ *
+ * @return As for gs1_lintn_cset39().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset39(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_cset39(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -97,6 +110,11 @@ void test_lint_cset39(void)
 	UNIT_TEST_FAIL(gs1_lint_cset39, "AB_C", GS1_LINTER_INVALID_CSET39_CHARACTER, "AB*_*C");
 	UNIT_TEST_FAIL(gs1_lint_cset39, "_ABC", GS1_LINTER_INVALID_CSET39_CHARACTER, "*_*ABC");
 
+	/* Spanning multiple blocks */
+	UNIT_TEST_PASS(gs1_lint_cset39, "#-/0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+	UNIT_TEST_FAIL(gs1_lint_cset39, "ABCDEFGHIJKLMNOPqRSTUVWXYZ", GS1_LINTER_INVALID_CSET39_CHARACTER, "ABCDEFGHIJKLMNOP*q*RSTUVWXYZ");
+	UNIT_TEST_FAIL(gs1_lint_cset39, "0123456789ABCDEFGHIJKLMNOPQRSTU.", GS1_LINTER_INVALID_CSET39_CHARACTER, "0123456789ABCDEFGHIJKLMNOPQRSTU*.*");
+
 }
 
 #endif  /* UNIT_TESTS */
@@ -32,6 +32,7 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
@@ -41,8 +42,9 @@
  * Note: The length of the component is validated by the framework that calls
  * this function.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -53,18 +55,9 @@
  *         non-CSET 64 character.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset64(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_cset64(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
-	/*
-	 * All characters in "CSET 64", the 64 character alphabet.
-	 *
-	 */
-	static const char* const cset64 =
-		"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-		"abcdefghijklmnopqrstuvwxyz"
-		"0123456789-_";
-
 	size_t pads, len, pos;
 
 	assert(data);
@@ -73,7 +66,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset64(const char* const data,
 	 * Count the number of padding characters, which are optional.
 	 *
 	 */
-	for (pads = 0, len = strlen(data);
+	for (pads = 0, len = data_len;
 	     len > 0 && data[len-1] == '=';
 	     pads++, len--);
 
@@ -87,7 +80,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset64(const char* const data,
 	 * In what remains, any character outside of CSET 64 is illegal.
 	 *
 	 */
-	if ((pos = strspn(data, cset64)) < len) {
+	if ((pos = gs1_cset_span(data, len, GS1_CSET_64)) != len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_INVALID_CSET64_CHARACTER;
@@ -98,6 +91,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset64(const char* const data,
 }
 
 
+/**
+ * As gs1_lintn_cset64(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_cset64().
+ * @param [out] err_len As for gs1_lintn_cset64().
+ *
+ * @return As for gs1_lintn_cset64().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset64(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_cset64(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -131,6 +142,12 @@ void test_lint_cset64(void)
 	UNIT_TEST_FAIL(gs1_lint_cset64, "AB C", GS1_LINTER_INVALID_CSET64_CHARACTER, "AB* *C");
 	UNIT_TEST_FAIL(gs1_lint_cset64, " ABC", GS1_LINTER_INVALID_CSET64_CHARACTER, "* *ABC");
 
+	/* Spanning multiple blocks */
+	UNIT_TEST_PASS(gs1_lint_cset64, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_");
+	UNIT_TEST_PASS(gs1_lint_cset64, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmno=");
+	UNIT_TEST_FAIL(gs1_lint_cset64, "ABCDEFGHIJKLMNOP.RSTUVWXYZ", GS1_LINTER_INVALID_CSET64_CHARACTER, "ABCDEFGHIJKLMNOP*.*RSTUVWXYZ");
+	UNIT_TEST_FAIL(gs1_lint_cset64, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcd+==", GS1_LINTER_INVALID_CSET64_CHARACTER, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcd*+*==");
+
 }
 
 #endif  /* UNIT_TESTS */
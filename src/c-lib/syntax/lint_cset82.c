@@ -32,6 +32,7 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
@@ -40,8 +41,9 @@
  * Note: The length of the component is validated by the framework that calls
  * this function.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -52,17 +54,9 @@
  *         non-CSET 82 character.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset82(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_cset82(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
-	/*
-	 * All characters in "CSET 82", the 82 character alphabet.
-	 *
-	 */
-	static const char* const cset82 =
-		"!\"%&'()*+,-./0123456789:;<=>?ABCDEFGHIJKLMNOPQRS"
-		"TUVWXYZ_abcdefghijklmnopqrstuvwxyz";
-
 	size_t pos;
 
 	assert(data);
@@ -71,7 +65,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset82(const char* const data,
 	 * Any character outside of CSET 82 is illegal.
 	 *
 	 */
-	if ((pos = strspn(data, cset82)) != strlen(data)) {
+	if ((pos = gs1_cset_span(data, data_len, GS1_CSET_82)) != data_len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_INVALID_CSET82_CHARACTER;
@@ -82,6 +76,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset82(const char* const data,
 }
 
 
+/**
+ * As gs1_lintn_cset82(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_cset82().
+ * @param [out] err_len As for gs1_lintn_cset82().
+ *
+ * @return As for gs1_lintn_cset82().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_cset82(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_cset82(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -101,6 +113,11 @@ void test_lint_cset82(void)
 	UNIT_TEST_FAIL(gs1_lint_cset82, "AB C", GS1_LINTER_INVALID_CSET82_CHARACTER, "AB* *C");
 	UNIT_TEST_FAIL(gs1_lint_cset82, " ABC", GS1_LINTER_INVALID_CSET82_CHARACTER, "* *ABC");
 
+	/* Spanning multiple blocks */
+	UNIT_TEST_PASS(gs1_lint_cset82, "!\"%&'()*+,-./0123456789:;<=>?ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz");
+	UNIT_TEST_FAIL(gs1_lint_cset82, "ABCDEFGHIJKLMNOP#RSTUVWXYZ", GS1_LINTER_INVALID_CSET82_CHARACTER, "ABCDEFGHIJKLMNOP*#*RSTUVWXYZ");
+	UNIT_TEST_FAIL(gs1_lint_cset82, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklm$", GS1_LINTER_INVALID_CSET82_CHARACTER, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklm*$*");
+
 }
 
 #endif  /* UNIT_TESTS */
@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
@@ -36,8 +37,9 @@
  * Note: The length of the component is validated by the framework that calls
  * this function.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -48,7 +50,7 @@
  *         character.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csetnumeric(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_csetnumeric(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	size_t pos;
@@ -59,7 +61,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csetnumeric(const char* const
 	 * Any character outside the range '0' to '9' is illegal.
 	 *
 	 */
-	if ((pos = strspn(data, "0123456789")) != strlen(data)) {
+	if ((pos = gs1_cset_span(data, data_len, GS1_CSET_NUMERIC)) != data_len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_NON_DIGIT_CHARACTER;
@@ -70,6 +72,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csetnumeric(const char* const
 }
 
 
+/**
+ * As gs1_lintn_csetnumeric(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_csetnumeric().
+ * @param [out] err_len As for gs1_lintn_csetnumeric().
+ *
+ * @return As for gs1_lintn_csetnumeric().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csetnumeric(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_csetnumeric(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -91,6 +111,11 @@ void test_lint_csetnumeric(void)
 	UNIT_TEST_FAIL(gs1_lint_csetnumeric, "a0", GS1_LINTER_NON_DIGIT_CHARACTER, "*a*0");
 	UNIT_TEST_FAIL(gs1_lint_csetnumeric, "0a", GS1_LINTER_NON_DIGIT_CHARACTER, "0*a*");
 
+	/* Spanning multiple blocks */
+	UNIT_TEST_PASS(gs1_lint_csetnumeric, "012345678901234567890123456789012345");
+	UNIT_TEST_FAIL(gs1_lint_csetnumeric, "0123456789012345/789", GS1_LINTER_NON_DIGIT_CHARACTER, "0123456789012345*/*789");
+	UNIT_TEST_FAIL(gs1_lint_csetnumeric, "0123456789012345678901234567890:", GS1_LINTER_NON_DIGIT_CHARACTER, "0123456789012345678901234567890*:*");
+
 }
 
 #endif  /* UNIT_TESTS */
@@ -33,13 +33,15 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
  * Use to ensure that the AI component has a valid numeric check digit.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -52,7 +54,7 @@
  *         character.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csum(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_csum(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	int weight;
@@ -62,13 +64,13 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csum(const char* const data, s
 
 	assert(data);
 
-	len = strlen(data);
+	len = data_len;
 
 	/*
 	 * Data must include at least the check digit.
 	 *
 	 */
-	if (*data == '\0') {
+	if (len == 0) {
 		if (err_pos) *err_pos = 0;
 		if (err_len) *err_len = 0;
 		return GS1_LINTER_TOO_SHORT_FOR_CHECK_DIGIT;
@@ -78,7 +80,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csum(const char* const data, s
 	 * Data must consist of all digits.
 	 *
 	 */
-	if ((pos = strspn(data, "0123456789")) != len) {
+	if ((pos = gs1_strnspn(data, data_len, "0123456789")) != len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_NON_DIGIT_CHARACTER;
@@ -95,7 +97,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csum(const char* const data, s
 	 */
 	weight = len % 2 == 0 ? 3 : 1;
 	p = data;
-	while (*(p+1)) {
+	while (p < data + len - 1) {
 		parity += weight * (*p++ - '0');
 		weight = 4 - weight;
 	}
@@ -112,6 +114,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csum(const char* const data, s
 }
 
 
+/**
+ * As gs1_lintn_csum(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_csum().
+ * @param [out] err_len As for gs1_lintn_csum().
+ *
+ * @return As for gs1_lintn_csum().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csum(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_csum(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
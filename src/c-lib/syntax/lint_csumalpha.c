@@ -35,14 +35,16 @@
 #include <stdio.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
  * Used to ensure that the AI component has a valid alphanumeric check
  * character pair.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -65,7 +67,7 @@
  * may choose to support longer data inputs.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csumalpha(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_csumalpha(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	/*
@@ -89,12 +91,23 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csumalpha(const char* const da
 	};
 
 	/*
-	 * Sequence of all characters in CSET 82, ordered by weight.
+	 * Weight of each character in CSET 82, being its position within the
+	 * character set.
 	 *
 	 */
-	static const char* const cset82 =
-		"!\"%&'()*+,-./0123456789:;<=>?ABCDEFGHIJKLMNOPQRSTUVWXYZ_"
-		"abcdefghijklmnopqrstuvwxyz";
+	static const unsigned char cset82weight[256] = {
+		['!'] =  0, ['"'] =  1, ['%'] =  2, ['&'] =  3, ['\''] =  4, ['('] =  5, [')'] =  6, ['*'] =  7,
+		['+'] =  8, [','] =  9, ['-'] = 10, ['.'] = 11, ['/'] = 12, ['0'] = 13, ['1'] = 14, ['2'] = 15,
+		['3'] = 16, ['4'] = 17, ['5'] = 18, ['6'] = 19, ['7'] = 20, ['8'] = 21, ['9'] = 22, [':'] = 23,
+		[';'] = 24, ['<'] = 25, ['='] = 26, ['>'] = 27, ['?'] = 28, ['A'] = 29, ['B'] = 30, ['C'] = 31,
+		['D'] = 32, ['E'] = 33, ['F'] = 34, ['G'] = 35, ['H'] = 36, ['I'] = 37, ['J'] = 38, ['K'] = 39,
+		['L'] = 40, ['M'] = 41, ['N'] = 42, ['O'] = 43, ['P'] = 44, ['Q'] = 45, ['R'] = 46, ['S'] = 47,
+		['T'] = 48, ['U'] = 49, ['V'] = 50, ['W'] = 51, ['X'] = 52, ['Y'] = 53, ['Z'] = 54, ['_'] = 55,
+		['a'] = 56, ['b'] = 57, ['c'] = 58, ['d'] = 59, ['e'] = 60, ['f'] = 61, ['g'] = 62, ['h'] = 63,
+		['i'] = 64, ['j'] = 65, ['k'] = 66, ['l'] = 67, ['m'] = 68, ['n'] = 69, ['o'] = 70, ['p'] = 71,
+		['q'] = 72, ['r'] = 73, ['s'] = 74, ['t'] = 75, ['u'] = 76, ['v'] = 77, ['w'] = 78, ['x'] = 79,
+		['y'] = 80, ['z'] = 81
+	};
 
 	/*
 	 * Sequence of all characters in CSET 32, ordered by weight.
@@ -108,7 +121,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csumalpha(const char* const da
 
 	assert(data);
 
-	len = strlen(data);
+	len = data_len;
 
 	/*
 	 * Data must include at least the check character pair.
@@ -135,7 +148,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csumalpha(const char* const da
 	 * Ensure that the data characters are in CSET 82
 	 *
 	 */
-	if ((pos = strspn(data, cset82)) < len - 2) {
+	if ((pos = gs1_cset_span(data, len, GS1_CSET_82)) < len - 2) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_INVALID_CSET82_CHARACTER;
@@ -145,7 +158,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csumalpha(const char* const da
 	 * Ensure that the check characters are in CSET 32
 	 *
 	 */
-	if ((pos = strspn(&data[len - 2], cset32)) != 2) {
+	if ((pos = gs1_cset_span(&data[len - 2], 2, GS1_CSET_32)) != 2) {
 		if (err_pos) *err_pos = len - 2 + pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_INVALID_CSET32_CHARACTER;
@@ -168,7 +181,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csumalpha(const char* const da
 	 */
 	p = primes + len - 3;
 	for (i = 0; i < len - 2; i++)
-		sum += (unsigned int)(strchr(cset82, data[i]) - cset82) * *p--;
+		sum += cset82weight[(unsigned char)data[i]] * *p--;
 	sum %= 1021;
 
 	if (data[i] != cset32[sum >> 5] || data[i+1] != cset32[sum & 31]) {
@@ -182,6 +195,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csumalpha(const char* const da
 }
 
 
+/**
+ * As gs1_lintn_csumalpha(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_csumalpha().
+ * @param [out] err_len As for gs1_lintn_csumalpha().
+ *
+ * @return As for gs1_lintn_csumalpha().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_csumalpha(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_csumalpha(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
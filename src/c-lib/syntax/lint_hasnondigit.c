@@ -28,13 +28,15 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
  * Used to validate that an AI component contains a non-digit character.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -44,20 +46,20 @@
  * @return #GS1_LINTER_REQUIRES_NON_DIGIT_CHARACTER if the data does not contain a non-digit character.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hasnondigit(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_hasnondigit(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	size_t len;
 
 	assert(data);
 
-	len = strlen(data);
+	len = data_len;
 
 	/*
 	 * Data must not be all numeric
 	 *
 	 */
-	if (strspn(data, "0123456789") == len) {
+	if (gs1_strnspn(data, data_len, "0123456789") == len) {
 		if (err_pos) *err_pos = 0;
 		if (err_len) *err_len = len;
 		return GS1_LINTER_REQUIRES_NON_DIGIT_CHARACTER;
@@ -68,6 +70,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hasnondigit(const char* const
 }
 
 
+/**
+ * As gs1_lintn_hasnondigit(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_hasnondigit().
+ * @param [out] err_len As for gs1_lintn_hasnondigit().
+ *
+ * @return As for gs1_lintn_hasnondigit().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hasnondigit(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_hasnondigit(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
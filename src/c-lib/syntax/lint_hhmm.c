@@ -35,8 +35,9 @@
 /**
  * Used to ensure that an AI component conforms to HHMM format.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -50,16 +51,15 @@
  * @return #GS1_LINTER_ILLEGAL_MINUTE if the data contains an invalid minute.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hhmm(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_hhmm(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	size_t len;
 	gs1_lint_err_t ret;
-	char buf[3] = { 0 };
 
 	assert(data);
 
-	len = strlen(data);
+	len = data_len;
 
 	/*
 	 * Data must be four characters.
@@ -71,8 +71,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hhmm(const char* const data, s
 		return len < 4 ? GS1_LINTER_HOUR_WITH_MINUTE_TOO_SHORT : GS1_LINTER_HOUR_WITH_MINUTE_TOO_LONG;
 	}
 
-	memcpy(buf, data, 2);
-	ret = gs1_lint_hh(buf, err_pos, err_len);
+	ret = gs1_lintn_hh(data, 2, err_pos, err_len);
 
 	assert(ret == GS1_LINTER_OK ||
 	       ret == GS1_LINTER_NON_DIGIT_CHARACTER ||
@@ -81,8 +80,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hhmm(const char* const data, s
 	if (ret != GS1_LINTER_OK)
 		return ret;
 
-	memcpy(buf, data+2, 2);
-	ret = gs1_lint_mm(buf, err_pos, err_len);
+	ret = gs1_lintn_mm(data+2, 2, err_pos, err_len);
 
 	assert(ret == GS1_LINTER_OK ||
 	       ret == GS1_LINTER_NON_DIGIT_CHARACTER ||
@@ -98,6 +96,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hhmm(const char* const data, s
 }
 
 
+/**
+ * As gs1_lintn_hhmm(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_hhmm().
+ * @param [out] err_len As for gs1_lintn_hhmm().
+ *
+ * @return As for gs1_lintn_hhmm().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hhmm(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_hhmm(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
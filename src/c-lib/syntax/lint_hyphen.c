@@ -27,13 +27,15 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
  * Used to validate that an AI component contains only hyphens.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -43,16 +45,16 @@
  * @return #GS1_LINTER_NOT_HYPHEN if the data contains a non-hyphen character.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hyphen(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_hyphen(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	size_t len;
 
 	assert(data);
 
-	len = strlen(data);
+	len = data_len;
 
-	if (*data == '\0') {
+	if (len == 0) {
 		if (err_pos) *err_pos = 0;
 		if (err_len) *err_len = 0;
 		return GS1_LINTER_NOT_HYPHEN;
@@ -62,7 +64,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hyphen(const char* const data,
 	 * Data must not contain a non-hyphen character
 	 *
 	 */
-	if (strspn(data, "-") != len) {
+	if (gs1_strnspn(data, data_len, "-") != len) {
 		if (err_pos) *err_pos = 0;
 		if (err_len) *err_len = len;
 		return GS1_LINTER_NOT_HYPHEN;
@@ -73,6 +75,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hyphen(const char* const data,
 }
 
 
+/**
+ * As gs1_lintn_hyphen(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_hyphen().
+ * @param [out] err_len As for gs1_lintn_hyphen().
+ *
+ * @return As for gs1_lintn_hyphen().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_hyphen(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_hyphen(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -32,6 +32,7 @@
 #include <stdio.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 #ifndef IBAN_MIN_LENGTH
@@ -43,8 +44,9 @@
  * Used to validate that an AI component conforms to the format required for an
  * IBAN.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -60,10 +62,9 @@
  *         are not a valid ISO 3166 alpha-2 country code.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iban(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iban(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
-	char cc[3] = {0};
 	gs1_lint_err_t ret;
 	size_t len, pos;
 	const char *p;
@@ -73,7 +74,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iban(const char* const data, s
 
 	assert(data);
 
-	len = strlen(data);
+	len = data_len;
 
 	if (len <= IBAN_MIN_LENGTH) {
 		if (err_pos) *err_pos = 0;
@@ -85,7 +86,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iban(const char* const data, s
 	 * Any character outside of the set of valid IBAN characters is illegal.
 	 *
 	 */
-	if ((pos = strspn(data, csetiban)) != len) {
+	if ((pos = gs1_strnspn(data, data_len, csetiban)) != len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_INVALID_IBAN_CHARACTER;
@@ -95,8 +96,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iban(const char* const data, s
 	 *  The first two characters must be an ISO 3166 alpha-2 country code.
 	 *
 	 */
-	strncpy(cc, data, 2);
-	ret = gs1_lint_iso3166alpha2(cc, err_pos, err_len);
+	ret = gs1_lintn_iso3166alpha2(data, 2, err_pos, err_len);
 	assert(ret == GS1_LINTER_OK || ret == GS1_LINTER_NOT_ISO3166_ALPHA2);
 
 	if (ret == GS1_LINTER_NOT_ISO3166_ALPHA2) {
@@ -145,6 +145,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iban(const char* const data, s
 }
 
 
+/**
+ * As gs1_lintn_iban(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_iban().
+ * @param [out] err_len As for gs1_lintn_iban().
+ *
+ * @return As for gs1_lintn_iban().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iban(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_iban(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
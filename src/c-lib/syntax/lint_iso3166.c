@@ -32,6 +32,7 @@
 #include <ctype.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /*
@@ -61,8 +62,9 @@
  *       variable as follows:
  *         - `valid`: Set to 1 if the lookup was successful. Otherwise 0.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -72,7 +74,7 @@
  * @return #GS1_LINTER_NOT_ISO3166 if the data is not a num-3 country code.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso3166(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	/*
@@ -80,7 +82,13 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166(const char* const data
 	 *
 	 */
 #ifdef GS1_LINTER_CUSTOM_ISO3166_LOOKUP
-#define GS1_LINTER_ISO3166_LOOKUP(cc) GS1_LINTER_CUSTOM_ISO3166_LOOKUP(cc)
+#define GS1_LINTER_ISO3166_LOOKUP(cc, len) do {				\
+	char buf[GS1_LINTER_CUSTOM_LOOKUP_BUF_SIZE] = {0};		\
+	if (len < sizeof(buf)) {					\
+		memcpy(buf, cc, len);					\
+		GS1_LINTER_CUSTOM_ISO3166_LOOKUP(buf);			\
+	}								\
+} while (0)
 #else
 
 	/*
@@ -128,8 +136,8 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166(const char* const data
 	};
 
 /// \cond
-#define GS1_LINTER_ISO3166_LOOKUP(cc) do {						\
-	if (strlen(cc) == 3 && isdigit(cc[0]) && isdigit(cc[1]) && isdigit(cc[2])) {	\
+#define GS1_LINTER_ISO3166_LOOKUP(cc, len) do {						\
+	if (len == 3 && isdigit(cc[0]) && isdigit(cc[1]) && isdigit(cc[2])) {	\
 		int v = (cc[0] - '0') * 100 + (cc[1] - '0') * 10 + cc[2] - '0';		\
 		assert(v <= 999);	/* Satisfy analyzer */				\
 		if (iso3166[v/64] & (0x8000000000000000 >> (v%64)))			\
@@ -148,7 +156,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166(const char* const data
 	 * Ensure that the data is in the list.
 	 *
 	 */
-	GS1_LINTER_ISO3166_LOOKUP(data);
+	GS1_LINTER_ISO3166_LOOKUP(data, data_len);
 	if (valid)
 		return GS1_LINTER_OK;
 
@@ -157,12 +165,30 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166(const char* const data
 	 *
 	 */
 	if (err_pos) *err_pos = 0;
-	if (err_len) *err_len = strlen(data);
+	if (err_len) *err_len = data_len;
 	return GS1_LINTER_NOT_ISO3166;
 
 }
 
 
+/**
+ * As gs1_lintn_iso3166(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_iso3166().
+ * @param [out] err_len As for gs1_lintn_iso3166().
+ *
+ * @return As for gs1_lintn_iso3166().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_iso3166(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -36,8 +36,9 @@
  * Used to validate that an AI component is an ISO 3166 "num-3" country code or
  * the string "999".
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -48,7 +49,7 @@
  *         country code or the string "999".
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166999(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso3166999(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	gs1_lint_err_t ret;
@@ -59,14 +60,14 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166999(const char* const d
 	 * The data may contain the string "999".
 	 *
 	 */
-	if (strcmp(data, "999") == 0)
+	if (data_len == 3 && memcmp(data, "999", 3) == 0)
 		return GS1_LINTER_OK;
 
 	/*
 	 * Validate the data with the iso3166 linter.
 	 *
 	 */
-	ret = gs1_lint_iso3166(data, err_pos, err_len);
+	ret = gs1_lintn_iso3166(data, data_len, err_pos, err_len);
 
 	assert(ret == GS1_LINTER_OK || ret == GS1_LINTER_NOT_ISO3166);
 
@@ -75,6 +76,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166999(const char* const d
 }
 
 
+/**
+ * As gs1_lintn_iso3166999(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_iso3166999().
+ * @param [out] err_len As for gs1_lintn_iso3166999().
+ *
+ * @return As for gs1_lintn_iso3166999().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166999(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_iso3166999(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
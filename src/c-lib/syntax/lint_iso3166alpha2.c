@@ -31,6 +31,7 @@
 #include <stdint.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /*
@@ -60,8 +61,9 @@
  *       variable as follows:
  *         - `valid`: Set to 1 if the lookup was successful. Otherwise 0.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -71,7 +73,7 @@
  * @return #GS1_LINTER_NOT_ISO3166_ALPHA2 if the data is not a alpha-2 country code.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166alpha2(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso3166alpha2(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	/*
@@ -79,7 +81,13 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166alpha2(const char* cons
 	 *
 	 */
 #ifdef GS1_LINTER_CUSTOM_ISO3166ALPHA2_LOOKUP
-#define GS1_LINTER_ISO3166ALPHA2_LOOKUP(cc) GS1_LINTER_CUSTOM_ISO3166ALPHA2_LOOKUP(cc)
+#define GS1_LINTER_ISO3166ALPHA2_LOOKUP(cc, len) do {				\
+	char buf[GS1_LINTER_CUSTOM_LOOKUP_BUF_SIZE] = {0};		\
+	if (len < sizeof(buf)) {					\
+		memcpy(buf, cc, len);					\
+		GS1_LINTER_CUSTOM_ISO3166ALPHA2_LOOKUP(buf);			\
+	}								\
+} while (0)
 #else
 
 	/*
@@ -121,8 +129,8 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166alpha2(const char* cons
 	};
 
 /// \cond
-#define GS1_LINTER_ISO3166ALPHA2_LOOKUP(cc) do {						\
-	if (strlen(cc) == 2 && cc[0] >= 'A' && cc[0] <= 'Z' && cc[1] >= 'A' && cc[1] <= 'Z') {	\
+#define GS1_LINTER_ISO3166ALPHA2_LOOKUP(cc, len) do {						\
+	if (len == 2 && cc[0] >= 'A' && cc[0] <= 'Z' && cc[1] >= 'A' && cc[1] <= 'Z') {	\
 		int v = (cc[0] - 'A') * 26 + cc[1] - 'A';					\
 		assert(v <= 676);	/* Satisfy analyzer */					\
 		if (iso3166alpha2[v/64] & (0x8000000000000000 >> (v%64)))			\
@@ -141,7 +149,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166alpha2(const char* cons
 	 * Ensure that the data is in the list.
 	 *
 	 */
-	GS1_LINTER_ISO3166ALPHA2_LOOKUP(data);
+	GS1_LINTER_ISO3166ALPHA2_LOOKUP(data, data_len);
 	if (valid)
 		return GS1_LINTER_OK;
 
@@ -150,12 +158,30 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166alpha2(const char* cons
 	 *
 	 */
 	if (err_pos) *err_pos = 0;
-	if (err_len) *err_len = strlen(data);
+	if (err_len) *err_len = data_len;
 	return GS1_LINTER_NOT_ISO3166_ALPHA2;
 
 }
 
 
+/**
+ * As gs1_lintn_iso3166alpha2(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_iso3166alpha2().
+ * @param [out] err_len As for gs1_lintn_iso3166alpha2().
+ *
+ * @return As for gs1_lintn_iso3166alpha2().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso3166alpha2(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_iso3166alpha2(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -37,8 +37,9 @@
 /**
  * Used to validate that an AI component is the string "0", "1", "2" or "9".
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -48,7 +49,7 @@
  * @return #GS1_LINTER_INVALID_BIOLOGICAL_SEX_CODE if the data is not "0", "1", "2" or "9".
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso5218(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_iso5218(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	assert(data);
@@ -57,10 +58,10 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso5218(const char* const data
 	 * The data must be either "0", "1", "2" or "9".
 	 *
 	 */
-	if (strcmp(data, "0") != 0 && strcmp(data, "1") != 0 &&
-	    strcmp(data, "2") != 0 && strcmp(data, "9") != 0) {
+	if (data_len != 1 ||
+	    (data[0] != '0' && data[0] != '1' && data[0] != '2' && data[0] != '9')) {
 		if (err_pos) *err_pos = 0;
-		if (err_len) *err_len = strlen(data);
+		if (err_len) *err_len = data_len;
 		return GS1_LINTER_INVALID_BIOLOGICAL_SEX_CODE;
 	}
 
@@ -69,6 +70,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso5218(const char* const data
 }
 
 
+/**
+ * As gs1_lintn_iso5218(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_iso5218().
+ * @param [out] err_len As for gs1_lintn_iso5218().
+ *
+ * @return As for gs1_lintn_iso5218().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_iso5218(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_iso5218(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /*
@@ -66,8 +67,9 @@
  *         - `offline`: Set to 1 to indicate that the GCP data source is
  *           offline and the linter must fail.  Otherwise 0.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -92,14 +94,14 @@
  * service outage.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_key(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_key(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	size_t i, len;
 
 	assert(data);
 
-	len = strlen(data);
+	len = data_len;
 
 	/*
 	 * The current minimum GCP length is defined by GCP_MIN_LENGTH.
@@ -131,7 +133,11 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_key(const char* const data, si
 #ifdef GS1_LINTER_CUSTOM_GCP_LOOKUP
 {
 	int valid = 0, offline = 0;
-	GS1_LINTER_CUSTOM_GCP_LOOKUP(data);
+	char buf[GS1_LINTER_CUSTOM_LOOKUP_BUF_SIZE] = {0};
+	if (len < sizeof(buf)) {
+		memcpy(buf, data, len);
+		GS1_LINTER_CUSTOM_GCP_LOOKUP(buf);
+	}
 	if (offline)
 		return GS1_LINTER_GCP_DATASOURCE_OFFLINE;
 	else if (!valid)
@@ -144,6 +150,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_key(const char* const data, si
 }
 
 
+/**
+ * As gs1_lintn_key(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_key().
+ * @param [out] err_len As for gs1_lintn_key().
+ *
+ * @return As for gs1_lintn_key().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_key(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_key(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -33,6 +33,7 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /*
@@ -63,8 +64,9 @@
  *       variable as follows:
  *         - `valid`: Set to 1 if the lookup was successful. Otherwise 0.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -74,7 +76,7 @@
  * @return #GS1_LINTER_INVALID_MEDIA_TYPE if the data is not a num-3 country code.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_mediatype(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_mediatype(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	/*
@@ -82,7 +84,13 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_mediatype(const char* const da
 	 *
 	 */
 #ifdef GS1_LINTER_CUSTOM_MEDIA_TYPE_LOOKUP
-#define GS1_LINTER_MEDIA_TYPE_LOOKUP(cc) GS1_LINTER_CUSTOM_MEDIA_TYPE_LOOKUP(cc)
+#define GS1_LINTER_MEDIA_TYPE_LOOKUP(cc, len) do {				\
+	char buf[GS1_LINTER_CUSTOM_LOOKUP_BUF_SIZE] = {0};		\
+	if (len < sizeof(buf)) {					\
+		memcpy(buf, cc, len);					\
+		GS1_LINTER_CUSTOM_MEDIA_TYPE_LOOKUP(buf);			\
+	}								\
+} while (0)
 #else
 
 	/*
@@ -108,12 +116,12 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_mediatype(const char* const da
 	 *
 	 */
 /// \cond
-#define GS1_LINTER_MEDIA_TYPE_LOOKUP(cc) do {				\
+#define GS1_LINTER_MEDIA_TYPE_LOOKUP(cc, len) do {				\
 	size_t s = 0;							\
-	size_t e = sizeof(mediatypes) / sizeof(mediatypes[0]);		\
+	size_t e = len == 2 ? sizeof(mediatypes) / sizeof(mediatypes[0]) : 0;	\
 	while (s < e) {							\
 		const size_t m = s + (e - s) / 2;			\
-		const int cmp = strcmp(mediatypes[m], cc);		\
+		const int cmp = memcmp(mediatypes[m], cc, 2);		\
 		if (cmp < 0)						\
 			s = m + 1;					\
 		else if (cmp > 0)					\
@@ -136,7 +144,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_mediatype(const char* const da
 	 * Ensure that the data is in the list.
 	 *
 	 */
-	GS1_LINTER_MEDIA_TYPE_LOOKUP(data);
+	GS1_LINTER_MEDIA_TYPE_LOOKUP(data, data_len);
 	if (valid)
 		return GS1_LINTER_OK;
 
@@ -145,12 +153,30 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_mediatype(const char* const da
 	 *
 	 */
 	if (err_pos) *err_pos = 0;
-	if (err_len) *err_len = strlen(data);
+	if (err_len) *err_len = data_len;
 	return GS1_LINTER_INVALID_MEDIA_TYPE;
 
 }
 
 
+/**
+ * As gs1_lintn_mediatype(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_mediatype().
+ * @param [out] err_len As for gs1_lintn_mediatype().
+ *
+ * @return As for gs1_lintn_mediatype().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_mediatype(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_mediatype(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -27,13 +27,15 @@
 #include <string.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
  * Used to validate that a numeric AI component does not start with zero.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -44,7 +46,7 @@
  * @return #GS1_LINTER_NON_DIGIT_CHARACTER if the data contains non-digit characters.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_nozeroprefix(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_nozeroprefix(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	size_t pos;
@@ -55,7 +57,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_nozeroprefix(const char* const
 	 * Data must be all numeric
 	 *
 	 */
-	if ((pos = strspn(data, "0123456789")) != strlen(data)) {
+	if ((pos = gs1_strnspn(data, data_len, "0123456789")) != data_len) {
 		if (err_pos) *err_pos = pos;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_NON_DIGIT_CHARACTER;
@@ -65,7 +67,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_nozeroprefix(const char* const
 	 * Data must not start with a zero
 	 *
 	 */
-	if (*data == '0') {
+	if (data_len > 0 && *data == '0') {
 		if (err_pos) *err_pos = 0;
 		if (err_len) *err_len = 1;
 		return GS1_LINTER_ILLEGAL_ZERO_PREFIX;
@@ -76,6 +78,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_nozeroprefix(const char* const
 }
 
 
+/**
+ * As gs1_lintn_nozeroprefix(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_nozeroprefix().
+ * @param [out] err_len As for gs1_lintn_nozeroprefix().
+ *
+ * @return As for gs1_lintn_nozeroprefix().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_nozeroprefix(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_nozeroprefix(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -32,13 +32,15 @@
 #include <stdio.h>
 
 #include "gs1syntaxdictionary.h"
+#include "gs1syntaxdictionary-utils.h"
 
 
 /**
  * Used to ensure that an AI component conforms with correct percent encoding.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -49,16 +51,15 @@
  *         invalid percent sequence.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_pcenc(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_pcenc(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
 	const char *p, *q;
-	char pct[3] = {0};
 
 	assert(data);
 
 	p = data;
-	q = data + strlen(data);
+	q = data + data_len;
 
 	/*
 	 * Find each instance of "%" in the data and ensure that there are at
@@ -66,7 +67,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_pcenc(const char* const data,
 	 * represent a hex value.
 	 *
 	 */
-	while (p != q && (p = strchr(p, '%')) != NULL) {
+	while (p != q && (p = memchr(p, '%', (size_t)(q - p))) != NULL) {
 
 		if (q - p < 3) {
 			if (err_pos) *err_pos = (size_t)(p - data);
@@ -74,8 +75,7 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_pcenc(const char* const data,
 			return GS1_LINTER_INVALID_PERCENT_SEQUENCE;
 		}
 
-		memcpy(pct, p + 1, 2);
-		if (strspn(pct, "0123456789ABCDEFabcdef") != 2) {
+		if (gs1_strnspn(p + 1, 2, "0123456789ABCDEFabcdef") != 2) {
 			if (err_pos) *err_pos = (size_t)(p - data);
 			if (err_len) *err_len = 3;
 			return GS1_LINTER_INVALID_PERCENT_SEQUENCE;
@@ -90,6 +90,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_pcenc(const char* const data,
 }
 
 
+/**
+ * As gs1_lintn_pcenc(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_pcenc().
+ * @param [out] err_len As for gs1_lintn_pcenc().
+ *
+ * @return As for gs1_lintn_pcenc().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_pcenc(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_pcenc(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
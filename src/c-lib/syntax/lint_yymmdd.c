@@ -27,6 +27,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "gs1syntaxdictionary.h"
 
@@ -34,8 +35,9 @@
 /**
  * Used to ensure that an AI component conforms to the YYMMDD format.
  *
- * @param [in] data Pointer to the null-terminated data to be linted. Must not
- *                  be `NULL`.
+ * @param [in] data Pointer to the data to be linted, which need not be
+ *                  null-terminated. Must not be `NULL`.
+ * @param [in] data_len Length of the data to be linted.
  * @param [out] err_pos To facilitate error highlighting, the start position of
  *                      the bad data is written to this pointer, if not `NULL`.
  * @param [out] err_len The length of the bad data is written to this pointer, if
@@ -49,10 +51,10 @@
  * @return #GS1_LINTER_ILLEGAL_DAY if the data contains an invalid day of the month.
  *
  */
-GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_yymmdd(const char* const data, size_t* const err_pos, size_t* const err_len)
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lintn_yymmdd(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
 {
 
-	const gs1_lint_err_t ret = gs1_lint_yymmd0(data, err_pos, err_len);
+	const gs1_lint_err_t ret = gs1_lintn_yymmd0(data, data_len, err_pos, err_len);
 
 	assert(ret == GS1_LINTER_OK ||
 	       ret == GS1_LINTER_DATE_TOO_SHORT ||
@@ -75,6 +77,24 @@ GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_yymmdd(const char* const data,
 }
 
 
+/**
+ * As gs1_lintn_yymmdd(), for null-terminated data.
+ *
+ * @param [in] data Pointer to the null-terminated data to be linted. Must not
+ *                  be `NULL`.
+ * @param [out] err_pos As for gs1_lintn_yymmdd().
+ * @param [out] err_len As for gs1_lintn_yymmdd().
+ *
+ * @return As for gs1_lintn_yymmdd().
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API gs1_lint_err_t gs1_lint_yymmdd(const char* const data, size_t* const err_pos, size_t* const err_len)
+{
+	assert(data);
+	return gs1_lintn_yymmdd(data, strlen(data), err_pos, err_len);
+}
+
+
 #ifdef UNIT_TESTS
 
 #include "unittest.h"
@@ -29,6 +29,30 @@
 #include "gs1syntaxdictionary.h"
 
 
+/**
+ * Not used.
+ *
+ * @deprecated Function retained for API compatibility purposes only. Not
+ * longer referenced by the Syntax Dictionary.
+ *
+ * @param [in] data Not used.
+ * @param [in] data_len Not used.
+ * @param [out] err_pos Not used.
+ * @param [out] err_len Not used.
+ *
+ * @return #GS1_LINTER_OK
+ *
+ */
+GS1_SYNTAX_DICTIONARY_API DEPRECATED gs1_lint_err_t gs1_lintn_yymmddhh(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len)
+{
+	(void)data;
+	(void)data_len;
+	(void)err_pos;
+	(void)err_len;
+	return GS1_LINTER_OK;
+}
+
+
 /**
  * Not used.
  *
@@ -32,8 +32,10 @@
 
 static void DO_UNIT_TEST(int should_succeed, gs1_lint_err_t (*fn)(const char *, size_t *, size_t *), const char *data, gs1_lint_err_t expect_err, const char *expect_highlight, const char *file, int line) {
 
-	gs1_lint_err_t err;
-	size_t err_pos[1], err_len[1];
+	gs1_lint_err_t err, errn;
+	gs1_lintn_t fnn;
+	size_t err_pos[1], err_len[1], errn_pos[1], errn_len[1];
+	char unterminated[512];
 	char highlight[100] = {0};
 	char casestr[512] = {0};
 
@@ -44,6 +46,24 @@ static void DO_UNIT_TEST(int should_succeed, gs1_lint_err_t (*fn)(const char *,
 	err = (fn)(data, err_pos, err_len);
 	TEST_ASSERT(err < __GS1_LINTER_NUM_ERRS);
 
+	/*
+	 *  The length-aware variant must produce the same result when the data
+	 *  is not terminated, so follow it with garbage
+	 *
+	 */
+	fnn = gs1_lintn_from_name(gs1_linter_name(fn));
+	TEST_ASSERT(fnn != NULL);
+	TEST_ASSERT(strlen(data) + 4 <= sizeof(unterminated));
+	memcpy(unterminated, data, strlen(data));
+	memcpy(&unterminated[strlen(data)], "9A%=", 4);
+	errn = (fnn)(unterminated, strlen(data), errn_pos, errn_len);
+	TEST_CHECK(errn == err);
+	TEST_MSG("Length-aware linter got: %s; Expected: %s", gs1_lint_err_str[errn], gs1_lint_err_str[err]);
+	if (err != GS1_LINTER_OK && errn == err) {
+		TEST_CHECK(*errn_pos == *err_pos && *errn_len == *err_len);
+		TEST_MSG("Length-aware linter highlight differs");
+	}
+
 	if (should_succeed) {
 		TEST_CHECK(err == GS1_LINTER_OK);
 		TEST_MSG("Expected success, but failed with error: %s", gs1_lint_err_str[err]);